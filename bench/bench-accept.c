@@ -0,0 +1,135 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "xcomm.h"
+#include "xcomm-utils.h"
+#include "platform/platform-info.h"
+#include "platform/platform-socket.h"
+
+/**
+ * usage: bench-accept [plain|sharded] [seconds] [clients] [workers]
+ *
+ * clients connect and reset in a tight loop, the rate reported is the
+ * number of connections accepted per second by the engine.
+ */
+
+#define BENCH_HOST "127.0.0.1"
+#define BENCH_PORT "19090"
+
+static atomic_bool    running = true;
+static atomic_bool    ready   = false;
+static atomic_ullong  accepted;
+static atomic_ullong  dialed;
+
+static void _bench_accept_cb(
+    xcomm_tcp_connection_t* conn, int err, const char* msg, void* userdata) {
+    (void)err;
+    (void)msg;
+    (void)userdata;
+
+    atomic_fetch_add(&accepted, 1);
+    xcomm_async_tcp.close_connection(conn);
+}
+
+static void _bench_listen_cb(
+    xcomm_tcp_listener_t* listener, int err, const char* msg, void* userdata) {
+    (void)userdata;
+
+    if (!listener) {
+        fprintf(stderr, "listen failed: %d %s\n", err, msg);
+        return;
+    }
+    xcomm_async_tcp.set_accept_cb(listener, _bench_accept_cb, NULL);
+    atomic_store(&ready, true);
+}
+
+static int _bench_client(void* param) {
+    (void)param;
+    struct linger lg = {.l_onoff = 1, .l_linger = 0};
+
+    while (atomic_load(&running)) {
+        bool            noused;
+        platform_sock_t sock = platform_socket_dial(
+            BENCH_HOST, BENCH_PORT, SOCK_STREAM, &noused, false);
+
+        if (sock == PLATFORM_SO_ERROR_INVALID_SOCKET) {
+            continue;
+        }
+        /** reset instead of fin so the client never runs out of ports. */
+        setsockopt(sock, SOL_SOCKET, SO_LINGER, (const void*)&lg, sizeof(lg));
+        platform_socket_close(sock);
+        atomic_fetch_add(&dialed, 1);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    bool sharded = argc > 1 && !strcmp(argv[1], "sharded");
+    int  seconds = argc > 2 ? atoi(argv[2]) : 5;
+    int  clients = argc > 3 ? atoi(argv[3]) : platform_info_getcpus();
+    int  workers = argc > 4 ? atoi(argv[4]) : platform_info_getcpus();
+
+    xcomm_startup(workers, NULL);
+
+    if (sharded) {
+        xcomm_async_tcp.listen_sharded(BENCH_HOST, BENCH_PORT, _bench_listen_cb, NULL);
+    } else {
+        xcomm_async_tcp.listen(BENCH_HOST, BENCH_PORT, _bench_listen_cb, NULL);
+    }
+    while (!atomic_load(&ready)) {
+        thrd_sleep(&(struct timespec){.tv_nsec = 1000000}, NULL);
+    }
+    thrd_t* tids = malloc(sizeof(thrd_t) * clients);
+    if (!tids) {
+        return -1;
+    }
+    for (int i = 0; i < clients; i++) {
+        thrd_create(&tids[i], _bench_client, NULL);
+    }
+    uint64_t start = xcomm_utils_getnow(XCOMM_TIME_PRECISION_MSEC);
+    thrd_sleep(&(struct timespec){.tv_sec = seconds}, NULL);
+    atomic_store(&running, false);
+    uint64_t elapsed = xcomm_utils_getnow(XCOMM_TIME_PRECISION_MSEC) - start;
+
+    for (int i = 0; i < clients; i++) {
+        thrd_join(tids[i], NULL);
+    }
+    free(tids);
+
+    printf(
+        "{\"bench\":\"accept\",\"mode\":\"%s\",\"workers\":%d,"
+        "\"clients\":%d,\"seconds\":%.3f,\"dialed\":%llu,\"accepted\":%llu,"
+        "\"accepts_per_sec\":%.0f}\n",
+        sharded ? "sharded" : "plain",
+        workers,
+        clients,
+        elapsed / 1000.0,
+        (unsigned long long)atomic_load(&dialed),
+        (unsigned long long)atomic_load(&accepted),
+        atomic_load(&accepted) * 1000.0 / elapsed);
+
+    xcomm_cleanup();
+    return 0;
+}
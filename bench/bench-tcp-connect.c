@@ -0,0 +1,189 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "bench-tcp.h"
+#include "xcomm-utils.h"
+#include "platform/platform-info.h"
+
+/**
+ * usage: bench-tcp-connect [sync|async] [seconds] [concurrency] [workers]
+ *
+ * each slot dials, waits for the server to close and dials again. the
+ * server closes first so time-wait stays on its side and the client never
+ * runs out of ports. latency is the time to an established connection.
+ */
+
+#define BENCH_SAMPLES 4096
+
+typedef struct bench_slot_s bench_slot_t;
+
+struct bench_slot_s {
+    uint64_t  start;
+    size_t    nsamples;
+    uint64_t* samples;
+};
+
+static atomic_bool   running = true;
+static atomic_int    done;
+static atomic_ullong completed;
+static atomic_ullong errors;
+
+static void _bench_sample(bench_slot_t* slot) {
+    if (slot->nsamples < BENCH_SAMPLES) {
+        slot->samples[slot->nsamples++] =
+            xcomm_utils_getnow(XCOMM_TIME_PRECISION_NSEC) - slot->start;
+    }
+}
+
+static int _bench_sync_client(void* param) {
+    bench_slot_t* slot = param;
+    char          byte;
+
+    while (atomic_load(&running)) {
+        slot->start = xcomm_utils_getnow(XCOMM_TIME_PRECISION_NSEC);
+
+        xcomm_tcp_connection_t* conn = xcomm_sync_tcp.dial(
+            BENCH_TCP_HOST, BENCH_TCP_PORT, 3000);
+        if (!conn) {
+            atomic_fetch_add(&errors, 1);
+            continue;
+        }
+        _bench_sample(slot);
+
+        xcomm_sync_tcp.recv(conn, &byte, 1);
+        xcomm_sync_tcp.close_connection(conn);
+        atomic_fetch_add(&completed, 1);
+    }
+    return 0;
+}
+
+static void _bench_async_connect_cb(
+    xcomm_tcp_connection_t* conn, int err, const char* msg, void* userdata);
+
+static void _bench_async_dial(bench_slot_t* slot) {
+    if (!atomic_load(&running)) {
+        atomic_fetch_add(&done, 1);
+        return;
+    }
+    slot->start = xcomm_utils_getnow(XCOMM_TIME_PRECISION_NSEC);
+    xcomm_async_tcp.dial(
+        BENCH_TCP_HOST, BENCH_TCP_PORT, 3000, _bench_async_connect_cb, slot);
+}
+
+static void _bench_async_close_cb(xcomm_tcp_connection_t* conn, void* userdata) {
+    (void)conn;
+
+    atomic_fetch_add(&completed, 1);
+    _bench_async_dial(userdata);
+}
+
+static void _bench_async_connect_cb(
+    xcomm_tcp_connection_t* conn, int err, const char* msg, void* userdata) {
+    (void)err;
+    (void)msg;
+    bench_slot_t* slot = userdata;
+
+    if (!conn) {
+        atomic_fetch_add(&errors, 1);
+        _bench_async_dial(slot);
+        return;
+    }
+    _bench_sample(slot);
+    xcomm_async_tcp.set_connection_close_cb(conn, _bench_async_close_cb, slot);
+}
+
+int main(int argc, char** argv) {
+    bool sync        = argc > 1 && !strcmp(argv[1], "sync");
+    int  seconds     = argc > 2 ? atoi(argv[2]) : 5;
+    int  concurrency = argc > 3 ? atoi(argv[3]) : platform_info_getcpus();
+    int  workers     = argc > 4 ? atoi(argv[4]) : platform_info_getcpus();
+
+    if (seconds <= 0 || concurrency <= 0) {
+        fprintf(stderr, "invalid arguments.\n");
+        return -1;
+    }
+    bench_tcp_raise_nofile(concurrency * 2 + 64);
+    xcomm_startup(workers, NULL);
+    bench_tcp_server_start(BENCH_TCP_SERVER_CLOSE, NULL);
+
+    bench_slot_t* slots   = calloc(concurrency, sizeof(bench_slot_t));
+    uint64_t*     samples = calloc((size_t)concurrency * BENCH_SAMPLES, sizeof(uint64_t));
+    thrd_t*       tids    = calloc(concurrency, sizeof(thrd_t));
+    if (!slots || !samples || !tids) {
+        return -1;
+    }
+    for (int i = 0; i < concurrency; i++) {
+        slots[i].samples = samples + (size_t)i * BENCH_SAMPLES;
+    }
+    uint64_t start = xcomm_utils_getnow(XCOMM_TIME_PRECISION_MSEC);
+
+    for (int i = 0; i < concurrency; i++) {
+        if (sync) {
+            thrd_create(&tids[i], _bench_sync_client, &slots[i]);
+        } else {
+            _bench_async_dial(&slots[i]);
+        }
+    }
+    bench_tcp_sleep(seconds * 1000);
+    atomic_store(&running, false);
+    uint64_t elapsed = xcomm_utils_getnow(XCOMM_TIME_PRECISION_MSEC) - start;
+    uint64_t count   = atomic_load(&completed);
+
+    if (sync) {
+        for (int i = 0; i < concurrency; i++) {
+            thrd_join(tids[i], NULL);
+        }
+    } else {
+        while (atomic_load(&done) < concurrency) {
+            bench_tcp_sleep(1);
+        }
+    }
+    size_t n = 0;
+    for (int i = 0; i < concurrency; i++) {
+        memmove(samples + n, slots[i].samples, slots[i].nsamples * sizeof(uint64_t));
+        n += slots[i].nsamples;
+    }
+    printf(
+        "{\"bench\":\"connect\",\"module\":\"%s\",\"workers\":%d,"
+        "\"concurrency\":%d,\"seconds\":%.3f,\"connections\":%llu,"
+        "\"errors\":%llu,\"conns_per_sec\":%.0f,",
+        sync ? "sync" : "async",
+        workers,
+        concurrency,
+        elapsed / 1000.0,
+        (unsigned long long)count,
+        (unsigned long long)atomic_load(&errors),
+        count * 1000.0 / elapsed);
+    bench_tcp_print_latency(samples, n);
+    printf("}\n");
+
+    free(tids);
+    free(samples);
+    free(slots);
+
+    xcomm_cleanup();
+    return 0;
+}
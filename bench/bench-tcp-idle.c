@@ -0,0 +1,153 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "bench-tcp.h"
+#include "xcomm-utils.h"
+#include "platform/platform-info.h"
+
+/**
+ * usage: bench-tcp-idle [sync|async] [conns] [plain|framed] [workers]
+ *
+ * opens conns connections that never send and reports how much resident
+ * memory they added. both ends live in this process, so the figure is per
+ * pair: a client of the chosen module plus an async server connection,
+ * framed ones with a length field packetizer.
+ */
+
+#define BENCH_WINDOW 256
+
+static xcomm_tcp_connection_t** handles;
+static int                      conns;
+static atomic_int               next;
+static atomic_int               connected;
+static atomic_int               errors;
+
+static void _bench_async_connect_cb(
+    xcomm_tcp_connection_t* conn, int err, const char* msg, void* userdata);
+
+/** keeps at most BENCH_WINDOW dials in flight. */
+static void _bench_async_dial(void) {
+    int idx = atomic_fetch_add(&next, 1);
+
+    if (idx < conns) {
+        xcomm_async_tcp.dial(
+            BENCH_TCP_HOST,
+            BENCH_TCP_PORT,
+            10000,
+            _bench_async_connect_cb,
+            (void*)(intptr_t)idx);
+    }
+}
+
+static void _bench_async_connect_cb(
+    xcomm_tcp_connection_t* conn, int err, const char* msg, void* userdata) {
+    (void)err;
+    (void)msg;
+
+    if (!conn) {
+        atomic_fetch_add(&errors, 1);
+    }
+    handles[(intptr_t)userdata] = conn;
+    atomic_fetch_add(&connected, 1);
+    _bench_async_dial();
+}
+
+int main(int argc, char** argv) {
+    bool sync    = argc > 1 && !strcmp(argv[1], "sync");
+    bool framed  = argc > 3 && !strcmp(argv[3], "framed");
+    int  workers = argc > 4 ? atoi(argv[4]) : platform_info_getcpus();
+
+    conns = argc > 2 ? atoi(argv[2]) : 10000;
+    if (conns <= 0) {
+        fprintf(stderr, "invalid arguments.\n");
+        return -1;
+    }
+    xcomm_tcp_packetizer_t packetizer = {
+        .type        = XCOMM_TCP_PACKETIZER_TYPE_LENGTHFIELD,
+        .lengthfield = {.offset = 0, .size = 2},
+    };
+    bench_tcp_raise_nofile(conns * 2 + 64);
+    xcomm_startup(workers, NULL);
+    bench_tcp_server_start(BENCH_TCP_SERVER_HOLD, framed ? &packetizer : NULL);
+
+    handles = calloc(conns, sizeof(xcomm_tcp_connection_t*));
+    if (!handles) {
+        return -1;
+    }
+    bench_tcp_sleep(200);
+    size_t before = bench_tcp_rss();
+
+    if (sync) {
+        for (int i = 0; i < conns; i++) {
+            handles[i] = xcomm_sync_tcp.dial(BENCH_TCP_HOST, BENCH_TCP_PORT, 10000);
+            if (!handles[i]) {
+                atomic_fetch_add(&errors, 1);
+            }
+        }
+    } else {
+        for (int i = 0; i < BENCH_WINDOW; i++) {
+            _bench_async_dial();
+        }
+        while (atomic_load(&connected) < conns) {
+            bench_tcp_sleep(1);
+        }
+    }
+    int opened = conns - atomic_load(&errors);
+    while (bench_tcp_server_accepted() < (uint64_t)opened) {
+        bench_tcp_sleep(1);
+    }
+    /** let the loops settle, accepted connections finish setting up. */
+    bench_tcp_sleep(500);
+    size_t after = bench_tcp_rss();
+
+    printf(
+        "{\"bench\":\"idle\",\"module\":\"%s\",\"workers\":%d,\"conns\":%d,"
+        "\"framed\":%s,\"errors\":%d,\"rss_before\":%zu,\"rss_after\":%zu,"
+        "\"bytes_per_pair\":%.0f}\n",
+        sync ? "sync" : "async",
+        workers,
+        opened,
+        framed ? "true" : "false",
+        atomic_load(&errors),
+        before,
+        after,
+        opened ? ((double)after - (double)before) / opened : 0.0);
+
+    for (int i = 0; i < conns; i++) {
+        if (!handles[i]) {
+            continue;
+        }
+        if (sync) {
+            xcomm_sync_tcp.close_connection(handles[i]);
+        } else {
+            xcomm_async_tcp.close_connection(handles[i]);
+        }
+    }
+    free(handles);
+
+    xcomm_cleanup();
+    return 0;
+}
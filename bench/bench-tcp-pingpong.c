@@ -0,0 +1,207 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "bench-tcp.h"
+#include "xcomm-utils.h"
+#include "platform/platform-info.h"
+
+/**
+ * usage: bench-tcp-pingpong [sync|async] [size] [rounds] [conns] [workers]
+ *
+ * every connection keeps one message of size bytes in flight against an
+ * echo server and times each round trip.
+ */
+
+typedef struct bench_client_s bench_client_t;
+
+struct bench_client_s {
+    char*     buf;
+    size_t    got;
+    int       round;
+    uint64_t  start;
+    uint64_t* samples;
+};
+
+static size_t      size;
+static int         rounds;
+static atomic_int  done;
+static atomic_int  errors;
+
+static int _bench_sync_client(void* param) {
+    bench_client_t*         client = param;
+    xcomm_tcp_connection_t* conn   = xcomm_sync_tcp.dial(
+        BENCH_TCP_HOST, BENCH_TCP_PORT, 3000);
+
+    if (!conn) {
+        atomic_fetch_add(&errors, 1);
+        return 0;
+    }
+    for (; client->round < rounds; client->round++) {
+        uint64_t start = xcomm_utils_getnow(XCOMM_TIME_PRECISION_NSEC);
+
+        if (xcomm_sync_tcp.send(conn, client->buf, size) != (int64_t)size ||
+            xcomm_sync_tcp.recv(conn, client->buf, size) != (int64_t)size) {
+            atomic_fetch_add(&errors, 1);
+            break;
+        }
+        client->samples[client->round] =
+            xcomm_utils_getnow(XCOMM_TIME_PRECISION_NSEC) - start;
+    }
+    xcomm_sync_tcp.close_connection(conn);
+    return 0;
+}
+
+static void _bench_async_send(xcomm_tcp_connection_t* conn, bench_client_t* client) {
+    client->got   = 0;
+    client->start = xcomm_utils_getnow(XCOMM_TIME_PRECISION_NSEC);
+    xcomm_async_tcp.send(conn, client->buf, size);
+}
+
+static void _bench_async_recv_cb(
+    xcomm_tcp_connection_t* conn, void* buf, size_t len, void* userdata) {
+    (void)buf;
+    bench_client_t* client = userdata;
+
+    client->got += len;
+    if (client->got < size) {
+        return;
+    }
+    client->samples[client->round++] =
+        xcomm_utils_getnow(XCOMM_TIME_PRECISION_NSEC) - client->start;
+
+    if (client->round == rounds) {
+        xcomm_async_tcp.close_connection(conn);
+        return;
+    }
+    _bench_async_send(conn, client);
+}
+
+static void _bench_async_close_cb(xcomm_tcp_connection_t* conn, void* userdata) {
+    (void)conn;
+    bench_client_t* client = userdata;
+
+    if (client->round < rounds) {
+        atomic_fetch_add(&errors, 1);
+    }
+    atomic_fetch_add(&done, 1);
+}
+
+static void _bench_async_connect_cb(
+    xcomm_tcp_connection_t* conn, int err, const char* msg, void* userdata) {
+    (void)err;
+    (void)msg;
+    bench_client_t* client = userdata;
+
+    if (!conn) {
+        atomic_fetch_add(&errors, 1);
+        atomic_fetch_add(&done, 1);
+        return;
+    }
+    xcomm_async_tcp.set_recv_cb(conn, _bench_async_recv_cb, client);
+    xcomm_async_tcp.set_connection_close_cb(conn, _bench_async_close_cb, client);
+    _bench_async_send(conn, client);
+}
+
+int main(int argc, char** argv) {
+    bool sync    = argc > 1 && !strcmp(argv[1], "sync");
+    int  conns   = argc > 4 ? atoi(argv[4]) : 1;
+    int  workers = argc > 5 ? atoi(argv[5]) : platform_info_getcpus();
+
+    size   = argc > 2 ? (size_t)atoi(argv[2]) : 64;
+    rounds = argc > 3 ? atoi(argv[3]) : 100000;
+
+    if (!size || rounds <= 0 || conns <= 0) {
+        fprintf(stderr, "invalid arguments.\n");
+        return -1;
+    }
+    xcomm_startup(workers, NULL);
+    bench_tcp_server_start(BENCH_TCP_SERVER_ECHO, NULL);
+
+    bench_client_t* clients = calloc(conns, sizeof(bench_client_t));
+    uint64_t*       samples = calloc((size_t)conns * rounds, sizeof(uint64_t));
+    thrd_t*         tids    = calloc(conns, sizeof(thrd_t));
+    if (!clients || !samples || !tids) {
+        return -1;
+    }
+    for (int i = 0; i < conns; i++) {
+        clients[i].buf = malloc(size);
+        if (!clients[i].buf) {
+            return -1;
+        }
+        memset(clients[i].buf, 'x', size);
+        clients[i].samples = samples + (size_t)i * rounds;
+    }
+    uint64_t start = xcomm_utils_getnow(XCOMM_TIME_PRECISION_MSEC);
+
+    if (sync) {
+        for (int i = 0; i < conns; i++) {
+            thrd_create(&tids[i], _bench_sync_client, &clients[i]);
+        }
+        for (int i = 0; i < conns; i++) {
+            thrd_join(tids[i], NULL);
+        }
+    } else {
+        for (int i = 0; i < conns; i++) {
+            xcomm_async_tcp.dial(
+                BENCH_TCP_HOST, BENCH_TCP_PORT, 3000, _bench_async_connect_cb, &clients[i]);
+        }
+        while (atomic_load(&done) < conns) {
+            bench_tcp_sleep(1);
+        }
+    }
+    uint64_t elapsed = xcomm_utils_getnow(XCOMM_TIME_PRECISION_MSEC) - start;
+
+    /** samples of a client that broke off are packed behind the others. */
+    size_t n = 0;
+    for (int i = 0; i < conns; i++) {
+        memmove(samples + n, clients[i].samples, clients[i].round * sizeof(uint64_t));
+        n += clients[i].round;
+    }
+    printf(
+        "{\"bench\":\"pingpong\",\"module\":\"%s\",\"workers\":%d,\"conns\":%d,"
+        "\"size\":%zu,\"rounds\":%d,\"errors\":%d,\"seconds\":%.3f,"
+        "\"rtt_per_sec\":%.0f,",
+        sync ? "sync" : "async",
+        workers,
+        conns,
+        size,
+        rounds,
+        atomic_load(&errors),
+        elapsed / 1000.0,
+        elapsed ? n * 1000.0 / elapsed : 0.0);
+    bench_tcp_print_latency(samples, n);
+    printf("}\n");
+
+    for (int i = 0; i < conns; i++) {
+        free(clients[i].buf);
+    }
+    free(tids);
+    free(samples);
+    free(clients);
+
+    xcomm_cleanup();
+    return 0;
+}
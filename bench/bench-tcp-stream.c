@@ -0,0 +1,202 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "bench-tcp.h"
+#include "xcomm-utils.h"
+#include "platform/platform-info.h"
+
+/**
+ * usage: bench-tcp-stream [sync|async] [seconds] [conns] [workers] [size...]
+ *
+ * every connection writes messages of one size as fast as the server takes
+ * them, throughput is what the server received during the window. each
+ * size runs on fresh connections.
+ */
+
+static char*       payload;
+static size_t      size;
+static atomic_bool running;
+static atomic_int  connected;
+static atomic_int  done;
+static atomic_int  errors;
+
+static int _bench_sync_client(void* param) {
+    (void)param;
+    xcomm_tcp_connection_t* conn = xcomm_sync_tcp.dial(
+        BENCH_TCP_HOST, BENCH_TCP_PORT, 3000);
+
+    if (!conn) {
+        atomic_fetch_add(&errors, 1);
+        atomic_fetch_add(&connected, 1);
+        return 0;
+    }
+    atomic_fetch_add(&connected, 1);
+
+    while (atomic_load(&running)) {
+        if (xcomm_sync_tcp.send(conn, payload, size) != (int64_t)size) {
+            atomic_fetch_add(&errors, 1);
+            break;
+        }
+    }
+    xcomm_sync_tcp.close_connection(conn);
+    return 0;
+}
+
+/** keeps the send queue at the high watermark until the window closes. */
+static void _bench_async_pump(xcomm_tcp_connection_t* conn, void* userdata) {
+    (void)userdata;
+
+    while (atomic_load(&running)) {
+        int rc = xcomm_async_tcp.send(conn, payload, size);
+        if (rc < 0) {
+            atomic_fetch_add(&errors, 1);
+            break;
+        }
+        if (rc > 0) {
+            return;
+        }
+    }
+    xcomm_async_tcp.close_connection(conn);
+}
+
+static void _bench_async_close_cb(xcomm_tcp_connection_t* conn, void* userdata) {
+    (void)conn;
+    (void)userdata;
+
+    atomic_fetch_add(&done, 1);
+}
+
+static void _bench_async_connect_cb(
+    xcomm_tcp_connection_t* conn, int err, const char* msg, void* userdata) {
+    (void)err;
+    (void)msg;
+    (void)userdata;
+
+    atomic_fetch_add(&connected, 1);
+    if (!conn) {
+        atomic_fetch_add(&errors, 1);
+        atomic_fetch_add(&done, 1);
+        return;
+    }
+    xcomm_async_tcp.set_writable_cb(conn, _bench_async_pump, NULL);
+    xcomm_async_tcp.set_connection_close_cb(conn, _bench_async_close_cb, NULL);
+    _bench_async_pump(conn, NULL);
+}
+
+static void _bench_run(bool sync, int seconds, int conns, thrd_t* tids) {
+    atomic_store(&running, true);
+    atomic_store(&connected, 0);
+    atomic_store(&done, 0);
+
+    for (int i = 0; i < conns; i++) {
+        if (sync) {
+            thrd_create(&tids[i], _bench_sync_client, NULL);
+        } else {
+            xcomm_async_tcp.dial(
+                BENCH_TCP_HOST, BENCH_TCP_PORT, 3000, _bench_async_connect_cb, NULL);
+        }
+    }
+    while (atomic_load(&connected) < conns) {
+        bench_tcp_sleep(1);
+    }
+    uint64_t bytes = bench_tcp_server_bytes();
+    uint64_t start = xcomm_utils_getnow(XCOMM_TIME_PRECISION_USEC);
+
+    bench_tcp_sleep(seconds * 1000);
+
+    bytes = bench_tcp_server_bytes() - bytes;
+    uint64_t elapsed = xcomm_utils_getnow(XCOMM_TIME_PRECISION_USEC) - start;
+
+    atomic_store(&running, false);
+    if (sync) {
+        for (int i = 0; i < conns; i++) {
+            thrd_join(tids[i], NULL);
+        }
+    } else {
+        while (atomic_load(&done) < conns) {
+            bench_tcp_sleep(1);
+        }
+    }
+    printf(
+        "{\"size\":%zu,\"bytes\":%llu,\"mbytes_per_sec\":%.1f,"
+        "\"msgs_per_sec\":%.0f}",
+        size,
+        (unsigned long long)bytes,
+        bytes / (double)elapsed,
+        (double)bytes / size * 1000000.0 / elapsed);
+}
+
+int main(int argc, char** argv) {
+    static const size_t sizes[] = {64, 512, 4096, 16384, 65536};
+
+    bool sync    = argc > 1 && !strcmp(argv[1], "sync");
+    int  seconds = argc > 2 ? atoi(argv[2]) : 3;
+    int  conns   = argc > 3 ? atoi(argv[3]) : 1;
+    int  workers = argc > 4 ? atoi(argv[4]) : platform_info_getcpus();
+    int  nsizes  = argc > 5 ? argc - 5 : (int)(sizeof(sizes) / sizeof(sizes[0]));
+
+    if (seconds <= 0 || conns <= 0) {
+        fprintf(stderr, "invalid arguments.\n");
+        return -1;
+    }
+    xcomm_startup(workers, NULL);
+    bench_tcp_server_start(BENCH_TCP_SERVER_DISCARD, NULL);
+
+    thrd_t* tids = calloc(conns, sizeof(thrd_t));
+    if (!tids) {
+        return -1;
+    }
+    printf(
+        "{\"bench\":\"stream\",\"module\":\"%s\",\"workers\":%d,\"conns\":%d,"
+        "\"seconds\":%d,\"results\":[",
+        sync ? "sync" : "async",
+        workers,
+        conns,
+        seconds);
+
+    for (int i = 0; i < nsizes; i++) {
+        size    = argc > 5 ? (size_t)atoi(argv[5 + i]) : sizes[i];
+        payload = malloc(size ? size : 1);
+        if (!size || !payload) {
+            fprintf(stderr, "invalid size.\n");
+            return -1;
+        }
+        memset(payload, 'x', size);
+
+        if (i) {
+            printf(",");
+        }
+        _bench_run(sync, seconds, conns, tids);
+
+        /** async sends are only done with the buffer once closed. */
+        free(payload);
+    }
+    printf("],\"errors\":%d}\n", atomic_load(&errors));
+
+    free(tids);
+    xcomm_cleanup();
+    return 0;
+}
@@ -0,0 +1,196 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/resource.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <sys/resource.h>
+#endif
+
+#include "bench-tcp.h"
+#include "deprecated/c11-threads.h"
+
+static bench_tcp_server_mode_t server_mode;
+static xcomm_tcp_packetizer_t  server_packetizer;
+static bool                    server_framed;
+static atomic_bool             server_ready;
+static atomic_ullong           server_accepted;
+static atomic_ullong           server_bytes;
+
+static void _bench_tcp_echo_completed_cb(
+    xcomm_tcp_connection_t* conn, void* buf, size_t len, void* userdata) {
+    (void)conn;
+    (void)len;
+    (void)userdata;
+
+    free(buf);
+}
+
+static void _bench_tcp_recv_cb(
+    xcomm_tcp_connection_t* conn, void* buf, size_t len, void* userdata) {
+    (void)userdata;
+
+    atomic_fetch_add_explicit(&server_bytes, len, memory_order_relaxed);
+    if (server_mode != BENCH_TCP_SERVER_ECHO) {
+        return;
+    }
+    void* copy = malloc(len);
+    if (!copy) {
+        xcomm_async_tcp.close_connection(conn);
+        return;
+    }
+    memcpy(copy, buf, len);
+    xcomm_async_tcp.send(conn, copy, len);
+}
+
+static void _bench_tcp_accept_cb(
+    xcomm_tcp_connection_t* conn, int err, const char* msg, void* userdata) {
+    (void)err;
+    (void)msg;
+    (void)userdata;
+
+    atomic_fetch_add(&server_accepted, 1);
+    if (server_mode == BENCH_TCP_SERVER_CLOSE) {
+        xcomm_async_tcp.close_connection(conn);
+        return;
+    }
+    if (server_framed) {
+        xcomm_async_tcp.set_packetizer(conn, &server_packetizer);
+    }
+    xcomm_async_tcp.set_recv_cb(conn, _bench_tcp_recv_cb, NULL);
+    xcomm_async_tcp.set_send_completed_cb(conn, _bench_tcp_echo_completed_cb, NULL);
+}
+
+static void _bench_tcp_listen_cb(
+    xcomm_tcp_listener_t* listener, int err, const char* msg, void* userdata) {
+    (void)userdata;
+
+    if (!listener) {
+        fprintf(stderr, "listen failed: %d %s\n", err, msg);
+        exit(1);
+    }
+    xcomm_async_tcp.set_accept_cb(listener, _bench_tcp_accept_cb, NULL);
+    atomic_store(&server_ready, true);
+}
+
+/** listens on the engine and returns once connections can be accepted. */
+void bench_tcp_server_start(
+    bench_tcp_server_mode_t mode, xcomm_tcp_packetizer_t* packetizer) {
+    server_mode = mode;
+    if (packetizer) {
+        server_packetizer = *packetizer;
+        server_framed     = true;
+    }
+    xcomm_async_tcp.listen(BENCH_TCP_HOST, BENCH_TCP_PORT, _bench_tcp_listen_cb, NULL);
+
+    while (!atomic_load(&server_ready)) {
+        bench_tcp_sleep(1);
+    }
+}
+
+uint64_t bench_tcp_server_accepted(void) {
+    return atomic_load(&server_accepted);
+}
+
+uint64_t bench_tcp_server_bytes(void) {
+    return atomic_load(&server_bytes);
+}
+
+static int _bench_tcp_compare(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+
+    return (x > y) - (x < y);
+}
+
+/** samples are in nanoseconds and get sorted in place. */
+void bench_tcp_print_latency(uint64_t* samples, size_t n) {
+    if (!n) {
+        printf("\"p50_us\":0,\"p99_us\":0,\"p999_us\":0,\"max_us\":0");
+        return;
+    }
+    qsort(samples, n, sizeof(uint64_t), _bench_tcp_compare);
+
+    printf(
+        "\"p50_us\":%.1f,\"p99_us\":%.1f,\"p999_us\":%.1f,\"max_us\":%.1f",
+        samples[(n - 1) * 500 / 1000] / 1000.0,
+        samples[(n - 1) * 990 / 1000] / 1000.0,
+        samples[(n - 1) * 999 / 1000] / 1000.0,
+        samples[n - 1] / 1000.0);
+}
+
+/** resident set size in bytes, 0 where the platform is not covered. */
+size_t bench_tcp_rss(void) {
+#if defined(__linux__)
+    long  pages = 0;
+    FILE* fp    = fopen("/proc/self/statm", "r");
+
+    if (!fp) {
+        return 0;
+    }
+    if (fscanf(fp, "%*s %ld", &pages) != 1) {
+        pages = 0;
+    }
+    fclose(fp);
+    return (size_t)pages * (size_t)sysconf(_SC_PAGESIZE);
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t      count = MACH_TASK_BASIC_INFO_COUNT;
+
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) !=
+        KERN_SUCCESS) {
+        return 0;
+    }
+    return info.resident_size;
+#else
+    return 0;
+#endif
+}
+
+/** both ends live in this process, so every connection costs two fds. */
+void bench_tcp_raise_nofile(int n) {
+#if defined(__linux__) || defined(__APPLE__)
+    struct rlimit rl;
+
+    if (getrlimit(RLIMIT_NOFILE, &rl)) {
+        return;
+    }
+    if (rl.rlim_cur < (rlim_t)n) {
+        rl.rlim_cur = rl.rlim_max < (rlim_t)n ? rl.rlim_max : (rlim_t)n;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+#else
+    (void)n;
+#endif
+}
+
+void bench_tcp_sleep(int ms) {
+    thrd_sleep(
+        &(struct timespec){.tv_sec = ms / 1000, .tv_nsec = (ms % 1000) * 1000000L},
+        NULL);
+}
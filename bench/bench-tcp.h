@@ -0,0 +1,48 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+_Pragma("once")
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "xcomm.h"
+
+#define BENCH_TCP_HOST "127.0.0.1"
+#define BENCH_TCP_PORT "19091"
+
+typedef enum bench_tcp_server_mode_e bench_tcp_server_mode_t;
+
+/** what the in-process server does with every accepted connection. */
+enum bench_tcp_server_mode_e {
+    BENCH_TCP_SERVER_ECHO,
+    BENCH_TCP_SERVER_DISCARD,
+    BENCH_TCP_SERVER_CLOSE,
+    BENCH_TCP_SERVER_HOLD,
+};
+
+extern void     bench_tcp_server_start(bench_tcp_server_mode_t mode, xcomm_tcp_packetizer_t* packetizer);
+extern uint64_t bench_tcp_server_accepted(void);
+extern uint64_t bench_tcp_server_bytes(void);
+extern void     bench_tcp_print_latency(uint64_t* samples, size_t n);
+extern size_t   bench_tcp_rss(void);
+extern void     bench_tcp_raise_nofile(int n);
+extern void     bench_tcp_sleep(int ms);
@@ -28,7 +28,7 @@ int main(void) {
     char sbuf[64] = "ping";
     char rbuf[64] = {0};
     xcomm_tcp_connection_t* conn =
-        xcomm_sync_tcp.dial("127.0.0.1", "1234");
+        xcomm_sync_tcp.dial("127.0.0.1", "1234", 0);
     
     xcomm_sync_tcp.send(conn, sbuf, sizeof(sbuf));
     printf("cli send %s to srv.\n", sbuf);
@@ -22,6 +22,8 @@
 _Pragma("once")
 
 #include "xcomm/xcomm-tcp-module.h"
+#include "xcomm/xcomm-unix-module.h"
+#include "xcomm/xcomm-shm-module.h"
 #include "xcomm/xcomm-utils-module.h"
 #include "xcomm/xcomm-dumper-module.h"
 #include "xcomm/xcomm-melsec-module.h"
@@ -23,8 +23,12 @@ _Pragma("once")
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
+
+#include "xcomm/xcomm-tcp-module.h"
 
 typedef struct xcomm_serial_module_s xcomm_serial_module_t;
+typedef struct xcomm_async_serial_module_s xcomm_async_serial_module_t;
 typedef struct xcomm_serial_config_s xcomm_serial_config_t;
 typedef enum xcomm_serial_baudrate_e xcomm_serial_baudrate_t;
 typedef enum xcomm_serial_parity_e   xcomm_serial_parity_t;
@@ -32,6 +36,21 @@ typedef enum xcomm_serial_databits_e xcomm_serial_databits_t;
 typedef enum xcomm_serial_stopbits_e xcomm_serial_stopbits_t;
 typedef struct xcomm_serial_s        xcomm_serial_t;
 
+typedef void (*xcomm_serial_open_cb_t)(
+    xcomm_serial_t* serial,
+    int             error_code,
+    const char*     error_message,
+    void*           userdata);
+
+typedef void (*xcomm_serial_recv_cb_t)(
+    xcomm_serial_t* serial, void* buf, size_t len, void* userdata);
+
+typedef void (*xcomm_serial_send_completed_cb_t)(
+    xcomm_serial_t* serial, void* buf, size_t len, void* userdata);
+
+typedef void (*xcomm_serial_close_cb_t)(
+    xcomm_serial_t* serial, void* userdata);
+
 struct xcomm_serial_s {
     void* opaque;
 };
@@ -42,6 +61,14 @@ enum xcomm_serial_baudrate_e {
     XCOMM_SERIAL_BAUDRATE_38400,
     XCOMM_SERIAL_BAUDRATE_57600,
     XCOMM_SERIAL_BAUDRATE_115200,
+    XCOMM_SERIAL_BAUDRATE_230400,
+    XCOMM_SERIAL_BAUDRATE_460800,
+    XCOMM_SERIAL_BAUDRATE_921600,
+    XCOMM_SERIAL_BAUDRATE_1000000,
+    XCOMM_SERIAL_BAUDRATE_1500000,
+    XCOMM_SERIAL_BAUDRATE_2000000,
+    XCOMM_SERIAL_BAUDRATE_3000000,
+    XCOMM_SERIAL_BAUDRATE_CUSTOM,
 };
 
 enum xcomm_serial_parity_e {
@@ -60,6 +87,21 @@ enum xcomm_serial_stopbits_e {
     XCOMM_SERIAL_STOPBITS_TWO,
 };
 
+/**
+ * timeout_ms bounds a whole recv and interbyte_timeout_ms the silence after
+ * a byte arrived, 0 waits forever. a recv that runs out of time returns the
+ * bytes it has so far. custom_baudrate is read with XCOMM_SERIAL_BAUDRATE_CUSTOM,
+ * rates without a constant open on windows, macos and linux on x86, arm,
+ * riscv and loongarch only.
+ * the async module ignores both timeouts.
+ *
+ * low_latency and latency_timer_ms cut the receive delay of the driver on
+ * linux, latency_timer_ms only applies to ftdi usb adapters and 0 keeps the
+ * driver default, both are best effort. rs485 lets the kernel drive RTS
+ * around each send on half duplex buses, rts_on_send picks the level while
+ * sending, the open fails if the driver can not do it. windows only knows
+ * RTS high while sending without delays and fails the open for anything else.
+ */
 struct xcomm_serial_config_s {
     const char* restrict    device;
     xcomm_serial_baudrate_t baudrate;
@@ -67,6 +109,17 @@ struct xcomm_serial_config_s {
     xcomm_serial_databits_t databits;
     xcomm_serial_stopbits_t stopbits;
     size_t                  timeout_ms;
+    size_t                  interbyte_timeout_ms;
+    uint32_t                custom_baudrate;
+    bool                    low_latency;
+    int                     latency_timer_ms;
+
+    struct {
+        bool     enabled;
+        bool     rts_on_send;
+        uint32_t delay_before_send_ms;
+        uint32_t delay_after_send_ms;
+    } rs485;
 };
 
 struct xcomm_serial_module_s {
@@ -78,4 +131,25 @@ struct xcomm_serial_module_s {
     int  (*send)(xcomm_serial_t* serial, uint8_t* buf, int len);
 };
 
-extern xcomm_serial_module_t xcomm_serial;
\ No newline at end of file
+/**
+ * the device is polled by one engine worker, so a single worker can drive
+ * many ports. open_cb runs on that worker, set callbacks there before bytes
+ * arrive. send queues buf until send_completed_cb hands it back, framing
+ * reuses the tcp packetizer. the handle is gone once close_cb returned.
+ * not available on windows, open_cb reports the failure.
+ */
+struct xcomm_async_serial_module_s {
+    const char* restrict name;
+
+    void (*dial)(xcomm_serial_config_t* config, xcomm_serial_open_cb_t open_cb, void* userdata);
+    void (*close)(xcomm_serial_t* serial);
+    int  (*send)(xcomm_serial_t* serial, void* buf, size_t len);
+
+    void (*set_recv_cb)(xcomm_serial_t* serial, xcomm_serial_recv_cb_t recv_cb, void* userdata);
+    void (*set_send_completed_cb)(xcomm_serial_t* serial, xcomm_serial_send_completed_cb_t send_completed_cb, void* userdata);
+    void (*set_close_cb)(xcomm_serial_t* serial, xcomm_serial_close_cb_t close_cb, void* userdata);
+    void (*set_packetizer)(xcomm_serial_t* serial, xcomm_tcp_packetizer_t* packetizer);
+};
+
+extern xcomm_serial_module_t       xcomm_serial;
+extern xcomm_async_serial_module_t xcomm_async_serial;
\ No newline at end of file
@@ -0,0 +1,69 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+_Pragma("once")
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct xcomm_shm_module_s     xcomm_shm_module_t;
+typedef struct xcomm_shm_connection_s xcomm_shm_connection_t;
+typedef struct xcomm_shm_listener_s   xcomm_shm_listener_t;
+
+struct xcomm_shm_connection_s {
+    void* opaque;
+};
+
+struct xcomm_shm_listener_s {
+    void* opaque;
+};
+
+/**
+ * message pipe between two processes on one host, named like "/feed". every
+ * accepted connection gets its own region holding one ring per direction of
+ * capacity bytes, rounded down to a power of two. a message takes its length
+ * plus 4 bytes of ring space.
+ *
+ * send and recv touch no syscall while the peer keeps up, the kernel is
+ * entered only to sleep on an empty or full ring and to wake a sleeping peer.
+ * recv returns one whole message, 0 once the peer closed and the ring is
+ * drained, -1 on timeout. a return above len is the size the next message
+ * needs, it stays in the ring. listen fails while the name is taken, only
+ * the listener that created a region removes it.
+ * negative accept and dial timeouts wait forever, send and recv timeouts of
+ * 0 block forever.
+ */
+struct xcomm_shm_module_s {
+    const char* restrict name;
+
+    xcomm_shm_listener_t* (*listen)(const char* restrict name, size_t capacity);
+    xcomm_shm_connection_t* (*accept)(xcomm_shm_listener_t* listener, int timeout_ms);
+    void (*close_listener)(xcomm_shm_listener_t* listener);
+
+    xcomm_shm_connection_t* (*dial)(const char* restrict name, int timeout_ms);
+    int     (*send)(xcomm_shm_connection_t* conn, const void* buf, size_t len);
+    int64_t (*recv)(xcomm_shm_connection_t* conn, void* buf, size_t len);
+    void    (*close_connection)(xcomm_shm_connection_t* conn);
+    void    (*set_sndtimeo)(xcomm_shm_connection_t* conn, int timeout_ms);
+    void    (*set_rcvtimeo)(xcomm_shm_connection_t* conn, int timeout_ms);
+};
+
+extern xcomm_shm_module_t xcomm_shm;
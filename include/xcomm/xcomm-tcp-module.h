@@ -22,6 +22,7 @@
 _Pragma("once")
 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdbool.h>
 
 typedef struct xcomm_sync_tcp_module_s  xcomm_sync_tcp_module_t;
@@ -29,6 +30,17 @@ typedef struct xcomm_async_tcp_module_s xcomm_async_tcp_module_t;
 typedef struct xcomm_tcp_connection_s   xcomm_tcp_connection_t;
 typedef struct xcomm_tcp_listener_s     xcomm_tcp_listener_t;
 typedef struct xcomm_tcp_packetizer_s   xcomm_tcp_packetizer_t;
+typedef struct xcomm_tcp_sockopts_s     xcomm_tcp_sockopts_t;
+typedef struct xcomm_tcp_pool_s         xcomm_tcp_pool_t;
+typedef struct xcomm_tcp_pool_config_s  xcomm_tcp_pool_config_t;
+typedef struct xcomm_tcp_tls_s          xcomm_tcp_tls_t;
+typedef struct xcomm_tcp_tls_config_s   xcomm_tcp_tls_config_t;
+typedef struct xcomm_tcp_iovec_s        xcomm_tcp_iovec_t;
+typedef struct xcomm_tcp_stats_s        xcomm_tcp_stats_t;
+
+typedef enum xcomm_tcp_packetizer_type_e   xcomm_tcp_packetizer_type_t;
+typedef enum xcomm_tcp_packetizer_endian_e xcomm_tcp_packetizer_endian_t;
+typedef enum xcomm_tcp_profile_e           xcomm_tcp_profile_t;
 
 typedef void (*xcomm_tcp_connect_cb_t)(
     xcomm_tcp_connection_t* conn,
@@ -51,18 +63,39 @@ typedef void (*xcomm_tcp_accept_cb_t)(
 typedef void (*xcomm_tcp_recv_cb_t)(
     xcomm_tcp_connection_t* conn, void* buf, size_t len, void* userdata);
 
+/** requests queued with send_file complete with buf NULL. */
 typedef void (*xcomm_tcp_send_completed_cb_t)(
     xcomm_tcp_connection_t* conn, void* buf, size_t len, void* userdata);
 
 typedef void (*xcomm_tcp_heartbeat_cb_t)(
     xcomm_tcp_connection_t* conn, void* userdata);
 
+typedef void (*xcomm_tcp_writable_cb_t)(
+    xcomm_tcp_connection_t* conn, void* userdata);
+
 typedef void (*xcomm_tcp_connection_close_cb_t)(
     xcomm_tcp_connection_t* conn, void* userdata);
 
 typedef void (*xcomm_tcp_listener_close_cb_t)(
     xcomm_tcp_listener_t* listener, void* userdata);
 
+/** front_to_back and back_to_front count the bytes passed on each way. */
+typedef void (*xcomm_tcp_relay_close_cb_t)(
+    uint64_t    front_to_back,
+    uint64_t    back_to_front,
+    int         error_code,
+    const char* error_message,
+    void*       userdata);
+
+/**
+ * stats_cb runs on the loop of the connection. collect_stats calls it once
+ * per connection of the worker and a last time with conn and stats NULL.
+ */
+typedef void (*xcomm_tcp_stats_cb_t)(
+    xcomm_tcp_connection_t*  conn,
+    const xcomm_tcp_stats_t* stats,
+    void*                    userdata);
+
 struct xcomm_tcp_connection_s {
     void* opaque;
 };
@@ -71,24 +104,181 @@ struct xcomm_tcp_listener_s {
     void* opaque;
 };
 
+enum xcomm_tcp_packetizer_type_e {
+    XCOMM_TCP_PACKETIZER_TYPE_FIXEDLEN    = 1,
+    XCOMM_TCP_PACKETIZER_TYPE_DELIMITER   = 2,
+    XCOMM_TCP_PACKETIZER_TYPE_LENGTHFIELD = 3,
+    XCOMM_TCP_PACKETIZER_TYPE_VARINT      = 4,
+};
+
+enum xcomm_tcp_packetizer_endian_e {
+    XCOMM_TCP_PACKETIZER_ENDIAN_BIG    = 0,
+    XCOMM_TCP_PACKETIZER_ENDIAN_LITTLE = 1,
+};
+
+/**
+ * frames are handed to recv_cb whole, headers and delimiters included.
+ * lengthfield/varint frames span offset + field + value + adjustment bytes.
+ * maxlen bounds a single frame, 0 selects the default of 64KB.
+ */
 struct xcomm_tcp_packetizer_s {
-    int a;
+    xcomm_tcp_packetizer_type_t type;
+    size_t                      maxlen;
+
+    union {
+        struct {
+            size_t len;
+        } fixedlen;
+
+        struct {
+            char   delimiter[8];
+            size_t size;
+        } delimiter;
+
+        struct {
+            size_t                        offset;
+            size_t                        size;
+            xcomm_tcp_packetizer_endian_t endian;
+            int64_t                       adjustment;
+        } lengthfield;
+
+        struct {
+            size_t  offset;
+            int64_t adjustment;
+        } varint;
+    };
+};
+
+enum xcomm_tcp_profile_e {
+    XCOMM_TCP_PROFILE_THROUGHPUT = 0,
+    XCOMM_TCP_PROFILE_LATENCY    = 1,
+};
+
+/**
+ * zero for mss, sndbuf, rcvbuf, busy_poll and notsent_lowat keeps the kernel
+ * default. keepalive timings are in seconds, busy_poll in microseconds.
+ * options the platform lacks are ignored.
+ */
+struct xcomm_tcp_sockopts_s {
+    int  mss;
+    bool nodelay;
+    bool cork;
+    int  sndbuf;
+    int  rcvbuf;
+    bool quickack;
+    bool keepalive;
+    int  keepalive_idle;
+    int  keepalive_intvl;
+    int  keepalive_cnt;
+    int  busy_poll;
+    int  notsent_lowat;
+};
+
+/**
+ * per host:port limits. max_active counts connections checked out or being
+ * dialed, 0 leaves it unbounded. idle connections are closed after
+ * idle_timeout_ms, 0 keeps them until they break.
+ */
+struct xcomm_tcp_pool_config_s {
+    int max_idle;
+    int max_active;
+    int idle_timeout_ms;
+    int connect_timeout_ms;
+};
+
+struct xcomm_tcp_pool_s {
+    void* opaque;
+};
+
+/**
+ * one context serves connections on every worker. a server needs cert_file
+ * and key_file. a client checks the server against ca_file, or the system
+ * store when it is NULL, unless skip_verify is set. a server checks client
+ * certificates only with verify_peer. session_cache_size and
+ * session_timeout_s bound resumable sessions, 0 selects the defaults. ktls
+ * moves record encryption of tls 1.3 connections into the kernel once
+ * established, where the kernel supports it.
+ */
+struct xcomm_tcp_tls_config_s {
+    bool        server;
+    const char* cert_file;
+    const char* key_file;
+    const char* ca_file;
+    bool        verify_peer;
+    bool        skip_verify;
+    int         session_cache_size;
+    int         session_timeout_s;
+    bool        ktls;
+};
+
+struct xcomm_tcp_tls_s {
+    void* opaque;
+};
+
+/** one piece of a gathered send or scattered receive. */
+struct xcomm_tcp_iovec_s {
+    void*  base;
+    size_t len;
+};
+
+/**
+ * bytes count what went over the socket, tls records included. sendq_bytes
+ * is what send accepted and has not completed yet, sendq_age_us the wait of
+ * the oldest queued request. queue_time_us adds up, over all completed
+ * requests, the time from the loop taking the send to completion, over sends
+ * it gives the mean. times come from the clock the loop samples on wakeup,
+ * last_recv_ms and last_send_ms are wall clock stamps at that resolution.
+ * the kernel part is valid with has_tcp_info, rtt in microseconds, cwnd in
+ * segments, delivery_rate in bytes per second and 0 where the platform does
+ * not report it.
+ */
+struct xcomm_tcp_stats_s {
+    uint64_t bytes_in;
+    uint64_t bytes_out;
+    size_t   sendq_depth;
+    size_t   sendq_bytes;
+    uint64_t sendq_age_us;
+    uint64_t sends;
+    uint64_t queue_time_us;
+    uint64_t last_recv_ms;
+    uint64_t last_send_ms;
+
+    bool     has_tcp_info;
+    uint32_t rtt_us;
+    uint32_t rttvar_us;
+    uint32_t retransmits;
+    uint32_t cwnd;
+    uint64_t delivery_rate;
 };
 
 struct xcomm_sync_tcp_module_s {
     const char* restrict name;
 
-    xcomm_tcp_connection_t* (*dial)(const char* restrict host, const char* restrict port);
+    xcomm_tcp_connection_t* (*dial)(const char* restrict host, const char* restrict port, int timeout_ms);
     xcomm_tcp_listener_t* (*listen)(const char* restrict host, const char* restrict port);
 
     xcomm_tcp_connection_t* (*accept)(xcomm_tcp_listener_t* listener);
     void (*close_listener)(xcomm_tcp_listener_t* listener);
 
-    int  (*send)(xcomm_tcp_connection_t* conn, void* buf, int len);
-    int  (*recv)(xcomm_tcp_connection_t* conn, void* buf, int len);
+    int64_t (*send)(xcomm_tcp_connection_t* conn, void* buf, size_t len);
+    int64_t (*recv)(xcomm_tcp_connection_t* conn, void* buf, size_t len);
+    int64_t (*sendv)(xcomm_tcp_connection_t* conn, const xcomm_tcp_iovec_t* iov, int iovcnt);
+    int64_t (*recvv)(xcomm_tcp_connection_t* conn, const xcomm_tcp_iovec_t* iov, int iovcnt);
+    int64_t (*recv_some)(xcomm_tcp_connection_t* conn, void* buf, size_t len);
+    int64_t (*peek)(xcomm_tcp_connection_t* conn, void* buf, size_t len);
+    int64_t (*send_file)(xcomm_tcp_connection_t* conn, int fd, int64_t offset, int64_t len);
     void (*close_connection)(xcomm_tcp_connection_t* conn);
     void (*set_sndtimeo)(xcomm_tcp_connection_t* conn, int timeout_ms);
     void (*set_rcvtimeo)(xcomm_tcp_connection_t* conn, int timeout_ms);
+
+    void (*load_profile)(xcomm_tcp_profile_t profile, xcomm_tcp_sockopts_t* opts);
+    void (*set_default_sockopts)(const xcomm_tcp_sockopts_t* opts);
+    void (*set_sockopts)(xcomm_tcp_connection_t* conn, const xcomm_tcp_sockopts_t* opts);
+
+    xcomm_tcp_pool_t* (*create_pool)(const xcomm_tcp_pool_config_t* config);
+    void (*destroy_pool)(xcomm_tcp_pool_t* pool);
+    xcomm_tcp_connection_t* (*checkout)(xcomm_tcp_pool_t* pool, const char* restrict host, const char* restrict port);
+    void (*checkin)(xcomm_tcp_connection_t* conn);
 };
 
 struct xcomm_async_tcp_module_s {
@@ -96,8 +286,11 @@ struct xcomm_async_tcp_module_s {
 
     void (*dial)(const char* restrict host, const char* restrict port, int timeout_ms, xcomm_tcp_connect_cb_t connect_cb, void* userdata);
     void (*listen)(const char* restrict host, const char* restrict port, xcomm_tcp_listen_cb_t listen_cb, void* userdata);
+    void (*listen_sharded)(const char* restrict host, const char* restrict port, xcomm_tcp_listen_cb_t listen_cb, void* userdata);
     
     void (*set_accept_cb)(xcomm_tcp_listener_t* listener, xcomm_tcp_accept_cb_t accept_cb, void* userdata);
+    void (*set_accept_batch)(xcomm_tcp_listener_t* listener, int batch);
+    void (*set_listener_affinity)(xcomm_tcp_listener_t* listener, bool on);
     void (*set_listener_close_cb)(xcomm_tcp_listener_t* listener, xcomm_tcp_listener_close_cb_t listener_close_cb, void* userdata);
     void (*close_listener)(xcomm_tcp_listener_t* listener);
 
@@ -106,11 +299,32 @@ struct xcomm_async_tcp_module_s {
     void (*set_heartbeat_cb)(xcomm_tcp_connection_t* conn, xcomm_tcp_heartbeat_cb_t heartbeat_cb, void* userdata);
     void (*set_connection_close_cb)(xcomm_tcp_connection_t* conn, xcomm_tcp_connection_close_cb_t connection_close_cb, void* userdata);
     void (*close_connection)(xcomm_tcp_connection_t* conn);
-    void (*send)(xcomm_tcp_connection_t* conn, void* buf, size_t len);
+    int  (*send)(xcomm_tcp_connection_t* conn, void* buf, size_t len);
+    int  (*send_file)(xcomm_tcp_connection_t* conn, int fd, int64_t offset, size_t len);
+    void (*set_send_watermark)(xcomm_tcp_connection_t* conn, size_t low, size_t high);
+    void (*set_writable_cb)(xcomm_tcp_connection_t* conn, xcomm_tcp_writable_cb_t writable_cb, void* userdata);
     void (*set_sendtimeo)(xcomm_tcp_connection_t* conn, int timeout_ms);
     void (*set_recvtimeo)(xcomm_tcp_connection_t* conn, int timeout_ms);
     void (*set_heartbeat_interval)(xcomm_tcp_connection_t* conn, int interval_ms);
     void (*set_packetizer)(xcomm_tcp_connection_t* conn,xcomm_tcp_packetizer_t* packetizer);
+    void (*set_zerocopy)(xcomm_tcp_connection_t* conn, bool enable);
+    int  (*relay)(xcomm_tcp_connection_t* front, xcomm_tcp_connection_t* back, xcomm_tcp_relay_close_cb_t relay_close_cb, void* userdata);
+    void (*get_stats)(xcomm_tcp_connection_t* conn, xcomm_tcp_stats_cb_t stats_cb, void* userdata);
+    void (*collect_stats)(int worker, xcomm_tcp_stats_cb_t stats_cb, void* userdata);
+
+    void (*load_profile)(xcomm_tcp_profile_t profile, xcomm_tcp_sockopts_t* opts);
+    void (*set_default_sockopts)(const xcomm_tcp_sockopts_t* opts);
+    void (*set_sockopts)(xcomm_tcp_connection_t* conn, const xcomm_tcp_sockopts_t* opts);
+
+    xcomm_tcp_pool_t* (*create_pool)(const xcomm_tcp_pool_config_t* config);
+    void (*destroy_pool)(xcomm_tcp_pool_t* pool);
+    void (*checkout)(xcomm_tcp_pool_t* pool, const char* restrict host, const char* restrict port, xcomm_tcp_connect_cb_t connect_cb, void* userdata);
+    void (*checkin)(xcomm_tcp_connection_t* conn);
+
+    xcomm_tcp_tls_t* (*create_tls)(const xcomm_tcp_tls_config_t* config);
+    void (*destroy_tls)(xcomm_tcp_tls_t* tls);
+    void (*dial_tls)(xcomm_tcp_tls_t* tls, const char* restrict host, const char* restrict port, int timeout_ms, xcomm_tcp_connect_cb_t connect_cb, void* userdata);
+    void (*set_listener_tls)(xcomm_tcp_listener_t* listener, xcomm_tcp_tls_t* tls);
 };
 
 extern xcomm_sync_tcp_module_t  xcomm_sync_tcp;
@@ -0,0 +1,412 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <limits.h>
+#include <string.h>
+
+#include "xcomm-logger.h"
+#include "xcomm-engine.h"
+#include "xcomm-serial.h"
+#include "xcomm-async-serial.h"
+#include "xcomm-event-routine.h"
+#include "platform/platform-uart.h"
+#include "platform/platform-socket.h"
+
+typedef struct async_serial_dial_context_s       async_serial_dial_context_t;
+typedef struct async_serial_packetizer_context_s async_serial_packetizer_context_t;
+
+struct async_serial_dial_context_s {
+    xcomm_serial_config_t  config;
+    xcomm_event_loop_t*    loop;
+    xcomm_serial_open_cb_t open_cb;
+    void*                  userdata;
+};
+
+struct async_serial_packetizer_context_s {
+    async_serial_t*   serial;
+    tcp_packetizer_t* packetizer;
+};
+
+static void _async_serial_dispatch(
+    xcomm_event_loop_t* loop, void (*routine)(void*), void* param) {
+    if (thrd_equal(loop->tid, thrd_current())) {
+        routine(param);
+    } else {
+        xcomm_event_routine_add(loop, routine, param);
+    }
+}
+
+static void _async_serial_free(void* param) {
+    free(param);
+}
+
+static void _async_serial_packetizer_free(void* param) {
+    xcomm_tcp_packetizer_destroy(param);
+    free(param);
+}
+
+static void _async_serial_dial_context_free(async_serial_dial_context_t* context) {
+    free((char*)context->config.device);
+    free(context);
+}
+
+static void _async_serial_send_req_complete(async_serial_send_req_t* req) {
+    async_serial_t* serial = req->serial;
+
+    if (serial->send_completed_cb) {
+        serial->send_completed_cb(
+            &serial->handle, req->buf, req->len, serial->send_completed_ud);
+    }
+    free(req);
+}
+
+static void _async_serial_close(async_serial_t* serial) {
+    if (serial->closed) {
+        return;
+    }
+    serial->closed = true;
+
+    if (serial->registered) {
+        xcomm_event_io_del(serial->loop, &serial->io);
+        serial->registered = false;
+    }
+    platform_uart_close(serial->uart);
+
+    while (!xcomm_list_empty(&serial->sendq)) {
+        xcomm_list_node_t* node = xcomm_list_head(&serial->sendq);
+        xcomm_list_remove(node);
+
+        _async_serial_send_req_complete(
+            xcomm_list_data(node, async_serial_send_req_t, node));
+    }
+    if (serial->packetizer) {
+        xcomm_event_routine_add(
+            serial->loop, _async_serial_packetizer_free, serial->packetizer);
+        serial->packetizer = NULL;
+    }
+    if (serial->close_cb) {
+        serial->close_cb(&serial->handle, serial->close_ud);
+    }
+    /** the io event may still sit in the current completion batch. */
+    xcomm_event_routine_add(serial->loop, _async_serial_free, serial);
+}
+
+static void _async_serial_flush(async_serial_t* serial) {
+    while (!xcomm_list_empty(&serial->sendq)) {
+        async_serial_send_req_t* req = xcomm_list_data(
+            xcomm_list_head(&serial->sendq), async_serial_send_req_t, node);
+
+        size_t remain = req->len - req->off;
+        int    n      = platform_uart_write_some(
+            serial->uart,
+            (uint8_t*)req->buf + req->off,
+            remain > INT_MAX ? INT_MAX : (int)remain);
+        if (n == PLATFORM_UA_ERROR_UART_ERROR) {
+            int err = platform_uart_get_lasterror();
+            if (err == PLATFORM_UA_ERROR_EAGAIN) {
+                xcomm_event_io_mod(serial->loop, &serial->io, PLATFORM_POLLER_RW_OP);
+                return;
+            }
+            xcomm_loge("serial write error: %s.\n", platform_socket_tostring(err));
+            _async_serial_close(serial);
+            return;
+        }
+        req->off += n;
+        if (req->off < req->len) {
+            continue;
+        }
+        xcomm_list_remove(&req->node);
+        _async_serial_send_req_complete(req);
+        if (serial->closed) {
+            return;
+        }
+    }
+    /** only drop the write watch once it was actually armed. */
+    if (serial->io.op & PLATFORM_POLLER_WR_OP) {
+        xcomm_event_io_mod(serial->loop, &serial->io, PLATFORM_POLLER_RD_OP);
+    }
+}
+
+static bool _async_serial_frame_cb(void* param, void* frame, size_t len) {
+    async_serial_t*   serial     = param;
+    tcp_packetizer_t* packetizer = serial->packetizer;
+
+    if (serial->recv_cb) {
+        serial->recv_cb(&serial->handle, frame, len, serial->recv_ud);
+    }
+    /** stop when the callback closed the device or swapped framers. */
+    return !serial->closed && serial->packetizer == packetizer;
+}
+
+static void _async_serial_deliver(async_serial_t* serial, char* buf, size_t len) {
+    while (len > 0 && serial->packetizer) {
+        ssize_t n = xcomm_tcp_packetizer_feed(
+            serial->packetizer, buf, len, _async_serial_frame_cb, serial);
+        if (n < 0) {
+            xcomm_loge("serial packetizer error, malformed frame.\n");
+            _async_serial_close(serial);
+            return;
+        }
+        if (serial->closed) {
+            return;
+        }
+        buf += n;
+        len -= n;
+    }
+    if (len > 0 && serial->recv_cb) {
+        serial->recv_cb(&serial->handle, buf, len, serial->recv_ud);
+    }
+}
+
+static void _async_serial_recv(async_serial_t* serial) {
+    char buf[ASYNC_SERIAL_RECV_BUFSIZE];
+
+    while (true) {
+        int n = platform_uart_read_some(serial->uart, (uint8_t*)buf, sizeof(buf));
+        if (n == PLATFORM_UA_ERROR_UART_ERROR) {
+            int err = platform_uart_get_lasterror();
+            if (err == PLATFORM_UA_ERROR_EAGAIN) {
+                return;
+            }
+            xcomm_loge("serial read error: %s.\n", platform_socket_tostring(err));
+            _async_serial_close(serial);
+            return;
+        }
+        /** the device hung up. */
+        if (n == 0) {
+            _async_serial_close(serial);
+            return;
+        }
+        _async_serial_deliver(serial, buf, (size_t)n);
+
+        if (serial->closed || n < (int)sizeof(buf)) {
+            return;
+        }
+    }
+}
+
+static void _async_serial_io_cb(void* param, platform_poller_op_t op) {
+    async_serial_t* serial = param;
+
+    if (serial->closed) {
+        return;
+    }
+    if ((op & PLATFORM_POLLER_WR_OP) && !xcomm_list_empty(&serial->sendq)) {
+        _async_serial_flush(serial);
+        if (serial->closed) {
+            return;
+        }
+    }
+    if (op & PLATFORM_POLLER_RD_OP) {
+        _async_serial_recv(serial);
+    }
+}
+
+static void _async_serial_dial(void* param) {
+    async_serial_dial_context_t* context = param;
+    platform_uart_config_t       uconfig = {0};
+
+    xcomm_serial_config_map(&context->config, &uconfig);
+
+    platform_uart_t uart = platform_uart_open(&uconfig, true);
+    if (uart == PLATFORM_UA_ERROR_INVALID_UART) {
+        int err = platform_uart_get_lasterror();
+
+        xcomm_loge("open serial failed.\n");
+        context->open_cb(NULL, err, platform_socket_tostring(err), context->userdata);
+        _async_serial_dial_context_free(context);
+        return;
+    }
+    async_serial_t* serial = calloc(1, sizeof(async_serial_t));
+    if (!serial) {
+        xcomm_loge("no memory.\n");
+        platform_uart_close(uart);
+        context->open_cb(NULL, ENOMEM, platform_socket_tostring(ENOMEM), context->userdata);
+        _async_serial_dial_context_free(context);
+        return;
+    }
+    serial->handle.opaque = serial;
+    serial->uart          = uart;
+    serial->loop          = context->loop;
+    serial->registered    = true;
+    xcomm_list_init(&serial->sendq);
+
+    xcomm_event_io_add(
+        serial->loop,
+        &serial->io,
+        (platform_poller_fd_t)uart,
+        PLATFORM_POLLER_RD_OP,
+        _async_serial_io_cb,
+        serial);
+
+    context->open_cb(&serial->handle, 0, platform_socket_tostring(0), context->userdata);
+    _async_serial_dial_context_free(context);
+}
+
+static void _async_serial_close_routine(void* param) {
+    _async_serial_close(param);
+}
+
+static void _async_serial_send(void* param) {
+    async_serial_send_req_t* req    = param;
+    async_serial_t*          serial = req->serial;
+
+    if (serial->closed) {
+        _async_serial_send_req_complete(req);
+        return;
+    }
+    bool idle = xcomm_list_empty(&serial->sendq);
+    xcomm_list_insert_tail(&serial->sendq, &req->node);
+
+    if (idle) {
+        _async_serial_flush(serial);
+    }
+}
+
+static void _async_serial_set_packetizer(void* param) {
+    async_serial_packetizer_context_t* context = param;
+    async_serial_t*                    serial  = context->serial;
+
+    if (serial->closed) {
+        if (context->packetizer) {
+            _async_serial_packetizer_free(context->packetizer);
+        }
+    } else {
+        /** the old framer may be mid-feed when this runs from a callback. */
+        if (serial->packetizer) {
+            xcomm_event_routine_add(
+                serial->loop, _async_serial_packetizer_free, serial->packetizer);
+        }
+        serial->packetizer = context->packetizer;
+    }
+    free(context);
+}
+
+void xcomm_async_serial_dial(
+    xcomm_serial_config_t* config, xcomm_serial_open_cb_t open_cb, void* userdata) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    async_serial_dial_context_t* context =
+        calloc(1, sizeof(async_serial_dial_context_t));
+    if (!context) {
+        xcomm_loge("no memory.\n");
+        open_cb(NULL, ENOMEM, platform_socket_tostring(ENOMEM), userdata);
+        return;
+    }
+    context->config        = *config;
+    context->config.device = strdup(config->device);
+    if (!context->config.device) {
+        xcomm_loge("no memory.\n");
+        free(context);
+        open_cb(NULL, ENOMEM, platform_socket_tostring(ENOMEM), userdata);
+        return;
+    }
+    context->loop     = &engine.roundrobin()->looper;
+    context->open_cb  = open_cb;
+    context->userdata = userdata;
+
+    _async_serial_dispatch(context->loop, _async_serial_dial, context);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+}
+
+void xcomm_async_serial_close(xcomm_serial_t* serial) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    async_serial_t* self = serial->opaque;
+    _async_serial_dispatch(self->loop, _async_serial_close_routine, self);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+}
+
+int xcomm_async_serial_send(xcomm_serial_t* serial, void* buf, size_t len) {
+    async_serial_t* self = serial->opaque;
+
+    async_serial_send_req_t* req = calloc(1, sizeof(async_serial_send_req_t));
+    if (!req) {
+        xcomm_loge("no memory.\n");
+        return -1;
+    }
+    req->buf    = buf;
+    req->len    = len;
+    req->serial = self;
+
+    _async_serial_dispatch(self->loop, _async_serial_send, req);
+    return 0;
+}
+
+void xcomm_async_serial_set_recv_cb(
+    xcomm_serial_t* serial, xcomm_serial_recv_cb_t recv_cb, void* userdata) {
+    async_serial_t* self = serial->opaque;
+
+    self->recv_cb = recv_cb;
+    self->recv_ud = userdata;
+}
+
+void xcomm_async_serial_set_send_completed_cb(
+    xcomm_serial_t*                  serial,
+    xcomm_serial_send_completed_cb_t send_completed_cb,
+    void*                            userdata) {
+    async_serial_t* self = serial->opaque;
+
+    self->send_completed_cb = send_completed_cb;
+    self->send_completed_ud = userdata;
+}
+
+void xcomm_async_serial_set_close_cb(
+    xcomm_serial_t* serial, xcomm_serial_close_cb_t close_cb, void* userdata) {
+    async_serial_t* self = serial->opaque;
+
+    self->close_cb = close_cb;
+    self->close_ud = userdata;
+}
+
+void xcomm_async_serial_set_packetizer(
+    xcomm_serial_t* serial, xcomm_tcp_packetizer_t* packetizer) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    async_serial_t*                    self = serial->opaque;
+    async_serial_packetizer_context_t* context =
+        calloc(1, sizeof(async_serial_packetizer_context_t));
+    if (!context) {
+        xcomm_loge("no memory.\n");
+        return;
+    }
+    if (packetizer) {
+        context->packetizer = malloc(sizeof(tcp_packetizer_t));
+        if (!context->packetizer) {
+            xcomm_loge("no memory.\n");
+            free(context);
+            return;
+        }
+        if (xcomm_tcp_packetizer_init(context->packetizer, packetizer)) {
+            xcomm_loge("invalid serial packetizer.\n");
+            free(context->packetizer);
+            free(context);
+            return;
+        }
+    }
+    context->serial = self;
+
+    _async_serial_dispatch(self->loop, _async_serial_set_packetizer, context);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+}
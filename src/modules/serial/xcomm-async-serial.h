@@ -0,0 +1,68 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+_Pragma("once")
+
+#include "xcomm-list.h"
+#include "xcomm-event-io.h"
+#include "modules/tcp/xcomm-tcp-packetizer.h"
+#include "xcomm/xcomm-serial-module.h"
+#include "platform/platform-types.h"
+
+#define ASYNC_SERIAL_RECV_BUFSIZE 4096
+
+typedef struct async_serial_s          async_serial_t;
+typedef struct async_serial_send_req_s async_serial_send_req_t;
+
+struct async_serial_send_req_s {
+    void*             buf;
+    size_t            len;
+    size_t            off;
+    async_serial_t*   serial;
+    xcomm_list_node_t node;
+};
+
+/** everything but the callback setters runs on the loop the device sits on. */
+struct async_serial_s {
+    xcomm_serial_t      handle;
+    platform_uart_t     uart;
+    xcomm_event_loop_t* loop;
+    xcomm_event_io_t    io;
+    bool                registered;
+    bool                closed;
+    xcomm_list_t        sendq;
+    tcp_packetizer_t*   packetizer;
+
+    xcomm_serial_recv_cb_t           recv_cb;
+    void*                            recv_ud;
+    xcomm_serial_send_completed_cb_t send_completed_cb;
+    void*                            send_completed_ud;
+    xcomm_serial_close_cb_t          close_cb;
+    void*                            close_ud;
+};
+
+extern void xcomm_async_serial_dial(xcomm_serial_config_t* config, xcomm_serial_open_cb_t open_cb, void* userdata);
+extern void xcomm_async_serial_close(xcomm_serial_t* serial);
+extern int  xcomm_async_serial_send(xcomm_serial_t* serial, void* buf, size_t len);
+extern void xcomm_async_serial_set_recv_cb(xcomm_serial_t* serial, xcomm_serial_recv_cb_t recv_cb, void* userdata);
+extern void xcomm_async_serial_set_send_completed_cb(xcomm_serial_t* serial, xcomm_serial_send_completed_cb_t send_completed_cb, void* userdata);
+extern void xcomm_async_serial_set_close_cb(xcomm_serial_t* serial, xcomm_serial_close_cb_t close_cb, void* userdata);
+extern void xcomm_async_serial_set_packetizer(xcomm_serial_t* serial, xcomm_tcp_packetizer_t* packetizer);
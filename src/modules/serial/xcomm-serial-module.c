@@ -20,6 +20,7 @@
  */
 
 #include "xcomm-serial.h"
+#include "xcomm-async-serial.h"
 #include "xcomm/xcomm-serial-module.h"
 
 xcomm_serial_module_t xcomm_serial = {
@@ -29,3 +30,14 @@ xcomm_serial_module_t xcomm_serial = {
     .recv  = xcomm_serial_read,
     .send  = xcomm_serial_write,
 };
+
+xcomm_async_serial_module_t xcomm_async_serial = {
+    .name                  = "Xcomm Async Serial Module",
+    .dial                  = xcomm_async_serial_dial,
+    .close                 = xcomm_async_serial_close,
+    .send                  = xcomm_async_serial_send,
+    .set_recv_cb           = xcomm_async_serial_set_recv_cb,
+    .set_send_completed_cb = xcomm_async_serial_set_send_completed_cb,
+    .set_close_cb          = xcomm_async_serial_set_close_cb,
+    .set_packetizer        = xcomm_async_serial_set_packetizer,
+};
@@ -23,12 +23,19 @@
 #include "xcomm-logger.h"
 #include "platform/platform-uart.h"
 
-static const platform_uart_baudrate_t baudrate_map[] = {
-    [XCOMM_SERIAL_BAUDRATE_9600]   = PLATFORM_UART_BAUDRATE_9600,
-    [XCOMM_SERIAL_BAUDRATE_19200]  = PLATFORM_UART_BAUDRATE_19200,
-    [XCOMM_SERIAL_BAUDRATE_38400]  = PLATFORM_UART_BAUDRATE_38400,
-    [XCOMM_SERIAL_BAUDRATE_57600]  = PLATFORM_UART_BAUDRATE_57600,
-    [XCOMM_SERIAL_BAUDRATE_115200] = PLATFORM_UART_BAUDRATE_115200,
+static const uint32_t baudrate_map[] = {
+    [XCOMM_SERIAL_BAUDRATE_9600]    = 9600,
+    [XCOMM_SERIAL_BAUDRATE_19200]   = 19200,
+    [XCOMM_SERIAL_BAUDRATE_38400]   = 38400,
+    [XCOMM_SERIAL_BAUDRATE_57600]   = 57600,
+    [XCOMM_SERIAL_BAUDRATE_115200]  = 115200,
+    [XCOMM_SERIAL_BAUDRATE_230400]  = 230400,
+    [XCOMM_SERIAL_BAUDRATE_460800]  = 460800,
+    [XCOMM_SERIAL_BAUDRATE_921600]  = 921600,
+    [XCOMM_SERIAL_BAUDRATE_1000000] = 1000000,
+    [XCOMM_SERIAL_BAUDRATE_1500000] = 1500000,
+    [XCOMM_SERIAL_BAUDRATE_2000000] = 2000000,
+    [XCOMM_SERIAL_BAUDRATE_3000000] = 3000000,
 };
 
 static const platform_uart_parity_t parity_map[] = {
@@ -47,12 +54,32 @@ static const platform_uart_stopbits_t stopbits_map[] = {
     [XCOMM_SERIAL_STOPBITS_TWO] = PLATFORM_UART_STOPBITS_TWO,
 };
 
+void xcomm_serial_config_map(
+    xcomm_serial_config_t* config, platform_uart_config_t* uconfig) {
+    uconfig->device   = config->device;
+    uconfig->baudrate = (config->baudrate == XCOMM_SERIAL_BAUDRATE_CUSTOM)
+                            ? config->custom_baudrate
+                            : baudrate_map[config->baudrate];
+    uconfig->parity   = parity_map[config->parity];
+    uconfig->databits = databits_map[config->databits];
+    uconfig->stopbits = stopbits_map[config->stopbits];
+
+    uconfig->timeout_ms           = config->timeout_ms;
+    uconfig->interbyte_timeout_ms = config->interbyte_timeout_ms;
+    uconfig->low_latency          = config->low_latency;
+    uconfig->latency_timer_ms     = config->latency_timer_ms;
+
+    uconfig->rs485.enabled              = config->rs485.enabled;
+    uconfig->rs485.rts_on_send          = config->rs485.rts_on_send;
+    uconfig->rs485.delay_before_send_ms = config->rs485.delay_before_send_ms;
+    uconfig->rs485.delay_after_send_ms  = config->rs485.delay_after_send_ms;
+}
+
 void xcomm_serial_close(xcomm_serial_t* serial) {
     xcomm_logi("%s enter.\n", __FUNCTION__);
 
-    platform_uart_t* uartptr = serial->opaque;
-    platform_uart_t  uartobj = *uartptr;
-    platform_uart_close(uartobj);
+    sync_serial_t* self = serial->opaque;
+    platform_uart_close(self->uart);
 
     free(serial->opaque);
     free(serial);
@@ -68,37 +95,35 @@ xcomm_serial_t* xcomm_serial_open(xcomm_serial_config_t* config) {
         xcomm_loge("no memory.\n");
         return NULL;
     }
-    serial->opaque = malloc(sizeof(platform_uart_t));
-    if (!serial->opaque) {
+    sync_serial_t* self = malloc(sizeof(sync_serial_t));
+    if (!self) {
         xcomm_loge("no memory.\n");
         free(serial);
         return NULL;
     }
-    platform_uart_config_t uconfig = {
-        .device   = config->device,
-        .baudrate = baudrate_map[config->baudrate],
-        .parity   = parity_map[config->parity],
-        .databits = databits_map[config->databits],
-        .stopbits = stopbits_map[config->stopbits],
-    };
-    platform_uart_t uartobj = platform_uart_open(&uconfig);
-    if (uartobj != PLATFORM_UA_ERROR_INVALID_UART) {
-        memcpy(serial->opaque, &uartobj, sizeof(platform_uart_t));
-    } else {
+    platform_uart_config_t uconfig = {0};
+    xcomm_serial_config_map(config, &uconfig);
+
+    self->uart = platform_uart_open(&uconfig, false);
+    if (self->uart == PLATFORM_UA_ERROR_INVALID_UART) {
         xcomm_loge("open serial failed.\n");
-        free(serial->opaque);
+        free(self);
         free(serial);
         return NULL;
     }
+    self->timeout_ms           = config->timeout_ms;
+    self->interbyte_timeout_ms = config->interbyte_timeout_ms;
+    serial->opaque             = self;
+
     xcomm_logi("%s leave.\n", __FUNCTION__);
     return serial;
 }
 
 int xcomm_serial_read(xcomm_serial_t* serial, uint8_t* buf, int len) {
-    platform_uart_t* uartptr = serial->opaque;
-    platform_uart_t  uartobj = *uartptr;
+    sync_serial_t* self = serial->opaque;
 
-    int ret = platform_uart_read(uartobj, buf, len);
+    int ret = platform_uart_read(
+        self->uart, buf, len, self->timeout_ms, self->interbyte_timeout_ms);
     if (ret == PLATFORM_UA_ERROR_UART_ERROR) {
         return -1;
     }
@@ -106,10 +131,9 @@ int xcomm_serial_read(xcomm_serial_t* serial, uint8_t* buf, int len) {
 }
 
 int xcomm_serial_write(xcomm_serial_t* serial, uint8_t* buf, int len) {
-    platform_uart_t* uartptr = serial->opaque;
-    platform_uart_t  uartobj = *uartptr;
-    
-    int ret = platform_uart_write(uartobj, buf, len);
+    sync_serial_t* self = serial->opaque;
+
+    int ret = platform_uart_write(self->uart, buf, len);
     if (ret == PLATFORM_UA_ERROR_UART_ERROR) {
         return -1;
     }
@@ -22,7 +22,18 @@
 _Pragma("once")
 
 #include "xcomm/xcomm-serial-module.h"
+#include "platform/platform-types.h"
 
+typedef struct sync_serial_s sync_serial_t;
+
+/** the platform read takes the timeouts per call, unix has nowhere else to keep them. */
+struct sync_serial_s {
+    platform_uart_t uart;
+    size_t          timeout_ms;
+    size_t          interbyte_timeout_ms;
+};
+
+extern void xcomm_serial_config_map(xcomm_serial_config_t* config, platform_uart_config_t* uconfig);
 extern xcomm_serial_t* xcomm_serial_open(xcomm_serial_config_t* config);
 extern void xcomm_serial_close(xcomm_serial_t* serial);
 extern int  xcomm_serial_read(xcomm_serial_t* serial, uint8_t* buf, int len);
@@ -0,0 +1,38 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "xcomm-shm.h"
+#include "xcomm/xcomm-shm-module.h"
+
+xcomm_shm_module_t xcomm_shm = {
+    .name             = "Xcomm Shm Module",
+
+    .listen           = xcomm_shm_listen,
+    .accept           = xcomm_shm_accept,
+    .close_listener   = xcomm_shm_close_listener,
+
+    .dial             = xcomm_shm_dial,
+    .send             = xcomm_shm_send,
+    .recv             = xcomm_shm_recv,
+    .close_connection = xcomm_shm_close_connection,
+    .set_sndtimeo     = xcomm_shm_set_sndtimeo,
+    .set_rcvtimeo     = xcomm_shm_set_rcvtimeo,
+};
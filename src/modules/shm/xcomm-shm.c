@@ -0,0 +1,431 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "xcomm-shm.h"
+#include "xcomm-utils.h"
+#include "xcomm-logger.h"
+#include "platform/platform-shm.h"
+#include "deprecated/c11-threads.h"
+
+static inline uint32_t _shm_rounddown_pow_of_two(uint32_t n) {
+    n |= n >> 1;
+    n |= n >> 2;
+    n |= n >> 4;
+    n |= n >> 8;
+    n |= n >> 16;
+    return (n + 1) >> 1;
+}
+
+static inline void _shm_copy_in(
+    char* ring, uint32_t mask, uint32_t pos, const void* src, uint32_t len) {
+    uint32_t off = pos & mask;
+    uint32_t l   = (len < (mask + 1) - off) ? len : (mask + 1) - off;
+
+    memcpy(ring + off, src, l);
+    memcpy(ring, (const char*)src + l, len - l);
+}
+
+static inline void _shm_copy_out(
+    void* dst, const char* ring, uint32_t mask, uint32_t pos, uint32_t len) {
+    uint32_t off = pos & mask;
+    uint32_t l   = (len < (mask + 1) - off) ? len : (mask + 1) - off;
+
+    memcpy(dst, ring + off, l);
+    memcpy((char*)dst + l, ring, len - l);
+}
+
+/** 0 stands for no deadline. */
+static uint64_t _shm_deadline(int timeout_ms) {
+    if (timeout_ms < 0) {
+        return 0;
+    }
+    return xcomm_utils_getnow(XCOMM_TIME_PRECISION_MSEC) + (uint64_t)timeout_ms;
+}
+
+static int _shm_remaining(uint64_t deadline) {
+    if (!deadline) {
+        return -1;
+    }
+    uint64_t now = xcomm_utils_getnow(XCOMM_TIME_PRECISION_MSEC);
+    if (now >= deadline) {
+        return 0;
+    }
+    return (deadline - now > INT_MAX) ? INT_MAX : (int)(deadline - now);
+}
+
+/** taking the flag keeps a peer that has yet to wake from costing a wake each. */
+static inline void _shm_ring(atomic_uint* wait, atomic_uint* bell) {
+    if (atomic_load(wait) && atomic_exchange(wait, 0)) {
+        atomic_fetch_add(bell, 1);
+        platform_shm_wake(bell);
+    }
+}
+
+/**
+ * waits for pos to move away from seen or the pair to close, spinning a
+ * while before going to sleep. the bell is sampled ahead of raising the
+ * wait flag, so a ring landing after the last check still cuts the sleep.
+ */
+static int _shm_wait(
+    shm_header_t* hdr,
+    atomic_uint*  pos,
+    uint32_t      seen,
+    atomic_uint*  wait,
+    atomic_uint*  bell,
+    uint64_t      deadline) {
+    for (int i = 0; i < SHM_SPIN; i++) {
+        if (atomic_load_explicit(pos, memory_order_acquire) != seen ||
+            atomic_load_explicit(&hdr->closed, memory_order_relaxed)) {
+            return 0;
+        }
+    }
+    while (true) {
+        int timeout_ms = _shm_remaining(deadline);
+        if (timeout_ms == 0) {
+            return -1;
+        }
+        unsigned int ring = atomic_load(bell);
+        atomic_store(wait, 1);
+
+        if (atomic_load(pos) != seen || atomic_load(&hdr->closed)) {
+            atomic_store(wait, 0);
+            return 0;
+        }
+        platform_shm_wait(bell, ring, timeout_ms);
+        atomic_store(wait, 0);
+    }
+}
+
+static void _shm_hangup(shm_header_t* hdr) {
+    atomic_store(&hdr->closed, 1);
+
+    for (int i = 0; i < 2; i++) {
+        atomic_fetch_add(&hdr->rings[i].rbell, 1);
+        platform_shm_wake(&hdr->rings[i].rbell);
+        atomic_fetch_add(&hdr->rings[i].wbell, 1);
+        platform_shm_wake(&hdr->rings[i].wbell);
+    }
+}
+
+static shm_header_t*
+_shm_region_create(const char* restrict name, uint32_t capacity, size_t* size) {
+    *size = sizeof(shm_header_t) + (size_t)capacity * 2;
+
+    shm_header_t* hdr = platform_shm_create(name, *size);
+    if (!hdr) {
+        return NULL;
+    }
+    memset(hdr, 0, sizeof(shm_header_t));
+    hdr->capacity = capacity;
+
+    /** a dialer takes the region only once the magic shows up. */
+    atomic_thread_fence(memory_order_release);
+    hdr->magic = SHM_MAGIC;
+    return hdr;
+}
+
+static bool _shm_region_valid(shm_header_t* hdr, size_t size) {
+    if (size < sizeof(shm_header_t) || hdr->magic != SHM_MAGIC) {
+        return false;
+    }
+    atomic_thread_fence(memory_order_acquire);
+
+    uint32_t capacity = hdr->capacity;
+    return capacity >= SHM_MIN_CAPACITY && capacity <= SHM_MAX_CAPACITY &&
+           (capacity & (capacity - 1)) == 0 &&
+           size >= sizeof(shm_header_t) + (size_t)capacity * 2;
+}
+
+static shm_connection_t* _shm_connection_create(void) {
+    shm_connection_t* conn = calloc(1, sizeof(shm_connection_t));
+    if (!conn) {
+        return NULL;
+    }
+    conn->handle.opaque = conn;
+    conn->sndtimeo      = -1;
+    conn->rcvtimeo      = -1;
+    return conn;
+}
+
+static void _shm_connection_attach(
+    shm_connection_t* conn, shm_header_t* hdr, size_t size, bool dialer) {
+    char*    data     = (char*)(hdr + 1);
+    uint32_t capacity = hdr->capacity;
+    int      tx       = dialer ? 0 : 1;
+
+    conn->hdr     = hdr;
+    conn->size    = size;
+    conn->mask    = capacity - 1;
+    conn->tx      = &hdr->rings[tx];
+    conn->txbuf   = data + (size_t)tx * capacity;
+    conn->tx_rpos = atomic_load(&conn->tx->rpos);
+    conn->rx      = &hdr->rings[1 - tx];
+    conn->rxbuf   = data + (size_t)(1 - tx) * capacity;
+    conn->rx_wpos = atomic_load(&conn->rx->wpos);
+}
+
+xcomm_shm_listener_t*
+xcomm_shm_listen(const char* restrict name, size_t capacity) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    if (capacity < SHM_MIN_CAPACITY) {
+        capacity = SHM_MIN_CAPACITY;
+    }
+    if (capacity > SHM_MAX_CAPACITY) {
+        capacity = SHM_MAX_CAPACITY;
+    }
+    shm_listener_t* listener = calloc(1, sizeof(shm_listener_t));
+    if (!listener) {
+        xcomm_loge("no memory.\n");
+        return NULL;
+    }
+    listener->handle.opaque = listener;
+    listener->capacity      = _shm_rounddown_pow_of_two((uint32_t)capacity);
+    listener->name          = strdup(name);
+    if (!listener->name) {
+        xcomm_loge("no memory.\n");
+        free(listener);
+        return NULL;
+    }
+    listener->hdr =
+        _shm_region_create(name, listener->capacity, &listener->size);
+    if (!listener->hdr) {
+        xcomm_loge("shm listen error.\n");
+        free(listener->name);
+        free(listener);
+        return NULL;
+    }
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+    return &listener->handle;
+}
+
+xcomm_shm_connection_t*
+xcomm_shm_accept(xcomm_shm_listener_t* listener, int timeout_ms) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    shm_listener_t* self     = listener->opaque;
+    uint64_t        deadline = _shm_deadline(timeout_ms);
+
+    if (!self->hdr) {
+        xcomm_loge("shm listener has no region.\n");
+        return NULL;
+    }
+    shm_connection_t* conn = _shm_connection_create();
+    if (!conn) {
+        xcomm_loge("no memory.\n");
+        return NULL;
+    }
+    while (atomic_load(&self->hdr->state) == SHM_STATE_LISTENING) {
+        int remaining = _shm_remaining(deadline);
+        if (remaining == 0) {
+            free(conn);
+            return NULL;
+        }
+        platform_shm_wait(&self->hdr->state, SHM_STATE_LISTENING, remaining);
+    }
+    _shm_connection_attach(conn, self->hdr, self->size, false);
+
+    /** the pair is private now, the name moves on to a fresh region. */
+    platform_shm_unlink(self->name);
+    self->hdr = _shm_region_create(self->name, self->capacity, &self->size);
+    if (!self->hdr) {
+        xcomm_loge("shm listen error.\n");
+    }
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+    return &conn->handle;
+}
+
+void xcomm_shm_close_listener(xcomm_shm_listener_t* listener) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    shm_listener_t* self = listener->opaque;
+
+    if (self->hdr) {
+        /** a dialer that got in ahead of close learns it was never accepted. */
+        atomic_store(&self->hdr->state, SHM_STATE_CLOSED);
+        _shm_hangup(self->hdr);
+        platform_shm_close(self->hdr, self->size);
+        platform_shm_unlink(self->name);
+    }
+    free(self->name);
+    free(self);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+}
+
+xcomm_shm_connection_t* xcomm_shm_dial(const char* restrict name, int timeout_ms) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    uint64_t deadline = _shm_deadline(timeout_ms);
+
+    shm_connection_t* conn = _shm_connection_create();
+    if (!conn) {
+        xcomm_loge("no memory.\n");
+        return NULL;
+    }
+    while (true) {
+        size_t        size;
+        shm_header_t* hdr = platform_shm_open(name, &size);
+
+        if (hdr) {
+            unsigned int state = SHM_STATE_LISTENING;
+
+            if (_shm_region_valid(hdr, size) &&
+                atomic_compare_exchange_strong(
+                    &hdr->state, &state, SHM_STATE_CONNECTED)) {
+                platform_shm_wake(&hdr->state);
+                _shm_connection_attach(conn, hdr, size, true);
+                break;
+            }
+            platform_shm_close(hdr, size);
+        }
+        /** the listener may be between two regions, or not up yet. */
+        if (_shm_remaining(deadline) == 0) {
+            xcomm_loge("shm dial error.\n");
+            free(conn);
+            return NULL;
+        }
+        thrd_sleep(&(struct timespec){.tv_sec = 0, .tv_nsec = 1000000}, NULL);
+    }
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+    return &conn->handle;
+}
+
+int xcomm_shm_send(xcomm_shm_connection_t* conn, const void* buf, size_t len) {
+    shm_connection_t* self = conn->opaque;
+    uint32_t          cap  = self->mask + 1;
+
+    if (len > cap - sizeof(uint32_t)) {
+        xcomm_loge("shm message too large.\n");
+        return -1;
+    }
+    uint32_t need = (uint32_t)(len + sizeof(uint32_t));
+    uint32_t wpos = atomic_load_explicit(&self->tx->wpos, memory_order_relaxed);
+
+    if (cap - (wpos - self->tx_rpos) < need) {
+        uint64_t deadline = _shm_deadline(self->sndtimeo);
+
+        while (true) {
+            uint32_t rpos =
+                atomic_load_explicit(&self->tx->rpos, memory_order_acquire);
+            if (rpos != self->tx_rpos) {
+                self->tx_rpos = rpos;
+                if (cap - (wpos - rpos) >= need) {
+                    break;
+                }
+            }
+            if (atomic_load(&self->hdr->closed)) {
+                return -1;
+            }
+            if (_shm_wait(
+                    self->hdr,
+                    &self->tx->rpos,
+                    rpos,
+                    &self->tx->wwait,
+                    &self->tx->wbell,
+                    deadline)) {
+                return -1;
+            }
+        }
+    }
+    if (atomic_load_explicit(&self->hdr->closed, memory_order_relaxed)) {
+        return -1;
+    }
+    uint32_t msglen = (uint32_t)len;
+    _shm_copy_in(self->txbuf, self->mask, wpos, &msglen, sizeof(uint32_t));
+    _shm_copy_in(
+        self->txbuf, self->mask, wpos + sizeof(uint32_t), buf, (uint32_t)len);
+
+    atomic_store(&self->tx->wpos, wpos + need);
+    _shm_ring(&self->tx->rwait, &self->tx->rbell);
+    return 0;
+}
+
+int64_t xcomm_shm_recv(xcomm_shm_connection_t* conn, void* buf, size_t len) {
+    shm_connection_t* self = conn->opaque;
+    uint32_t          rpos =
+        atomic_load_explicit(&self->rx->rpos, memory_order_relaxed);
+
+    if (self->rx_wpos == rpos) {
+        uint64_t deadline = _shm_deadline(self->rcvtimeo);
+
+        while (true) {
+            self->rx_wpos =
+                atomic_load_explicit(&self->rx->wpos, memory_order_acquire);
+            if (self->rx_wpos != rpos) {
+                break;
+            }
+            /** whatever the peer sent before closing is still delivered. */
+            if (atomic_load(&self->hdr->closed)) {
+                return 0;
+            }
+            if (_shm_wait(
+                    self->hdr,
+                    &self->rx->wpos,
+                    rpos,
+                    &self->rx->rwait,
+                    &self->rx->rbell,
+                    deadline)) {
+                return -1;
+            }
+        }
+    }
+    uint32_t msglen;
+    _shm_copy_out(&msglen, self->rxbuf, self->mask, rpos, sizeof(uint32_t));
+
+    /** the peer maps the region too, a length past what it wrote is garbage. */
+    if (msglen > self->mask + 1 - sizeof(uint32_t) ||
+        msglen + sizeof(uint32_t) > self->rx_wpos - rpos) {
+        xcomm_loge("shm message length corrupted.\n");
+        _shm_hangup(self->hdr);
+        return -1;
+    }
+    if (msglen > len) {
+        return msglen;
+    }
+    _shm_copy_out(buf, self->rxbuf, self->mask, rpos + sizeof(uint32_t), msglen);
+
+    atomic_store(&self->rx->rpos, rpos + (uint32_t)sizeof(uint32_t) + msglen);
+    _shm_ring(&self->rx->wwait, &self->rx->wbell);
+    return msglen;
+}
+
+void xcomm_shm_close_connection(xcomm_shm_connection_t* conn) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    shm_connection_t* self = conn->opaque;
+
+    _shm_hangup(self->hdr);
+    platform_shm_close(self->hdr, self->size);
+    free(self);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+}
+
+void xcomm_shm_set_sndtimeo(xcomm_shm_connection_t* conn, int timeout_ms) {
+    shm_connection_t* self = conn->opaque;
+    self->sndtimeo = (timeout_ms > 0) ? timeout_ms : -1;
+}
+
+void xcomm_shm_set_rcvtimeo(xcomm_shm_connection_t* conn, int timeout_ms) {
+    shm_connection_t* self = conn->opaque;
+    self->rcvtimeo = (timeout_ms > 0) ? timeout_ms : -1;
+}
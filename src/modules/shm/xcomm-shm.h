@@ -0,0 +1,99 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+_Pragma("once")
+
+#include "xcomm/xcomm-shm-module.h"
+#include "platform/platform-types.h"
+
+#define SHM_MAGIC        0x58534D31
+#define SHM_MIN_CAPACITY 4096
+#define SHM_MAX_CAPACITY (1U << 30)
+#define SHM_SPIN         1024
+#define SHM_CACHELINE    64
+
+typedef struct shm_ring_s       shm_ring_t;
+typedef struct shm_header_s     shm_header_t;
+typedef struct shm_listener_s   shm_listener_t;
+typedef struct shm_connection_s shm_connection_t;
+
+enum {
+    SHM_STATE_LISTENING = 0,
+    SHM_STATE_CONNECTED = 1,
+    SHM_STATE_CLOSED    = 2,
+};
+
+/**
+ * lives in shared memory. the producer owns the first line, the consumer the
+ * second, a side sleeps on the bell the other one rings when it sees the
+ * wait flag raised.
+ */
+struct shm_ring_s {
+    _Alignas(SHM_CACHELINE) atomic_uint wpos;
+    atomic_uint                         wwait;
+    atomic_uint                         rbell;
+    _Alignas(SHM_CACHELINE) atomic_uint rpos;
+    atomic_uint                         rwait;
+    atomic_uint                         wbell;
+};
+
+/** rings[0] carries dialer to listener, rings[1] the way back. */
+struct shm_header_s {
+    uint32_t    magic;
+    uint32_t    capacity;
+    atomic_uint state;
+    atomic_uint closed;
+    shm_ring_t  rings[2];
+};
+
+struct shm_listener_s {
+    xcomm_shm_listener_t handle;
+    char*                name;
+    uint32_t             capacity;
+    shm_header_t*        hdr;
+    size_t               size;
+};
+
+/** the cached positions spare a load of the line the peer keeps writing. */
+struct shm_connection_s {
+    xcomm_shm_connection_t handle;
+    shm_header_t*          hdr;
+    size_t                 size;
+    shm_ring_t*            tx;
+    char*                  txbuf;
+    uint32_t               tx_rpos;
+    shm_ring_t*            rx;
+    char*                  rxbuf;
+    uint32_t               rx_wpos;
+    uint32_t               mask;
+    int                    sndtimeo;
+    int                    rcvtimeo;
+};
+
+extern xcomm_shm_listener_t* xcomm_shm_listen(const char* restrict name, size_t capacity);
+extern xcomm_shm_connection_t* xcomm_shm_accept(xcomm_shm_listener_t* listener, int timeout_ms);
+extern void xcomm_shm_close_listener(xcomm_shm_listener_t* listener);
+extern xcomm_shm_connection_t* xcomm_shm_dial(const char* restrict name, int timeout_ms);
+extern int xcomm_shm_send(xcomm_shm_connection_t* conn, const void* buf, size_t len);
+extern int64_t xcomm_shm_recv(xcomm_shm_connection_t* conn, void* buf, size_t len);
+extern void xcomm_shm_close_connection(xcomm_shm_connection_t* conn);
+extern void xcomm_shm_set_sndtimeo(xcomm_shm_connection_t* conn, int timeout_ms);
+extern void xcomm_shm_set_rcvtimeo(xcomm_shm_connection_t* conn, int timeout_ms);
@@ -19,7 +19,2438 @@
  *  IN THE SOFTWARE.
  */
 
+#include <limits.h>
+
+#include "xcomm-utils.h"
+#include "xcomm-logger.h"
+#include "xcomm-engine.h"
 #include "xcomm-async-tcp.h"
+#include "xcomm-tcp-eyeballs.h"
+#include "xcomm-tcp-sockopts.h"
+#include "xcomm-event-routine.h"
+#include "platform/platform-io.h"
+#include "platform/platform-info.h"
+#include "platform/platform-socket.h"
+
+typedef struct async_tcp_dial_context_s    async_tcp_dial_context_t;
+typedef struct async_tcp_dial_attempt_s    async_tcp_dial_attempt_t;
+typedef struct async_tcp_listen_context_s  async_tcp_listen_context_t;
+typedef struct async_tcp_accept_batch_s    async_tcp_accept_batch_t;
+typedef struct async_tcp_option_context_s  async_tcp_option_context_t;
+typedef struct async_tcp_checkout_context_s async_tcp_checkout_context_t;
+typedef struct async_tcp_relay_s            async_tcp_relay_t;
+typedef struct async_tcp_relay_end_s        async_tcp_relay_end_t;
+typedef struct async_tcp_relay_dir_s        async_tcp_relay_dir_t;
+typedef struct async_tcp_stats_context_s    async_tcp_stats_context_t;
+
+struct async_tcp_dial_attempt_s {
+    platform_sock_t           sock;
+    xcomm_event_io_t          io;
+    async_tcp_dial_context_t* context;
+};
+
+struct async_tcp_dial_context_s {
+    char*                    host;
+    char*                    port;
+    int                      timeout_ms;
+    async_tcp_connection_t*  conn;
+    xcomm_resolver_addrs_t   addrs;
+    int                      next;
+    int                      inflight;
+    int                      err;
+    bool                     done;
+    xcomm_event_timer_t*     stagger_timer;
+    xcomm_event_timer_t*     deadline_timer;
+    async_tcp_dial_attempt_t attempts[XCOMM_RESOLVER_MAXADDRS];
+};
+
+struct async_tcp_listen_context_s {
+    char*                 host;
+    char*                 port;
+    xcomm_tcp_listen_cb_t listen_cb;
+    void*                 userdata;
+    async_tcp_listener_t* listener;
+};
+
+struct async_tcp_accept_batch_s {
+    xcomm_event_loop_t*   loop;
+    xcomm_tcp_accept_cb_t accept_cb;
+    void*                 userdata;
+    tcp_tls_t*            tls;
+    xcomm_list_t          conns;
+    xcomm_list_node_t     node;
+};
+
+struct async_tcp_option_context_s {
+    async_tcp_connection_t* conn;
+    int                     value;
+    void*                   ptr;
+};
+
+struct async_tcp_stats_context_s {
+    async_tcp_connection_t* conn;
+    xcomm_event_loop_t*     loop;
+    xcomm_tcp_stats_cb_t    stats_cb;
+    void*                   userdata;
+};
+
+struct async_tcp_checkout_context_s {
+    tcp_pool_key_t*         key;
+    async_tcp_connection_t* conn;
+    xcomm_tcp_connect_cb_t  connect_cb;
+    void*                   userdata;
+    xcomm_list_node_t       node;
+};
+
+/**
+ * bytes of one direction wait in a pipe, or without splice in buf starting
+ * at off. the direction is done once the source hit eof and all it sent was
+ * passed on, the write side of the destination is shut down then.
+ */
+struct async_tcp_relay_dir_s {
+    int      pipe[2];
+    char*    buf;
+    size_t   off;
+    size_t   pending;
+    bool     eof;
+    bool     done;
+    uint64_t bytes;
+};
+
+/**
+ * unsent holds what the connection had queued for this end and unread what
+ * it had received from it without delivering, both are carried into the
+ * directions ahead of any relayed byte.
+ */
+struct async_tcp_relay_end_s {
+    async_tcp_relay_t*      relay;
+    async_tcp_connection_t* conn;
+    platform_sock_t         sock;
+    xcomm_event_io_t        io;
+    platform_poller_op_t    op;
+    bool                    registered;
+    int                     err;
+    char*                   unsent;
+    size_t                  unsentlen;
+    char*                   unread;
+    size_t                  unreadlen;
+};
+
+/** dirs[i] carries what ends[i] receives over to ends[1 - i]. */
+struct async_tcp_relay_s {
+    xcomm_event_loop_t*        loop;
+    async_tcp_relay_end_t      ends[2];
+    async_tcp_relay_dir_t      dirs[2];
+    atomic_int                 detached;
+    bool                       finished;
+    xcomm_tcp_relay_close_cb_t close_cb;
+    void*                      close_ud;
+};
+
+static void _async_tcp_connection_io_cb(void* param, platform_poller_op_t op);
+static void _async_tcp_pool_release(async_tcp_connection_t* conn);
+static bool _async_tcp_pool_idle(async_tcp_connection_t* conn);
+static void _async_tcp_tls_start(async_tcp_connection_t* conn);
+
+static void _async_tcp_dispatch(
+    xcomm_event_loop_t* loop, void (*routine)(void*), void* param) {
+    if (thrd_equal(loop->tid, thrd_current())) {
+        routine(param);
+    } else {
+        xcomm_event_routine_add(loop, routine, param);
+    }
+}
+
+static tcp_sockopts_default_t async_tcp_sockopts;
+
+static async_tcp_worker_t* async_tcp_workers;
+static int                 async_tcp_nworkers;
+
+/**
+ * one connection slab per worker, warmed up front so that connection churn
+ * on a worker is served from memory that worker already owns. called by the
+ * engine before the workers start.
+ */
+void xcomm_async_tcp_startup(int concurrency) {
+    async_tcp_workers = calloc(concurrency, sizeof(async_tcp_worker_t));
+    if (!async_tcp_workers) {
+        xcomm_loge("no memory.\n");
+        return;
+    }
+    for (int i = 0; i < concurrency; i++) {
+        async_tcp_worker_t* worker = &async_tcp_workers[i];
+
+        xcomm_slab_init(
+            &worker->slab,
+            sizeof(async_tcp_connection_t),
+            ASYNC_TCP_SLAB_CHUNK);
+        xcomm_slab_reserve(&worker->slab, ASYNC_TCP_SLAB_WARMUP);
+
+        for (int j = 0; j < ASYNC_TCP_IDLE_WHEEL; j++) {
+            xcomm_list_init(&worker->wheel[j]);
+        }
+        xcomm_list_init(&worker->conns);
+    }
+    async_tcp_nworkers = concurrency;
+}
+
+/** called by the engine once every worker loop has returned. */
+void xcomm_async_tcp_cleanup(void) {
+    for (int i = 0; i < async_tcp_nworkers; i++) {
+        xcomm_slab_destroy(&async_tcp_workers[i].slab);
+    }
+    free(async_tcp_workers);
+
+    async_tcp_workers  = NULL;
+    async_tcp_nworkers = 0;
+}
+
+static async_tcp_worker_t* _async_tcp_worker_get(xcomm_event_loop_t* loop) {
+    engine_worker_t* worker =
+        (engine_worker_t*)((char*)loop - offsetof(engine_worker_t, looper));
+
+    if (worker->idx >= async_tcp_nworkers) {
+        return NULL;
+    }
+    return &async_tcp_workers[worker->idx];
+}
+
+/** called on the worker thread after its loop returned, before it goes. */
+void xcomm_async_tcp_worker_exit(xcomm_event_loop_t* loop) {
+    async_tcp_worker_t* worker = _async_tcp_worker_get(loop);
+
+    if (worker && worker->sweep_timer) {
+        xcomm_event_timer_del(loop, worker->sweep_timer);
+        worker->sweep_timer = NULL;
+    }
+}
+
+static async_tcp_connection_t* _async_tcp_connection_create(
+    platform_sock_t sock, xcomm_event_loop_t* loop) {
+    async_tcp_worker_t* worker = _async_tcp_worker_get(loop);
+    if (!worker) {
+        return NULL;
+    }
+    async_tcp_connection_t* conn = xcomm_slab_alloc(&worker->slab);
+    if (!conn) {
+        return NULL;
+    }
+    memset(conn, 0, sizeof(async_tcp_connection_t));
+
+    conn->handle.opaque = conn;
+    conn->sock          = sock;
+    conn->loop          = loop;
+    conn->worker        = worker;
+
+    atomic_init(&conn->backpressure.low, ASYNC_TCP_SEND_LOW_WATERMARK);
+    atomic_init(&conn->backpressure.high, ASYNC_TCP_SEND_HIGH_WATERMARK);
+
+    xcomm_list_init(&conn->sendq);
+    xcomm_list_init(&conn->zerocopy.inflight);
+    return conn;
+}
+
+/** unix domain sockets have no tcp level options to apply. */
+static void _async_tcp_connection_sockopts(
+    async_tcp_connection_t* conn, const xcomm_tcp_sockopts_t* opts) {
+    if (conn->local) {
+        return;
+    }
+    xcomm_tcp_sockopts_apply(conn->sock, opts);
+    conn->quickack = opts && opts->quickack;
+}
+
+static void _async_tcp_connection_default_sockopts(
+    async_tcp_connection_t* conn) {
+    xcomm_tcp_sockopts_t storage;
+
+    _async_tcp_connection_sockopts(
+        conn, xcomm_tcp_sockopts_load(&async_tcp_sockopts, &storage));
+}
+
+static void _async_tcp_connection_free(void* param) {
+    async_tcp_connection_t* conn = param;
+
+    if (conn) {
+        if (conn->offload.busy) {
+            conn->offload.orphaned = true;
+            return;
+        }
+        if (conn->tls) {
+            xcomm_tcp_tls_conn_destroy(conn->tls);
+        }
+        xcomm_slab_free(&conn->worker->slab, conn);
+    }
+}
+
+static void _async_tcp_packetizer_free(void* param) {
+    xcomm_tcp_packetizer_destroy(param);
+    free(param);
+}
+
+/** activity stamps in milliseconds, from the clock the loop took on wakeup. */
+static inline uint64_t _async_tcp_clock(async_tcp_connection_t* conn) {
+    return conn->loop->now / 1000;
+}
+
+static void _async_tcp_send_req_complete(async_tcp_send_req_t* req) {
+    async_tcp_connection_t* conn = req->conn;
+
+    size_t pending =
+        atomic_fetch_sub(&conn->backpressure.pending, req->len) - req->len;
+    uint64_t now = conn->loop->now;
+
+    conn->stats.sends++;
+    if (now > req->queued) {
+        conn->stats.queue_time_us += now - req->queued;
+    }
+    if (conn->send_completed_cb) {
+        conn->send_completed_cb(
+            &conn->handle, req->buf, req->len, conn->send_completed_ud);
+    }
+    free(req);
+
+    if (!conn->closed && pending <= atomic_load(&conn->backpressure.low) &&
+        atomic_load(&conn->backpressure.throttled) &&
+        atomic_exchange(&conn->backpressure.throttled, false)) {
+        if (conn->writable_cb) {
+            conn->writable_cb(&conn->handle, conn->writable_ud);
+        }
+    }
+}
+
+static void _async_tcp_writable(void* param) {
+    async_tcp_connection_t* conn = param;
+
+    if (!conn->closed && conn->writable_cb) {
+        conn->writable_cb(&conn->handle, conn->writable_ud);
+    }
+}
+
+static void _async_tcp_send_req_release(xcomm_list_t* list) {
+    while (!xcomm_list_empty(list)) {
+        xcomm_list_node_t* node = xcomm_list_head(list);
+        xcomm_list_remove(node);
+
+        _async_tcp_send_req_complete(
+            xcomm_list_data(node, async_tcp_send_req_t, node));
+    }
+}
+
+static void _async_tcp_idle_unlink(async_tcp_connection_t* conn) {
+    if (conn->idle.linked) {
+        xcomm_list_remove(&conn->idle.node);
+        conn->idle.linked = false;
+        conn->worker->nidle--;
+    }
+}
+
+static uint64_t _async_tcp_idle_deadline(async_tcp_connection_t* conn) {
+    uint64_t now      = conn->worker->now;
+    uint64_t deadline = UINT64_MAX;
+
+    if (conn->idle.recvtimeo > 0) {
+        deadline = conn->idle.last_recv + conn->idle.recvtimeo;
+    }
+    if (conn->idle.sendtimeo > 0) {
+        /** nothing queued, look again one period later. */
+        uint64_t since = xcomm_list_empty(&conn->sendq) ? now
+                                                        : conn->idle.last_send;
+        if (since + conn->idle.sendtimeo < deadline) {
+            deadline = since + conn->idle.sendtimeo;
+        }
+    }
+    if (conn->idle.heartbeat_interval > 0) {
+        uint64_t last = conn->idle.last_recv;
+        if (conn->idle.last_send > last) {
+            last = conn->idle.last_send;
+        }
+        if (conn->idle.last_heartbeat > last) {
+            last = conn->idle.last_heartbeat;
+        }
+        if (last + conn->idle.heartbeat_interval < deadline) {
+            deadline = last + conn->idle.heartbeat_interval;
+        }
+    }
+    return deadline;
+}
+
+static void _async_tcp_idle_sweep(void* param);
+
+/**
+ * the sweep is a one shot timer armed again by every sweep that leaves
+ * connections in the wheel, a worker without any does not wake up.
+ */
+static void _async_tcp_worker_tick(
+    async_tcp_worker_t* worker, xcomm_event_loop_t* loop) {
+    if (!worker->sweep_timer) {
+        worker->now  = xcomm_utils_getclock(XCOMM_TIME_PRECISION_MSEC);
+        worker->tick = worker->now / ASYNC_TCP_IDLE_TICK;
+        worker->sweep_timer = xcomm_event_timer_add(
+            loop, _async_tcp_idle_sweep, worker, ASYNC_TCP_IDLE_TICK, false);
+    }
+}
+
+static void _async_tcp_idle_link(async_tcp_connection_t* conn) {
+    async_tcp_worker_t* worker = conn->worker;
+
+    _async_tcp_idle_unlink(conn);
+
+    if (conn->idle.recvtimeo <= 0 && conn->idle.sendtimeo <= 0 &&
+        conn->idle.heartbeat_interval <= 0) {
+        return;
+    }
+    _async_tcp_worker_tick(worker, conn->loop);
+
+    /** deadlines past the wheel horizon are simply looked at again later. */
+    uint64_t tick = _async_tcp_idle_deadline(conn) / ASYNC_TCP_IDLE_TICK;
+    if (tick <= worker->tick) {
+        tick = worker->tick + 1;
+    }
+    if (tick - worker->tick >= ASYNC_TCP_IDLE_WHEEL) {
+        tick = worker->tick + ASYNC_TCP_IDLE_WHEEL - 1;
+    }
+    xcomm_list_insert_tail(
+        &worker->wheel[tick % ASYNC_TCP_IDLE_WHEEL], &conn->idle.node);
+    conn->idle.linked = true;
+    worker->nidle++;
+}
+
+static void _async_tcp_stats_link(async_tcp_connection_t* conn) {
+    xcomm_list_insert_tail(&conn->worker->conns, &conn->stats.node);
+    conn->stats.linked = true;
+}
+
+static void _async_tcp_stats_unlink(async_tcp_connection_t* conn) {
+    if (conn->stats.linked) {
+        xcomm_list_remove(&conn->stats.node);
+        conn->stats.linked = false;
+    }
+}
+
+static void _async_tcp_connection_close(async_tcp_connection_t* conn);
+
+/**
+ * best effort close_notify. skipped while ciphertext is still due, it would
+ * land in the middle of a record. under ktls the kernel seals the alert.
+ */
+static void _async_tcp_tls_shutdown(async_tcp_connection_t* conn) {
+    char* out;
+
+    if (xcomm_tcp_tls_conn_ktls(conn->tls) == TCP_TLS_KTLS_ACTIVE) {
+        char alert[2] = {1, 0};
+
+        xcomm_tcp_tls_conn_shutdown(conn->tls);
+        platform_socket_send_record(
+            conn->sock, TCP_TLS_ALERT_RECORD, alert, sizeof(alert));
+        return;
+    }
+    if (xcomm_tcp_tls_conn_output(conn->tls, &out) > 0) {
+        return;
+    }
+    xcomm_tcp_tls_conn_shutdown(conn->tls);
+
+    size_t len = xcomm_tcp_tls_conn_output(conn->tls, &out);
+    if (len > 0) {
+        platform_socket_send(conn->sock, out, (int)len);
+    }
+}
+
+static void _async_tcp_idle_check(async_tcp_connection_t* conn) {
+    uint64_t now = conn->worker->now;
+
+    if (conn->idle.recvtimeo > 0 &&
+        now - conn->idle.last_recv >= (uint64_t)conn->idle.recvtimeo) {
+        xcomm_logw("tcp recv timeout.\n");
+        _async_tcp_connection_close(conn);
+        return;
+    }
+    if (conn->idle.sendtimeo > 0 && !xcomm_list_empty(&conn->sendq) &&
+        now - conn->idle.last_send >= (uint64_t)conn->idle.sendtimeo) {
+        xcomm_logw("tcp send timeout.\n");
+        _async_tcp_connection_close(conn);
+        return;
+    }
+    if (conn->idle.heartbeat_interval > 0 &&
+        _async_tcp_idle_deadline(conn) <= now) {
+        conn->idle.last_heartbeat = now;
+        if (conn->heartbeat_cb) {
+            conn->heartbeat_cb(&conn->handle, conn->heartbeat_ud);
+        }
+        if (conn->closed) {
+            return;
+        }
+    }
+    _async_tcp_idle_link(conn);
+}
+
+static void _async_tcp_idle_sweep(void* param) {
+    async_tcp_worker_t* worker = param;
+    xcomm_event_loop_t* loop   = worker->sweep_timer->event.loop;
+
+    worker->now = xcomm_utils_getclock(XCOMM_TIME_PRECISION_MSEC);
+
+    uint64_t target = worker->now / ASYNC_TCP_IDLE_TICK;
+    if (target - worker->tick > ASYNC_TCP_IDLE_WHEEL) {
+        worker->tick = target - ASYNC_TCP_IDLE_WHEEL;
+    }
+    while (worker->tick < target) {
+        worker->tick++;
+
+        xcomm_list_t due;
+        xcomm_list_init(&due);
+        xcomm_list_swap(
+            &due, &worker->wheel[worker->tick % ASYNC_TCP_IDLE_WHEEL]);
+
+        /** callbacks may close any connection, so always take the head. */
+        while (!xcomm_list_empty(&due)) {
+            async_tcp_connection_t* conn = xcomm_list_data(
+                xcomm_list_head(&due), async_tcp_connection_t, idle.node);
+
+            xcomm_list_remove(&conn->idle.node);
+            conn->idle.linked = false;
+            worker->nidle--;
+
+            _async_tcp_idle_check(conn);
+        }
+    }
+    /** the running timer frees itself once this returns. */
+    worker->sweep_timer = NULL;
+    if (worker->nidle > 0) {
+        worker->sweep_timer = xcomm_event_timer_add(
+            loop, _async_tcp_idle_sweep, worker, ASYNC_TCP_IDLE_TICK, false);
+    }
+}
+
+static void _async_tcp_connection_close(async_tcp_connection_t* conn) {
+    if (conn->closed) {
+        return;
+    }
+    conn->closed = true;
+
+    if (conn->pool.key) {
+        _async_tcp_pool_release(conn);
+    }
+    _async_tcp_idle_unlink(conn);
+    _async_tcp_stats_unlink(conn);
+
+    if (conn->registered) {
+        xcomm_event_io_del(conn->loop, &conn->io);
+        conn->registered = false;
+    }
+    if (conn->tls && conn->connected) {
+        _async_tcp_tls_shutdown(conn);
+    }
+    /** a relay may have taken the socket over. */
+    if (conn->sock != PLATFORM_SO_ERROR_INVALID_SOCKET) {
+        platform_socket_close(conn->sock);
+    }
+
+    _async_tcp_send_req_release(&conn->zerocopy.inflight);
+    _async_tcp_send_req_release(&conn->sendq);
+
+    if (conn->packetizer) {
+        xcomm_event_routine_add(
+            conn->loop, _async_tcp_packetizer_free, conn->packetizer);
+        conn->packetizer = NULL;
+    }
+
+    if (conn->connected && conn->close_cb) {
+        conn->close_cb(&conn->handle, conn->close_ud);
+    }
+    /** a dial that dies in the tls handshake still owes its connect_cb. */
+    if (!conn->connected && conn->tls && !xcomm_tcp_tls_conn_server(conn->tls) &&
+        conn->connect_cb) {
+        int err = PLATFORM_SO_ERROR_ECONNABORTED;
+        conn->connect_cb(
+            NULL, err, platform_socket_tostring(err), conn->connect_ud);
+    }
+    /**
+     * the io event may still sit in the current completion batch, so the
+     * memory is released on the next loop iteration.
+     */
+    xcomm_event_routine_add(conn->loop, _async_tcp_connection_free, conn);
+}
+
+static void _async_tcp_connect_established(async_tcp_connection_t* conn) {
+    _async_tcp_connection_default_sockopts(conn);
+
+    xcomm_event_io_add(
+        conn->loop,
+        &conn->io,
+        (platform_poller_fd_t)conn->sock,
+        PLATFORM_POLLER_RD_OP,
+        _async_tcp_connection_io_cb,
+        conn);
+    conn->registered = true;
+    _async_tcp_stats_link(conn);
+
+    if (conn->tls) {
+        _async_tcp_tls_start(conn);
+        return;
+    }
+    conn->connected = true;
+
+    if (conn->connect_cb) {
+        conn->connect_cb(
+            &conn->handle, 0, platform_socket_tostring(0), conn->connect_ud);
+    }
+}
+
+static void _async_tcp_reap_zerocopy(async_tcp_connection_t* conn) {
+    xcomm_list_t done;
+    uint32_t     lo;
+    uint32_t     hi;
+    bool         copied;
+
+    xcomm_list_init(&done);
+
+    while (platform_socket_recv_zerocopy(conn->sock, &lo, &hi, &copied) == 1) {
+        /** notifications carry the low 32 bits of the send counter. */
+        uint64_t first =
+            conn->zerocopy.next_id - (uint32_t)((uint32_t)conn->zerocopy.next_id - lo);
+        uint64_t last = first + (uint32_t)(hi - lo);
+
+        if (copied) {
+            conn->zerocopy.enabled = false;
+        }
+        xcomm_list_t* lists[2] = {&conn->zerocopy.inflight, &conn->sendq};
+        for (int i = 0; i < 2; i++) {
+            xcomm_list_node_t* node = xcomm_list_head(lists[i]);
+            while (node != xcomm_list_sentinel(lists[i])) {
+                async_tcp_send_req_t* req =
+                    xcomm_list_data(node, async_tcp_send_req_t, node);
+                node = xcomm_list_next(node);
+
+                if (!req->zc_count) {
+                    continue;
+                }
+                uint64_t req_last = req->zc_first + req->zc_count - 1;
+                if (req_last < first || req->zc_first > last) {
+                    continue;
+                }
+                uint64_t lo64 = req->zc_first > first ? req->zc_first : first;
+                uint64_t hi64 = req_last < last ? req_last : last;
+                req->zc_done += hi64 - lo64 + 1;
+            }
+        }
+    }
+    /** inflight is in send order, complete only its finished prefix. */
+    while (!xcomm_list_empty(&conn->zerocopy.inflight)) {
+        async_tcp_send_req_t* req = xcomm_list_data(
+            xcomm_list_head(&conn->zerocopy.inflight), async_tcp_send_req_t, node);
+        if (req->zc_done < req->zc_count) {
+            break;
+        }
+        xcomm_list_remove(&req->node);
+        xcomm_list_insert_tail(&done, &req->node);
+    }
+    _async_tcp_send_req_release(&done);
+}
+
+static bool _async_tcp_tls_userspace(async_tcp_connection_t* conn) {
+    return conn->tls &&
+           xcomm_tcp_tls_conn_ktls(conn->tls) != TCP_TLS_KTLS_ACTIVE;
+}
+
+static bool _async_tcp_has_output(async_tcp_connection_t* conn) {
+    char* out;
+
+    if (conn->tls && !_async_tcp_tls_userspace(conn) &&
+        xcomm_tcp_tls_conn_ktls_due(conn->tls)) {
+        return true;
+    }
+    return !xcomm_list_empty(&conn->sendq) ||
+           (_async_tcp_tls_userspace(conn) && !conn->offload.busy &&
+            xcomm_tcp_tls_conn_output(conn->tls, &out) > 0);
+}
+
+static void _async_tcp_flush(async_tcp_connection_t* conn);
+
+/**
+ * plaintext is encrypted from the head of the send queue one chunk at a time
+ * and only once the previous ciphertext reached the socket, a request
+ * completes when the last of its records went out. a pending ktls switch
+ * happens at the first point where no ciphertext is left, the rest of the
+ * queue then goes out as plaintext for the kernel to seal.
+ */
+static void _async_tcp_tls_flush(async_tcp_connection_t* conn) {
+    while (true) {
+        char*  out;
+        size_t len = xcomm_tcp_tls_conn_output(conn->tls, &out);
+
+        if (len > 0) {
+            int     size = len > INT_MAX ? INT_MAX : (int)len;
+            ssize_t n    = platform_socket_send(conn->sock, out, size);
+            if (n == PLATFORM_SO_ERROR_SOCKET_ERROR) {
+                int err = platform_socket_get_lasterror();
+                if (err == PLATFORM_SO_ERROR_EAGAIN ||
+                    err == PLATFORM_SO_ERROR_EWOULDBLOCK) {
+                    xcomm_event_io_mod(
+                        conn->loop, &conn->io, PLATFORM_POLLER_RW_OP);
+                    return;
+                }
+                xcomm_loge("tcp send error: %s.\n", platform_socket_tostring(err));
+                _async_tcp_connection_close(conn);
+                return;
+            }
+            xcomm_tcp_tls_conn_consume(conn->tls, (size_t)n);
+            conn->idle.last_send  = _async_tcp_clock(conn);
+            conn->stats.bytes_out += n;
+            continue;
+        }
+        async_tcp_send_req_t* req = NULL;
+
+        if (!xcomm_list_empty(&conn->sendq)) {
+            req = xcomm_list_data(
+                xcomm_list_head(&conn->sendq), async_tcp_send_req_t, node);
+        }
+        if (req && req->off == req->len) {
+            xcomm_list_remove(&req->node);
+            _async_tcp_send_req_complete(req);
+            if (conn->closed) {
+                return;
+            }
+            continue;
+        }
+        if (xcomm_tcp_tls_conn_ktls(conn->tls) == TCP_TLS_KTLS_PENDING &&
+            xcomm_tcp_tls_conn_ktls_enable(conn->tls, conn->sock)) {
+            _async_tcp_flush(conn);
+            return;
+        }
+        if (!req) {
+            break;
+        }
+        size_t remain = req->len - req->off;
+        int    size   = remain > TCP_TLS_WRITE_CHUNK ? TCP_TLS_WRITE_CHUNK
+                                                     : (int)remain;
+
+        if (req->file) {
+            /** userspace tls has to see the file, one record at a time. */
+            char    chunk[TCP_TLS_RECORD];
+            ssize_t n = platform_io_pread(
+                req->fd,
+                chunk,
+                remain > sizeof(chunk) ? sizeof(chunk) : remain,
+                req->foff + (int64_t)req->off);
+            if (n <= 0) {
+                xcomm_loge("tcp send file read error.\n");
+                _async_tcp_connection_close(conn);
+                return;
+            }
+            if (xcomm_tcp_tls_conn_write(conn->tls, chunk, (int)n)) {
+                _async_tcp_connection_close(conn);
+                return;
+            }
+            req->off += n;
+            continue;
+        }
+        if (xcomm_tcp_tls_conn_write(conn->tls, req->buf + req->off, size)) {
+            _async_tcp_connection_close(conn);
+            return;
+        }
+        req->off += size;
+    }
+    xcomm_event_io_mod(conn->loop, &conn->io, PLATFORM_POLLER_RD_OP);
+}
+
+static void _async_tcp_flush(async_tcp_connection_t* conn) {
+    /** MSG_ZEROCOPY does not combine with kernel tls. */
+    bool zerocopy = conn->zerocopy.enabled && !conn->tls;
+
+    if (_async_tcp_tls_userspace(conn)) {
+        _async_tcp_tls_flush(conn);
+        return;
+    }
+    /** a key update reply goes out ahead of the plaintext sealed after it. */
+    if (conn->tls) {
+        int rc = xcomm_tcp_tls_conn_ktls_update(conn->tls, conn->sock);
+        if (rc > 0) {
+            xcomm_event_io_mod(conn->loop, &conn->io, PLATFORM_POLLER_RW_OP);
+            return;
+        }
+        if (rc < 0) {
+            xcomm_loge("tls record can not be sent under ktls.\n");
+            _async_tcp_connection_close(conn);
+            return;
+        }
+    }
+
+    while (!xcomm_list_empty(&conn->sendq)) {
+        async_tcp_send_req_t* req = xcomm_list_data(
+            xcomm_list_head(&conn->sendq), async_tcp_send_req_t, node);
+
+        size_t  remain = req->len - req->off;
+        int     size   = remain > INT_MAX ? INT_MAX : (int)remain;
+        bool    zc     = zerocopy && !req->file &&
+                         remain >= ASYNC_TCP_ZEROCOPY_THRESHOLD;
+        ssize_t n;
+
+        if (req->file) {
+            n = platform_socket_sendfile(
+                conn->sock, req->fd, req->foff + (int64_t)req->off, remain);
+            if (n == 0) {
+                xcomm_loge("tcp send file ended early.\n");
+                _async_tcp_connection_close(conn);
+                return;
+            }
+        } else if (zc) {
+            n = platform_socket_send_zerocopy(conn->sock, req->buf + req->off, size);
+        } else {
+            n = platform_socket_send(conn->sock, req->buf + req->off, size);
+        }
+        if (n == PLATFORM_SO_ERROR_SOCKET_ERROR) {
+            int err = platform_socket_get_lasterror();
+            if (err == PLATFORM_SO_ERROR_EAGAIN ||
+                err == PLATFORM_SO_ERROR_EWOULDBLOCK) {
+                xcomm_event_io_mod(conn->loop, &conn->io, PLATFORM_POLLER_RW_OP);
+                return;
+            }
+            /** out of optmem for pinned pages, fall back to copying. */
+            if (zc && err == PLATFORM_SO_ERROR_ENOBUFS) {
+                zerocopy = false;
+                continue;
+            }
+            xcomm_loge("tcp send error: %s.\n", platform_socket_tostring(err));
+            _async_tcp_connection_close(conn);
+            return;
+        }
+        if (zc) {
+            if (!req->zc_count) {
+                req->zc_first = conn->zerocopy.next_id;
+            }
+            req->zc_count++;
+            conn->zerocopy.next_id++;
+        }
+        conn->idle.last_send  = _async_tcp_clock(conn);
+        conn->stats.bytes_out += n;
+
+        req->off += n;
+        if (req->off < req->len) {
+            continue;
+        }
+        xcomm_list_remove(&req->node);
+        /** a copied send must not complete ahead of a zerocopy one still pinned. */
+        if (req->zc_done < req->zc_count ||
+            !xcomm_list_empty(&conn->zerocopy.inflight)) {
+            xcomm_list_insert_tail(&conn->zerocopy.inflight, &req->node);
+            continue;
+        }
+        _async_tcp_send_req_complete(req);
+        if (conn->closed) {
+            return;
+        }
+    }
+    xcomm_event_io_mod(conn->loop, &conn->io, PLATFORM_POLLER_RD_OP);
+}
+
+static bool _async_tcp_frame_cb(void* param, void* frame, size_t len) {
+    async_tcp_connection_t* conn       = param;
+    tcp_packetizer_t*       packetizer = conn->packetizer;
+
+    if (conn->recv_cb) {
+        conn->recv_cb(&conn->handle, frame, len, conn->recv_ud);
+    }
+    /** stop when the callback closed the connection or swapped framers. */
+    return !conn->closed && conn->packetizer == packetizer;
+}
+
+static void _async_tcp_deliver(
+    async_tcp_connection_t* conn, char* buf, size_t len) {
+    while (len > 0 && conn->packetizer) {
+        ssize_t n = xcomm_tcp_packetizer_feed(
+            conn->packetizer, buf, len, _async_tcp_frame_cb, conn);
+        if (n < 0) {
+            xcomm_loge("tcp packetizer error, malformed frame.\n");
+            _async_tcp_connection_close(conn);
+            return;
+        }
+        if (conn->closed) {
+            return;
+        }
+        buf += n;
+        len -= n;
+    }
+    if (len > 0 && conn->recv_cb) {
+        conn->recv_cb(&conn->handle, buf, len, conn->recv_ud);
+    }
+}
+
+static void _async_tcp_tls_read(async_tcp_connection_t* conn) {
+    char plain[TCP_TLS_RECORD];
+
+    while (true) {
+        int n = xcomm_tcp_tls_conn_read(conn->tls, plain, sizeof(plain));
+        if (n < 0) {
+            _async_tcp_connection_close(conn);
+            return;
+        }
+        if (n == 0) {
+            break;
+        }
+        _async_tcp_deliver(conn, plain, (size_t)n);
+        if (conn->closed) {
+            return;
+        }
+    }
+    /** reading may have queued key update replies or alerts. */
+    if (_async_tcp_has_output(conn)) {
+        _async_tcp_flush(conn);
+    }
+}
+
+static void _async_tcp_tls_offload(async_tcp_connection_t* conn);
+
+static void _async_tcp_tls_handshake_done(void* param) {
+    async_tcp_connection_t* conn = param;
+
+    conn->offload.busy = false;
+    if (conn->closed) {
+        if (conn->offload.orphaned) {
+            _async_tcp_connection_free(conn);
+        }
+        return;
+    }
+    int rc     = conn->offload.rc;
+    int parked = xcomm_tcp_tls_conn_unstash(conn->tls);
+
+    /** whatever the handshake produced goes out, alerts included. */
+    _async_tcp_flush(conn);
+    if (conn->closed) {
+        return;
+    }
+    if (rc < 0 || parked < 0) {
+        _async_tcp_connection_close(conn);
+        return;
+    }
+    if (rc == 0) {
+        if (parked > 0) {
+            _async_tcp_tls_offload(conn);
+        }
+        return;
+    }
+    conn->idle.recvtimeo = 0;
+    _async_tcp_idle_link(conn);
+    conn->connected = true;
+
+    if (conn->connect_cb) {
+        conn->connect_cb(
+            &conn->handle, 0, platform_socket_tostring(0), conn->connect_ud);
+    }
+    /** the peer may have sent data right behind its last flight. */
+    if (!conn->closed) {
+        _async_tcp_tls_read(conn);
+    }
+}
+
+static void _async_tcp_tls_handshake(void* param) {
+    async_tcp_connection_t* conn = param;
+
+    conn->offload.rc = xcomm_tcp_tls_conn_handshake(conn->tls);
+    xcomm_event_routine_add(conn->loop, _async_tcp_tls_handshake_done, conn);
+}
+
+/**
+ * handshake steps are public key operations, they run on the engine crypto
+ * pool so a burst of handshakes does not stall other connections of the
+ * loop. the step owns the session until it is back on the loop. without
+ * memory for the job the step runs on the loop instead.
+ */
+static void _async_tcp_tls_offload(async_tcp_connection_t* conn) {
+    conn->offload.busy = true;
+    if (xcomm_thrdpool_post(engine.cryptopool(), _async_tcp_tls_handshake, conn)) {
+        _async_tcp_tls_handshake(conn);
+    }
+}
+
+/**
+ * connect_cb, or accept_cb on the server side, waits for the handshake,
+ * which is bounded by the recv timeout of the idle wheel.
+ */
+static void _async_tcp_tls_start(async_tcp_connection_t* conn) {
+    conn->worker->now    = xcomm_utils_getclock(XCOMM_TIME_PRECISION_MSEC);
+    conn->idle.recvtimeo = TCP_TLS_HANDSHAKE_TIMEOUT;
+    conn->idle.last_recv = conn->worker->now;
+    _async_tcp_idle_link(conn);
+
+    _async_tcp_tls_offload(conn);
+}
+
+static void _async_tcp_tls_recv(
+    async_tcp_connection_t* conn, char* buf, size_t len) {
+    if (conn->offload.busy) {
+        int rc = xcomm_tcp_tls_conn_stash(conn->tls, buf, len);
+        if (rc < 0) {
+            xcomm_loge("no memory.\n");
+            _async_tcp_connection_close(conn);
+            return;
+        }
+        /** the flush after the step re-arms reading. */
+        if (rc > 0) {
+            xcomm_event_io_mod(conn->loop, &conn->io, PLATFORM_POLLER_NO_OP);
+        }
+        return;
+    }
+    if (xcomm_tcp_tls_conn_feed(conn->tls, buf, len)) {
+        xcomm_loge("no memory.\n");
+        _async_tcp_connection_close(conn);
+        return;
+    }
+    if (!conn->connected) {
+        _async_tcp_tls_offload(conn);
+        return;
+    }
+    _async_tcp_tls_read(conn);
+}
+
+static void _async_tcp_recv(async_tcp_connection_t* conn) {
+    char buf[ASYNC_TCP_RECV_BUFSIZE];
+
+    while (true) {
+        ssize_t n = platform_socket_recv(conn->sock, buf, sizeof(buf));
+        if (n == PLATFORM_SO_ERROR_SOCKET_ERROR) {
+            int err = platform_socket_get_lasterror();
+            if (err == PLATFORM_SO_ERROR_EAGAIN ||
+                err == PLATFORM_SO_ERROR_EWOULDBLOCK) {
+                return;
+            }
+            _async_tcp_connection_close(conn);
+            return;
+        }
+        if (n == 0) {
+            _async_tcp_connection_close(conn);
+            return;
+        }
+        conn->idle.last_recv = _async_tcp_clock(conn);
+        conn->stats.bytes_in += n;
+
+        /** a pooled connection has nobody to read for, bytes mean it is stale. */
+        if (conn->pool.key && _async_tcp_pool_idle(conn)) {
+            _async_tcp_connection_close(conn);
+            return;
+        }
+        if (conn->quickack) {
+            platform_socket_enable_quickack(conn->sock, true);
+        }
+        if (conn->tls) {
+            _async_tcp_tls_recv(conn, buf, (size_t)n);
+        } else {
+            _async_tcp_deliver(conn, buf, (size_t)n);
+        }
+        if (conn->closed || conn->io.op == PLATFORM_POLLER_NO_OP ||
+            n < (ssize_t)sizeof(buf)) {
+            return;
+        }
+    }
+}
+
+static void _async_tcp_connection_io_cb(void* param, platform_poller_op_t op) {
+    async_tcp_connection_t* conn = param;
+
+    if (conn->closed) {
+        return;
+    }
+    if (conn->zerocopy.next_id) {
+        _async_tcp_reap_zerocopy(conn);
+        if (conn->closed) {
+            return;
+        }
+    }
+    if ((op & PLATFORM_POLLER_WR_OP) && _async_tcp_has_output(conn)) {
+        _async_tcp_flush(conn);
+        if (conn->closed) {
+            return;
+        }
+    }
+    if (op & PLATFORM_POLLER_RD_OP) {
+        _async_tcp_recv(conn);
+    }
+}
+
+static void _async_tcp_dial_context_free(void* param) {
+    async_tcp_dial_context_t* context = param;
+
+    free(context->host);
+    free(context->port);
+    free(context);
+}
+
+/**
+ * drops every attempt except the winner, which the connection adopts. with
+ * no winner the dial fails with err.
+ */
+static void _async_tcp_dial_finish(
+    async_tcp_dial_context_t* context, platform_sock_t sock, int err) {
+    async_tcp_connection_t* conn = context->conn;
+    xcomm_event_loop_t*     loop = conn->loop;
+
+    context->done = true;
+    if (context->stagger_timer) {
+        xcomm_event_timer_del(loop, context->stagger_timer);
+        context->stagger_timer = NULL;
+    }
+    if (context->deadline_timer) {
+        xcomm_event_timer_del(loop, context->deadline_timer);
+        context->deadline_timer = NULL;
+    }
+    for (int i = 0; i < context->next; i++) {
+        async_tcp_dial_attempt_t* attempt = &context->attempts[i];
+
+        if (attempt->sock != PLATFORM_SO_ERROR_INVALID_SOCKET) {
+            xcomm_event_io_del(loop, &attempt->io);
+            if (attempt->sock != sock) {
+                platform_socket_close(attempt->sock);
+            }
+            attempt->sock = PLATFORM_SO_ERROR_INVALID_SOCKET;
+        }
+    }
+    if (sock != PLATFORM_SO_ERROR_INVALID_SOCKET) {
+        conn->sock = sock;
+        _async_tcp_connect_established(conn);
+    } else {
+        xcomm_loge("tcp dial error.\n");
+        if (conn->connect_cb) {
+            conn->connect_cb(
+                NULL, err, platform_socket_tostring(err), conn->connect_ud);
+        }
+        _async_tcp_connection_free(conn);
+    }
+    /** attempt io events may still sit in the current completion batch. */
+    xcomm_event_routine_add(loop, _async_tcp_dial_context_free, context);
+}
+
+static void _async_tcp_dial_next(async_tcp_dial_context_t* context);
+
+static void _async_tcp_dial_stagger(void* param) {
+    async_tcp_dial_context_t* context = param;
+
+    /** the timer releases itself once this routine returns. */
+    context->stagger_timer = NULL;
+    _async_tcp_dial_next(context);
+}
+
+static void _async_tcp_dial_deadline(void* param) {
+    async_tcp_dial_context_t* context = param;
+
+    context->deadline_timer = NULL;
+    _async_tcp_dial_finish(
+        context, PLATFORM_SO_ERROR_INVALID_SOCKET, PLATFORM_SO_ERROR_ETIMEDOUT);
+}
+
+static void _async_tcp_dial_io_cb(void* param, platform_poller_op_t op) {
+    async_tcp_dial_attempt_t* attempt = param;
+    async_tcp_dial_context_t* context = attempt->context;
+
+    (void)op;
+    if (context->done || attempt->sock == PLATFORM_SO_ERROR_INVALID_SOCKET) {
+        return;
+    }
+    int err = platform_socket_get_soerror(attempt->sock);
+    if (!err) {
+        _async_tcp_dial_finish(context, attempt->sock, 0);
+        return;
+    }
+    xcomm_event_io_del(context->conn->loop, &attempt->io);
+    platform_socket_close(attempt->sock);
+    attempt->sock = PLATFORM_SO_ERROR_INVALID_SOCKET;
+
+    context->inflight--;
+    context->err = err;
+
+    /** a failed attempt lets the next one start right away. */
+    if (context->stagger_timer) {
+        xcomm_event_timer_del(context->conn->loop, context->stagger_timer);
+        context->stagger_timer = NULL;
+    }
+    _async_tcp_dial_next(context);
+}
+
+/**
+ * happy eyeballs (rfc 8305), starts the next address and arms the stagger
+ * timer for the one after it. all attempts race until the first completes.
+ */
+static void _async_tcp_dial_next(async_tcp_dial_context_t* context) {
+    async_tcp_connection_t*     conn = context->conn;
+    xcomm_tcp_sockopts_t        storage;
+    const xcomm_tcp_sockopts_t* opts = NULL;
+
+    /** mss and the receive window are announced in the syn. */
+    if (!conn->local) {
+        opts = xcomm_tcp_sockopts_load(&async_tcp_sockopts, &storage);
+    }
+    while (context->next < context->addrs.naddrs) {
+        int                       i = context->next++;
+        async_tcp_dial_attempt_t* attempt = &context->attempts[i];
+        struct sockaddr*          sa = (struct sockaddr*)&context->addrs.addrs[i];
+        bool                      connected = false;
+
+        /** attempts that fail or connect at once never join the poller. */
+        attempt->sock = PLATFORM_SO_ERROR_INVALID_SOCKET;
+
+        platform_sock_t sock =
+            platform_socket_open(sa->sa_family, SOCK_STREAM, true);
+        if (sock == PLATFORM_SO_ERROR_INVALID_SOCKET) {
+            context->err = platform_socket_get_lasterror();
+            continue;
+        }
+        xcomm_tcp_sockopts_prepare(sock, opts);
+
+        if (platform_socket_start_connect(
+                sock, sa, context->addrs.addrlens[i], &connected)) {
+            context->err = platform_socket_get_lasterror();
+            continue;
+        }
+        if (connected) {
+            _async_tcp_dial_finish(context, sock, 0);
+            return;
+        }
+        attempt->sock = sock;
+        attempt->context = context;
+        xcomm_event_io_add(
+            conn->loop,
+            &attempt->io,
+            (platform_poller_fd_t)sock,
+            PLATFORM_POLLER_WR_OP,
+            _async_tcp_dial_io_cb,
+            attempt);
+        context->inflight++;
+
+        if (context->next < context->addrs.naddrs) {
+            context->stagger_timer = xcomm_event_timer_add(
+                conn->loop,
+                _async_tcp_dial_stagger,
+                context,
+                XCOMM_TCP_EYEBALLS_DELAY,
+                false);
+        }
+        return;
+    }
+    if (context->inflight == 0) {
+        _async_tcp_dial_finish(
+            context, PLATFORM_SO_ERROR_INVALID_SOCKET, context->err);
+    }
+}
+
+static void _async_tcp_resolved(
+    int err, xcomm_resolver_addrs_t* addrs, void* userdata) {
+    async_tcp_dial_context_t* context = userdata;
+
+    if (err) {
+        _async_tcp_dial_finish(context, PLATFORM_SO_ERROR_INVALID_SOCKET, err);
+        return;
+    }
+    memcpy(&context->addrs, addrs, sizeof(xcomm_resolver_addrs_t));
+    xcomm_tcp_eyeballs_interleave(&context->addrs);
+
+    if (context->timeout_ms > 0) {
+        context->deadline_timer = xcomm_event_timer_add(
+            context->conn->loop,
+            _async_tcp_dial_deadline,
+            context,
+            context->timeout_ms,
+            false);
+    }
+    _async_tcp_dial_next(context);
+}
+
+/**
+ * name resolution runs on the engine resolver pool, the connect itself is
+ * issued from the connection's loop once the addresses come back.
+ */
+static void _async_tcp_dial(void* param) {
+    async_tcp_dial_context_t* context = param;
+    async_tcp_connection_t*   conn    = context->conn;
+
+    /** a unix domain socket path needs no resolving. */
+    if (conn->local) {
+        xcomm_resolver_addrs_t addrs;
+
+        if (platform_socket_unix_address(
+                context->host, &addrs.addrs[0], &addrs.addrlens[0])) {
+            xcomm_loge("unix socket path invalid.\n");
+            _async_tcp_resolved(
+                PLATFORM_SO_ERROR_EHOSTUNREACH, NULL, context);
+            return;
+        }
+        addrs.naddrs = 1;
+        _async_tcp_resolved(0, &addrs, context);
+        return;
+    }
+    if (xcomm_resolver_resolve(
+            &engine.resolver,
+            conn->loop,
+            context->host,
+            context->port,
+            SOCK_STREAM,
+            _async_tcp_resolved,
+            context)) {
+        _async_tcp_resolved(PLATFORM_SO_ERROR_ENOBUFS, NULL, context);
+    }
+}
+
+static void _async_tcp_pool_dialed(
+    xcomm_tcp_connection_t* conn,
+    int                     error_code,
+    const char*             error_message,
+    void*                   userdata);
+
+static void _async_tcp_pool_handover(void* param);
+
+static void _async_tcp_pool_checkout_free(async_tcp_checkout_context_t* context) {
+    tcp_pool_t* pool = context->key->pool;
+
+    free(context);
+    xcomm_tcp_pool_unref(pool);
+}
+
+static void _async_tcp_pool_dial(xcomm_list_t* dials) {
+    while (!xcomm_list_empty(dials)) {
+        xcomm_list_node_t* node = xcomm_list_head(dials);
+        xcomm_list_remove(node);
+
+        async_tcp_checkout_context_t* context =
+            xcomm_list_data(node, async_tcp_checkout_context_t, node);
+        tcp_pool_key_t* key = context->key;
+
+        xcomm_async_tcp_dial(
+            key->host,
+            key->port,
+            key->pool->config.connect_timeout_ms,
+            _async_tcp_pool_dialed,
+            context);
+    }
+}
+
+/**
+ * caller holds the pool mutex. an idle connection is handed over on its own
+ * loop, which checks its health first. otherwise a free slot is taken and
+ * the checkout is queued on dials, to be dialed once the mutex is dropped.
+ * with neither the checkout waits for a slot.
+ */
+static void _async_tcp_pool_acquire(
+    async_tcp_checkout_context_t* context, xcomm_list_t* dials) {
+    tcp_pool_key_t* key = context->key;
+
+    if (!xcomm_list_empty(&key->idle)) {
+        async_tcp_connection_t* conn = xcomm_list_data(
+            xcomm_list_head(&key->idle), async_tcp_connection_t, pool.node);
+        xcomm_list_remove(&conn->pool.node);
+        key->nidle--;
+        key->nactive++;
+        conn->pool.state = TCP_POOL_STATE_ACTIVE;
+
+        /**
+         * posted under the mutex, so a close racing with the handover frees
+         * the connection only after the handover ran.
+         */
+        context->conn = conn;
+        xcomm_event_routine_add(conn->loop, _async_tcp_pool_handover, context);
+        return;
+    }
+    if (xcomm_tcp_pool_has_slot(key)) {
+        key->nactive++;
+        xcomm_list_insert_tail(dials, &context->node);
+        return;
+    }
+    xcomm_list_insert_tail(&key->waiters, &context->node);
+}
+
+static void _async_tcp_pool_wake(tcp_pool_key_t* key, xcomm_list_t* dials) {
+    while (!xcomm_list_empty(&key->waiters) &&
+           (!xcomm_list_empty(&key->idle) || xcomm_tcp_pool_has_slot(key))) {
+        xcomm_list_node_t* node = xcomm_list_head(&key->waiters);
+        xcomm_list_remove(node);
+
+        _async_tcp_pool_acquire(
+            xcomm_list_data(node, async_tcp_checkout_context_t, node), dials);
+    }
+}
+
+/** caller holds the pool mutex and drops the reference after unlocking. */
+static void _async_tcp_pool_leave(
+    async_tcp_connection_t* conn, xcomm_list_t* dials) {
+    tcp_pool_key_t* key = conn->pool.key;
+
+    if (conn->pool.state == TCP_POOL_STATE_IDLE) {
+        xcomm_list_remove(&conn->pool.node);
+        key->nidle--;
+    } else {
+        key->nactive--;
+        _async_tcp_pool_wake(key, dials);
+    }
+    conn->pool.key   = NULL;
+    conn->pool.state = TCP_POOL_STATE_NONE;
+}
+
+static void _async_tcp_pool_release(async_tcp_connection_t* conn) {
+    tcp_pool_t*  pool = conn->pool.key->pool;
+    xcomm_list_t dials;
+
+    xcomm_list_init(&dials);
+
+    mtx_lock(&pool->mtx);
+    _async_tcp_pool_leave(conn, &dials);
+    mtx_unlock(&pool->mtx);
+
+    _async_tcp_pool_dial(&dials);
+    xcomm_tcp_pool_unref(pool);
+}
+
+static bool _async_tcp_pool_idle(async_tcp_connection_t* conn) {
+    tcp_pool_t* pool = conn->pool.key->pool;
+
+    mtx_lock(&pool->mtx);
+    bool idle = (conn->pool.state == TCP_POOL_STATE_IDLE);
+    mtx_unlock(&pool->mtx);
+
+    return idle;
+}
+
+static void _async_tcp_pool_checkout(async_tcp_checkout_context_t* context) {
+    tcp_pool_t*  pool = context->key->pool;
+    xcomm_list_t dials;
+
+    xcomm_list_init(&dials);
+
+    mtx_lock(&pool->mtx);
+    _async_tcp_pool_acquire(context, &dials);
+    mtx_unlock(&pool->mtx);
+
+    _async_tcp_pool_dial(&dials);
+}
+
+static void _async_tcp_pool_dialed(
+    xcomm_tcp_connection_t* conn,
+    int                     error_code,
+    const char*             error_message,
+    void*                   userdata) {
+    async_tcp_checkout_context_t* context = userdata;
+    tcp_pool_key_t*               key     = context->key;
+    tcp_pool_t*                   pool    = key->pool;
+    xcomm_list_t                  dials;
+
+    xcomm_list_init(&dials);
+
+    mtx_lock(&pool->mtx);
+    if (conn) {
+        async_tcp_connection_t* self = conn->opaque;
+
+        self->pool.key   = key;
+        self->pool.state = TCP_POOL_STATE_ACTIVE;
+        xcomm_tcp_pool_ref(pool);
+    } else {
+        key->nactive--;
+        _async_tcp_pool_wake(key, &dials);
+    }
+    mtx_unlock(&pool->mtx);
+
+    _async_tcp_pool_dial(&dials);
+
+    if (context->connect_cb) {
+        context->connect_cb(conn, error_code, error_message, context->userdata);
+    }
+    _async_tcp_pool_checkout_free(context);
+}
+
+static void _async_tcp_pool_handover(void* param) {
+    async_tcp_checkout_context_t* context = param;
+    async_tcp_connection_t*       conn    = context->conn;
+
+    if (!conn->closed && !platform_socket_is_idle(conn->sock)) {
+        _async_tcp_connection_close(conn);
+    }
+    if (conn->closed) {
+        /** the close gave the slot back, start over. */
+        context->conn = NULL;
+        _async_tcp_pool_checkout(context);
+        return;
+    }
+    conn->idle.recvtimeo = 0;
+    _async_tcp_idle_link(conn);
+
+    if (context->connect_cb) {
+        context->connect_cb(
+            &conn->handle, 0, platform_socket_tostring(0), context->userdata);
+    }
+    _async_tcp_pool_checkout_free(context);
+}
+
+/**
+ * runs on the connection's loop. the connection is parked without the
+ * previous user's callbacks, framer and timeouts, an idle timeout rides on
+ * the recv timeout of the idle wheel.
+ */
+static void _async_tcp_pool_checkin(void* param) {
+    async_tcp_connection_t* conn = param;
+    tcp_pool_key_t*         key  = conn->pool.key;
+    xcomm_list_t            dials;
+
+    if (conn->closed) {
+        return;
+    }
+    if (!key) {
+        _async_tcp_connection_close(conn);
+        return;
+    }
+    tcp_pool_t* pool = key->pool;
+
+    conn->recv_cb           = NULL;
+    conn->send_completed_cb = NULL;
+    conn->heartbeat_cb      = NULL;
+    conn->writable_cb       = NULL;
+    conn->close_cb          = NULL;
+    if (conn->packetizer) {
+        xcomm_event_routine_add(
+            conn->loop, _async_tcp_packetizer_free, conn->packetizer);
+        conn->packetizer = NULL;
+    }
+    conn->worker->now = xcomm_utils_getclock(XCOMM_TIME_PRECISION_MSEC);
+
+    conn->idle.recvtimeo          = pool->config.idle_timeout_ms;
+    conn->idle.sendtimeo          = 0;
+    conn->idle.heartbeat_interval = 0;
+    conn->idle.last_recv          = conn->worker->now;
+    _async_tcp_idle_link(conn);
+
+    xcomm_list_init(&dials);
+
+    mtx_lock(&pool->mtx);
+    bool keep = !pool->closing && key->nidle < pool->config.max_idle &&
+                xcomm_list_empty(&conn->sendq);
+    if (keep) {
+        /** parked before waking waiters, so they reuse it instead of dialing. */
+        key->nactive--;
+        conn->pool.state = TCP_POOL_STATE_IDLE;
+        xcomm_list_insert_head(&key->idle, &conn->pool.node);
+        key->nidle++;
+        _async_tcp_pool_wake(key, &dials);
+    } else {
+        _async_tcp_pool_leave(conn, &dials);
+    }
+    mtx_unlock(&pool->mtx);
+
+    _async_tcp_pool_dial(&dials);
+
+    if (!keep) {
+        _async_tcp_connection_close(conn);
+        xcomm_tcp_pool_unref(pool);
+    }
+}
+
+static void _async_tcp_pool_evict(void* param) {
+    async_tcp_connection_t* conn = param;
+
+    if (!conn->closed && conn->pool.key && _async_tcp_pool_idle(conn)) {
+        _async_tcp_connection_close(conn);
+    }
+}
+
+static void _async_tcp_accepted(void* param) {
+    async_tcp_accept_batch_t* batch = param;
+
+    while (!xcomm_list_empty(&batch->conns)) {
+        xcomm_list_node_t* node = xcomm_list_head(&batch->conns);
+        xcomm_list_remove(node);
+
+        async_tcp_connection_t* conn =
+            xcomm_list_data(node, async_tcp_connection_t, node);
+
+        _async_tcp_connection_default_sockopts(conn);
+
+        xcomm_event_io_add(
+            conn->loop,
+            &conn->io,
+            (platform_poller_fd_t)conn->sock,
+            PLATFORM_POLLER_RD_OP,
+            _async_tcp_connection_io_cb,
+            conn);
+        conn->registered = true;
+        _async_tcp_stats_link(conn);
+
+        if (batch->tls) {
+            conn->tls = xcomm_tcp_tls_conn_create(batch->tls, NULL, NULL);
+            if (!conn->tls) {
+                xcomm_loge("no memory.\n");
+                _async_tcp_connection_close(conn);
+                continue;
+            }
+            conn->connect_cb = batch->accept_cb;
+            conn->connect_ud = batch->userdata;
+            _async_tcp_tls_start(conn);
+            continue;
+        }
+        conn->connected = true;
+
+        batch->accept_cb(
+            &conn->handle, 0, platform_socket_tostring(0), batch->userdata);
+    }
+    if (batch->tls) {
+        xcomm_tcp_tls_unref(batch->tls);
+    }
+    free(batch);
+}
+
+static async_tcp_accept_batch_t* _async_tcp_accept_batch_get(
+    xcomm_list_t* batches, async_tcp_listener_t* listener, xcomm_event_loop_t* loop) {
+    xcomm_list_node_t* node = xcomm_list_head(batches);
+    while (node != xcomm_list_sentinel(batches)) {
+        async_tcp_accept_batch_t* batch =
+            xcomm_list_data(node, async_tcp_accept_batch_t, node);
+        if (batch->loop == loop) {
+            return batch;
+        }
+        node = xcomm_list_next(node);
+    }
+    async_tcp_accept_batch_t* batch = malloc(sizeof(async_tcp_accept_batch_t));
+    if (!batch) {
+        return NULL;
+    }
+    batch->loop      = loop;
+    batch->accept_cb = listener->accept_cb;
+    batch->userdata  = listener->accept_ud;
+    batch->tls       = listener->tls;
+    if (batch->tls) {
+        xcomm_tcp_tls_ref(batch->tls);
+    }
+    xcomm_list_init(&batch->conns);
+    xcomm_list_insert_tail(batches, &batch->node);
+    return batch;
+}
+
+/**
+ * drains up to accept_batch connections per readiness event, anything left
+ * is picked up on the next poll so one listener can not starve the loop.
+ * each worker then receives its share of the batch in a single post.
+ */
+static void _async_tcp_listener_io_cb(void* param, platform_poller_op_t op) {
+    async_tcp_listener_shard_t* shard    = param;
+    async_tcp_listener_t*       listener = shard->listener;
+    xcomm_list_t                batches;
+    (void)op;
+
+    xcomm_list_init(&batches);
+
+    for (int i = 0; i < listener->accept_batch && !shard->closed; i++) {
+        platform_sock_t sock = platform_socket_accept(shard->sock, true);
+        if (sock == PLATFORM_SO_ERROR_INVALID_SOCKET) {
+            int err = platform_socket_get_lasterror();
+            if (err == PLATFORM_SO_ERROR_ECONNABORTED) {
+                continue;
+            }
+            if (err != PLATFORM_SO_ERROR_EAGAIN &&
+                err != PLATFORM_SO_ERROR_EWOULDBLOCK) {
+                xcomm_loge("tcp accept error: %s.\n", platform_socket_tostring(err));
+            }
+            break;
+        }
+        if (!listener->accept_cb) {
+            platform_socket_close(sock);
+            continue;
+        }
+        async_tcp_connection_t* conn = _async_tcp_connection_create(
+            sock,
+            listener->sharded ? shard->loop : &engine.roundrobin()->looper);
+        if (conn) {
+            conn->local = listener->local;
+        }
+        async_tcp_accept_batch_t* batch =
+            conn ? _async_tcp_accept_batch_get(&batches, listener, conn->loop)
+                 : NULL;
+
+        if (!batch) {
+            xcomm_loge("no memory.\n");
+            platform_socket_close(sock);
+            _async_tcp_connection_free(conn);
+            continue;
+        }
+        xcomm_list_insert_tail(&batch->conns, &conn->node);
+    }
+    while (!xcomm_list_empty(&batches)) {
+        xcomm_list_node_t* node = xcomm_list_head(&batches);
+        xcomm_list_remove(node);
+
+        async_tcp_accept_batch_t* batch =
+            xcomm_list_data(node, async_tcp_accept_batch_t, node);
+        _async_tcp_dispatch(batch->loop, _async_tcp_accepted, batch);
+    }
+}
+
+static void _async_tcp_listener_shard_register(void* param) {
+    async_tcp_listener_shard_t* shard = param;
+
+    if (shard->closed) {
+        return;
+    }
+    /**
+     * the steering program picks the shard by cpu, pin the worker so the
+     * connection is served where its packets land.
+     */
+    if (shard->listener->steered && shard->listener->affinity) {
+        async_tcp_worker_t* worker = _async_tcp_worker_get(shard->loop);
+        if (worker && worker->pinned++ == 0) {
+            platform_info_setaffinity(shard->idx);
+        }
+        shard->pinned = worker != NULL;
+    }
+    xcomm_event_io_add(
+        shard->loop,
+        &shard->io,
+        (platform_poller_fd_t)shard->sock,
+        PLATFORM_POLLER_RD_OP,
+        _async_tcp_listener_io_cb,
+        shard);
+    shard->registered = true;
+}
+
+static void _async_tcp_listener_shard_release(void* param) {
+    async_tcp_listener_shard_t* shard    = param;
+    async_tcp_listener_t*       listener = shard->listener;
+
+    if (atomic_fetch_sub(&listener->alive, 1) == 1) {
+        if (listener->close_cb) {
+            listener->close_cb(&listener->handle, listener->close_ud);
+        }
+        if (listener->tls) {
+            xcomm_tcp_tls_unref(listener->tls);
+        }
+        free(listener);
+    }
+}
+
+static void _async_tcp_listener_shard_close(void* param) {
+    async_tcp_listener_shard_t* shard = param;
+
+    if (shard->closed) {
+        return;
+    }
+    shard->closed = true;
+
+    if (shard->registered) {
+        xcomm_event_io_del(shard->loop, &shard->io);
+        shard->registered = false;
+    }
+    platform_socket_close(shard->sock);
+
+    /** the last steered shard on the worker lets it run anywhere again. */
+    if (shard->pinned) {
+        async_tcp_worker_t* worker = _async_tcp_worker_get(shard->loop);
+        if (--worker->pinned == 0) {
+            platform_info_setaffinity(-1);
+        }
+        shard->pinned = false;
+    }
+
+    /** released next iteration, the accept loop may still be on the stack. */
+    xcomm_event_routine_add(
+        shard->loop, _async_tcp_listener_shard_release, shard);
+}
+
+static void _async_tcp_listen(void* param) {
+    async_tcp_listen_context_t* context  = param;
+    async_tcp_listener_t*       listener = context->listener;
+    int                         cores    = listener->steered ? listener->nshards : 0;
+
+    /**
+     * reuseport groups index sockets in bind order, so the shards are opened
+     * one after another from here to line up with the worker index.
+     */
+    for (int i = 0; i < listener->nshards; i++) {
+        async_tcp_listener_shard_t* shard = &listener->shards[i];
+
+        shard->sock = listener->local
+            ? platform_socket_listen_unix(context->host, true)
+            : platform_socket_listen(
+                  context->host, context->port, SOCK_STREAM, i, cores, true);
+
+        if (shard->sock == PLATFORM_SO_ERROR_INVALID_SOCKET) {
+            int err = platform_socket_get_lasterror();
+            xcomm_loge("tcp listen error.\n");
+            while (i-- > 0) {
+                platform_socket_close(listener->shards[i].sock);
+            }
+            if (context->listen_cb) {
+                context->listen_cb(
+                    NULL, err, platform_socket_tostring(err), context->userdata);
+            }
+            free(listener);
+            goto out;
+        }
+        /** mss has to be on the listening socket to reach the syn-ack. */
+        if (!listener->local) {
+            xcomm_tcp_sockopts_t storage;
+
+            xcomm_tcp_sockopts_apply(
+                shard->sock,
+                xcomm_tcp_sockopts_load(&async_tcp_sockopts, &storage));
+        }
+    }
+    /**
+     * accept_cb is normally installed from listen_cb, so the shards join
+     * their pollers only afterwards.
+     */
+    if (context->listen_cb) {
+        context->listen_cb(
+            &listener->handle, 0, platform_socket_tostring(0), context->userdata);
+    }
+    for (int i = 0; i < listener->nshards; i++) {
+        async_tcp_listener_shard_t* shard = &listener->shards[i];
+        _async_tcp_dispatch(
+            shard->loop, _async_tcp_listener_shard_register, shard);
+    }
+out:
+    free(context->host);
+    free(context->port);
+    free(context);
+}
+
+static void _async_tcp_listen_start(
+    const char* restrict  host,
+    const char* restrict  port,
+    xcomm_tcp_listen_cb_t listen_cb,
+    void*                 userdata,
+    bool                  sharded) {
+    engine_worker_t* single;
+    engine_worker_t** workers = &single;
+    int               nshards = 1;
+
+    if (sharded) {
+        workers = malloc(sizeof(engine_worker_t*) * engine.concurrency);
+        if (!workers) {
+            xcomm_loge("no memory.\n");
+            return;
+        }
+        nshards = engine.snapshot(workers, engine.concurrency);
+    } else {
+        single = engine.roundrobin();
+    }
+    async_tcp_listen_context_t* context =
+        malloc(sizeof(async_tcp_listen_context_t));
+    async_tcp_listener_t* listener = calloc(
+        1,
+        sizeof(async_tcp_listener_t) +
+            sizeof(async_tcp_listener_shard_t) * nshards);
+
+    if (!context || !listener) {
+        xcomm_loge("no memory.\n");
+        goto fail;
+    }
+    context->host      = strdup(host);
+    context->port      = port ? strdup(port) : NULL;
+    context->listen_cb = listen_cb;
+    context->userdata  = userdata;
+    context->listener  = listener;
+
+    if (!context->host || (port && !context->port)) {
+        xcomm_loge("no memory.\n");
+        free(context->host);
+        free(context->port);
+        goto fail;
+    }
+    listener->handle.opaque = listener;
+    listener->sharded       = sharded;
+    listener->local         = !port;
+    listener->affinity      = true;
+    listener->nshards       = nshards;
+    /** with fewer or more shards than cpus cpu % nshards misses the pinning. */
+    listener->steered       = sharded && nshards == platform_info_getcpus();
+    listener->accept_batch  = ASYNC_TCP_ACCEPT_BATCH;
+    atomic_init(&listener->closed, false);
+    atomic_init(&listener->alive, nshards);
+
+    for (int i = 0; i < nshards; i++) {
+        listener->shards[i].idx      = i;
+        listener->shards[i].loop     = &workers[i]->looper;
+        listener->shards[i].listener = listener;
+    }
+    _async_tcp_dispatch(listener->shards[0].loop, _async_tcp_listen, context);
+
+    if (sharded) {
+        free(workers);
+    }
+    return;
+
+fail:
+    free(context);
+    free(listener);
+    if (sharded) {
+        free(workers);
+    }
+}
+
+static void _async_tcp_close_connection(void* param) {
+    _async_tcp_connection_close(param);
+}
+
+static void _async_tcp_send(void* param) {
+    async_tcp_send_req_t*   req  = param;
+    async_tcp_connection_t* conn = req->conn;
+
+    req->queued = conn->loop->now;
+
+    if (conn->closed || !conn->connected) {
+        _async_tcp_send_req_complete(req);
+        return;
+    }
+    bool idle = xcomm_list_empty(&conn->sendq);
+    xcomm_list_insert_tail(&conn->sendq, &req->node);
+
+    if (idle) {
+        conn->idle.last_send = _async_tcp_clock(conn);
+        _async_tcp_flush(conn);
+    }
+}
+
+static void _async_tcp_set_packetizer(void* param) {
+    async_tcp_option_context_t* context    = param;
+    async_tcp_connection_t*     conn       = context->conn;
+    tcp_packetizer_t*           packetizer = context->ptr;
+
+    if (conn->closed) {
+        if (packetizer) {
+            _async_tcp_packetizer_free(packetizer);
+        }
+    } else {
+        /** the old framer may be mid-feed when this runs from a callback. */
+        if (conn->packetizer) {
+            xcomm_event_routine_add(
+                conn->loop, _async_tcp_packetizer_free, conn->packetizer);
+        }
+        conn->packetizer = packetizer;
+    }
+    free(context);
+}
+
+static void _async_tcp_set_idle(void* param) {
+    async_tcp_option_context_t* context = param;
+    async_tcp_connection_t*     conn    = context->conn;
+    int*                        option  = context->ptr;
+
+    if (!conn->closed) {
+        conn->worker->now = xcomm_utils_getclock(XCOMM_TIME_PRECISION_MSEC);
+
+        *option = context->value;
+        /** periods start counting from now. */
+        conn->idle.last_recv      = conn->worker->now;
+        conn->idle.last_send      = conn->worker->now;
+        conn->idle.last_heartbeat = conn->worker->now;
+
+        _async_tcp_idle_link(conn);
+    }
+    free(context);
+}
+
+static void _async_tcp_set_sockopts(void* param) {
+    async_tcp_option_context_t* context = param;
+    async_tcp_connection_t*     conn    = context->conn;
+
+    if (!conn->closed) {
+        _async_tcp_connection_sockopts(conn, context->ptr);
+    }
+    free(context->ptr);
+    free(context);
+}
+
+static void _async_tcp_set_zerocopy(void* param) {
+    async_tcp_option_context_t* context = param;
+    async_tcp_connection_t*     conn    = context->conn;
+
+    if (!conn->closed) {
+        if (context->value) {
+            conn->zerocopy.enabled =
+                platform_socket_enable_zerocopy(conn->sock, true);
+            if (!conn->zerocopy.enabled) {
+                xcomm_logw("zerocopy not supported, fall back to copy.\n");
+            }
+        } else {
+            conn->zerocopy.enabled = false;
+        }
+    }
+    free(context);
+}
+
+/** activity stamps are monotonic, stats report them on the wall clock. */
+static uint64_t _async_tcp_wallclock(uint64_t stamp, uint64_t now, uint64_t wall) {
+    if (!stamp || stamp > now / 1000) {
+        return stamp ? wall : 0;
+    }
+    return wall - (now / 1000 - stamp);
+}
+
+static void _async_tcp_stats_sample(
+    async_tcp_connection_t* conn, xcomm_tcp_stats_t* stats) {
+    uint64_t            now    = xcomm_utils_getclock(XCOMM_TIME_PRECISION_USEC);
+    uint64_t            oldest = now;
+    uint64_t            wall   = xcomm_utils_getnow(XCOMM_TIME_PRECISION_MSEC);
+    platform_tcp_info_t info;
+
+    memset(stats, 0, sizeof(xcomm_tcp_stats_t));
+
+    /** requests waiting on zerocopy notifications still count as queued. */
+    xcomm_list_t* lists[2] = {&conn->zerocopy.inflight, &conn->sendq};
+    for (int i = 0; i < 2; i++) {
+        xcomm_list_node_t* node = xcomm_list_head(lists[i]);
+        while (node != xcomm_list_sentinel(lists[i])) {
+            async_tcp_send_req_t* req =
+                xcomm_list_data(node, async_tcp_send_req_t, node);
+            node = xcomm_list_next(node);
+
+            if (req->queued < oldest) {
+                oldest = req->queued;
+            }
+            stats->sendq_depth++;
+        }
+    }
+    stats->bytes_in      = conn->stats.bytes_in;
+    stats->bytes_out     = conn->stats.bytes_out;
+    stats->sendq_bytes   = atomic_load(&conn->backpressure.pending);
+    stats->sendq_age_us  = now - oldest;
+    stats->sends         = conn->stats.sends;
+    stats->queue_time_us = conn->stats.queue_time_us;
+    stats->last_recv_ms  = _async_tcp_wallclock(conn->idle.last_recv, now, wall);
+    stats->last_send_ms  = _async_tcp_wallclock(conn->idle.last_send, now, wall);
+
+    if (!conn->local && !platform_socket_get_tcpinfo(conn->sock, &info)) {
+        stats->has_tcp_info  = true;
+        stats->rtt_us        = info.rtt_us;
+        stats->rttvar_us     = info.rttvar_us;
+        stats->retransmits   = info.retransmits;
+        stats->cwnd          = info.cwnd;
+        stats->delivery_rate = info.delivery_rate;
+    }
+}
+
+static void _async_tcp_get_stats(void* param) {
+    async_tcp_stats_context_t* context = param;
+    async_tcp_connection_t*    conn    = context->conn;
+    xcomm_tcp_stats_t          stats;
+
+    if (conn->closed) {
+        context->stats_cb(&conn->handle, NULL, context->userdata);
+    } else {
+        _async_tcp_stats_sample(conn, &stats);
+        context->stats_cb(&conn->handle, &stats, context->userdata);
+    }
+    free(context);
+}
+
+/**
+ * the connections are moved aside first, one the callback closes just
+ * drops out of the walk.
+ */
+static void _async_tcp_collect_stats(void* param) {
+    async_tcp_stats_context_t* context = param;
+    async_tcp_worker_t*        worker  = _async_tcp_worker_get(context->loop);
+    xcomm_list_t               walk;
+    xcomm_tcp_stats_t          stats;
+
+    xcomm_list_init(&walk);
+    if (worker) {
+        xcomm_list_swap(&walk, &worker->conns);
+    }
+
+    while (!xcomm_list_empty(&walk)) {
+        async_tcp_connection_t* conn = xcomm_list_data(
+            xcomm_list_head(&walk), async_tcp_connection_t, stats.node);
+
+        xcomm_list_remove(&conn->stats.node);
+        xcomm_list_insert_tail(&worker->conns, &conn->stats.node);
+
+        _async_tcp_stats_sample(conn, &stats);
+        context->stats_cb(&conn->handle, &stats, context->userdata);
+    }
+    context->stats_cb(NULL, NULL, context->userdata);
+    free(context);
+}
+
+static void _async_tcp_relay_free(void* param) {
+    async_tcp_relay_t* relay = param;
+
+    for (int i = 0; i < 2; i++) {
+        if (relay->dirs[i].pipe[0] != -1) {
+            platform_socket_pipe_close(relay->dirs[i].pipe);
+        }
+        free(relay->dirs[i].buf);
+        free(relay->ends[i].unsent);
+        free(relay->ends[i].unread);
+    }
+    free(relay);
+}
+
+static void _async_tcp_relay_finish(async_tcp_relay_t* relay, int err) {
+    relay->finished = true;
+
+    for (int i = 0; i < 2; i++) {
+        async_tcp_relay_end_t* end = &relay->ends[i];
+
+        if (end->registered) {
+            xcomm_event_io_del(relay->loop, &end->io);
+            end->registered = false;
+        }
+        if (end->sock != PLATFORM_SO_ERROR_INVALID_SOCKET) {
+            platform_socket_close(end->sock);
+            end->sock = PLATFORM_SO_ERROR_INVALID_SOCKET;
+        }
+    }
+    if (relay->close_cb) {
+        relay->close_cb(
+            relay->dirs[0].bytes,
+            relay->dirs[1].bytes,
+            err,
+            platform_socket_tostring(err),
+            relay->close_ud);
+    }
+    /** io events of the ends may still sit in the current completion batch. */
+    xcomm_event_routine_add(relay->loop, _async_tcp_relay_free, relay);
+}
+
+/** room left to take in, a userspace buffer refills only once drained. */
+static size_t _async_tcp_relay_room(async_tcp_relay_dir_t* dir) {
+    if (dir->pipe[0] != -1) {
+        return ASYNC_TCP_RELAY_CHUNK - dir->pending;
+    }
+    return dir->pending ? 0 : ASYNC_TCP_RELAY_CHUNK;
+}
+
+static ssize_t _async_tcp_relay_fill(
+    async_tcp_relay_dir_t* dir, platform_sock_t src, size_t room) {
+    if (dir->pipe[0] != -1) {
+        return platform_socket_splice_in(src, dir->pipe[1], room);
+    }
+    dir->off = 0;
+    return platform_socket_recv(src, dir->buf, (int)room);
+}
+
+static ssize_t
+_async_tcp_relay_drain(async_tcp_relay_dir_t* dir, platform_sock_t dst) {
+    if (dir->pipe[0] != -1) {
+        return platform_socket_splice_out(dir->pipe[0], dst, dir->pending);
+    }
+    ssize_t n =
+        platform_socket_send(dst, dir->buf + dir->off, (int)dir->pending);
+    if (n > 0) {
+        dir->off += n;
+    }
+    return n;
+}
+
+static bool _async_tcp_relay_again(void) {
+    int err = platform_socket_get_lasterror();
+    return err == PLATFORM_SO_ERROR_EAGAIN || err == PLATFORM_SO_ERROR_EWOULDBLOCK;
+}
+
+/** moves what it can until both sockets would block, -1 on a hard error. */
+static int _async_tcp_relay_pump(
+    async_tcp_relay_t* relay, int i, bool* progress) {
+    async_tcp_relay_dir_t* dir = &relay->dirs[i];
+    platform_sock_t        src = relay->ends[i].sock;
+    platform_sock_t        dst = relay->ends[1 - i].sock;
+
+    while (!dir->done) {
+        bool   moved = false;
+        size_t room  = _async_tcp_relay_room(dir);
+
+        if (!dir->eof && room > 0) {
+            ssize_t n = _async_tcp_relay_fill(dir, src, room);
+            if (n > 0) {
+                dir->pending += n;
+                moved = true;
+            } else if (n == 0) {
+                dir->eof = true;
+                moved    = true;
+            } else if (!_async_tcp_relay_again()) {
+                return -1;
+            }
+        }
+        if (dir->pending > 0) {
+            ssize_t n = _async_tcp_relay_drain(dir, dst);
+            if (n > 0) {
+                dir->pending -= n;
+                dir->bytes   += n;
+                moved = true;
+            } else if (n == PLATFORM_SO_ERROR_SOCKET_ERROR &&
+                       !_async_tcp_relay_again()) {
+                return -1;
+            }
+        }
+        if (dir->eof && dir->pending == 0) {
+            platform_socket_shutdown_write(dst);
+            dir->done = true;
+            moved     = true;
+        }
+        *progress |= moved;
+        if (!moved) {
+            break;
+        }
+    }
+    return 0;
+}
+
+/**
+ * an end is read while its direction has room and written while the other
+ * one holds bytes for it, so a slow side throttles the fast one.
+ */
+static void _async_tcp_relay_interest(async_tcp_relay_t* relay) {
+    for (int i = 0; i < 2; i++) {
+        async_tcp_relay_end_t* end = &relay->ends[i];
+        async_tcp_relay_dir_t* out = &relay->dirs[i];
+        async_tcp_relay_dir_t* in  = &relay->dirs[1 - i];
+        platform_poller_op_t   op  = PLATFORM_POLLER_NO_OP;
+
+        if (!end->registered) {
+            continue;
+        }
+        if (!out->eof && _async_tcp_relay_room(out) > 0) {
+            op |= PLATFORM_POLLER_RD_OP;
+        }
+        if (in->pending > 0) {
+            op |= PLATFORM_POLLER_WR_OP;
+        }
+        if (op != end->op) {
+            xcomm_event_io_mod(relay->loop, &end->io, op);
+            end->op = op;
+        }
+    }
+}
+
+static void _async_tcp_relay_io_cb(void* param, platform_poller_op_t op) {
+    async_tcp_relay_end_t* end      = param;
+    async_tcp_relay_t*     relay    = end->relay;
+    bool                   progress = false;
+
+    /** the other end's event may follow in the batch that finished it. */
+    if (relay->finished) {
+        return;
+    }
+    for (int i = 0; i < 2; i++) {
+        if (_async_tcp_relay_pump(relay, i, &progress)) {
+            _async_tcp_relay_finish(relay, platform_socket_get_lasterror());
+            return;
+        }
+    }
+    if (relay->dirs[0].done && relay->dirs[1].done) {
+        _async_tcp_relay_finish(relay, 0);
+        return;
+    }
+    /**
+     * hangups and errors are reported whatever the interest. after a clean
+     * hangup the peer is done both ways, what it left queued is read as the
+     * other end frees room, so the end stops polling.
+     */
+    if (!progress && (op & ~end->op)) {
+        int err = platform_socket_get_soerror(end->sock);
+        if (err) {
+            _async_tcp_relay_finish(relay, err);
+            return;
+        }
+        xcomm_event_io_del(relay->loop, &end->io);
+        end->registered = false;
+    }
+    _async_tcp_relay_interest(relay);
+}
+
+/** carried bytes go in first, a direction holds at most one chunk. */
+static int _async_tcp_relay_preload(
+    async_tcp_relay_dir_t* dir, const char* data, size_t len) {
+    if (len == 0) {
+        return 0;
+    }
+    if (len > ASYNC_TCP_RELAY_CHUNK - dir->pending) {
+        return -1;
+    }
+    if (dir->pipe[0] != -1) {
+        if (platform_socket_pipe_write(dir->pipe[1], data, len) != (ssize_t)len) {
+            return -1;
+        }
+    } else {
+        memcpy(dir->buf + dir->pending, data, len);
+    }
+    dir->pending += len;
+    return 0;
+}
+
+static void _async_tcp_relay_start(void* param) {
+    async_tcp_relay_t* relay = param;
+
+    for (int i = 0; i < 2; i++) {
+        if (relay->ends[i].err) {
+            _async_tcp_relay_finish(relay, relay->ends[i].err);
+            return;
+        }
+        if (relay->ends[i].sock == PLATFORM_SO_ERROR_INVALID_SOCKET) {
+            xcomm_loge("tcp relay end already closed.\n");
+            _async_tcp_relay_finish(relay, PLATFORM_SO_ERROR_ECONNABORTED);
+            return;
+        }
+    }
+    for (int i = 0; i < 2; i++) {
+        async_tcp_relay_dir_t* dir = &relay->dirs[i];
+
+        /** without splice the bytes take a trip through userspace. */
+        if (platform_socket_pipe(dir->pipe)) {
+            dir->pipe[0] = dir->pipe[1] = -1;
+            dir->buf = malloc(ASYNC_TCP_RELAY_CHUNK);
+            if (!dir->buf) {
+                xcomm_loge("no memory.\n");
+                _async_tcp_relay_finish(relay, PLATFORM_SO_ERROR_ENOBUFS);
+                return;
+            }
+        }
+        /** what the far end had queued leaves before what this end sent. */
+        async_tcp_relay_end_t* src = &relay->ends[i];
+        async_tcp_relay_end_t* dst = &relay->ends[1 - i];
+
+        if (_async_tcp_relay_preload(dir, dst->unsent, dst->unsentlen) ||
+            _async_tcp_relay_preload(dir, src->unread, src->unreadlen)) {
+            xcomm_loge("tcp relay carries more than a chunk.\n");
+            _async_tcp_relay_finish(relay, PLATFORM_SO_ERROR_ENOBUFS);
+            return;
+        }
+    }
+    for (int i = 0; i < 2; i++) {
+        async_tcp_relay_end_t* end = &relay->ends[i];
+
+        end->op = PLATFORM_POLLER_RD_OP;
+        xcomm_event_io_add(
+            relay->loop,
+            &end->io,
+            (platform_poller_fd_t)end->sock,
+            end->op,
+            _async_tcp_relay_io_cb,
+            end);
+        end->registered = true;
+    }
+    _async_tcp_relay_interest(relay);
+}
+
+/**
+ * copies out what the connection still holds. a file send can not be
+ * carried and fails the relay.
+ */
+static int _async_tcp_relay_collect(
+    async_tcp_relay_end_t* end, async_tcp_connection_t* conn) {
+    xcomm_list_node_t* node;
+    size_t             len = 0;
+
+    for (node = xcomm_list_head(&conn->sendq);
+         node != xcomm_list_sentinel(&conn->sendq);
+         node = xcomm_list_next(node)) {
+        async_tcp_send_req_t* req = xcomm_list_data(node, async_tcp_send_req_t, node);
+        if (req->file) {
+            xcomm_loge("tcp relay can not carry a file send.\n");
+            return -1;
+        }
+        len += req->len - req->off;
+    }
+    if (len > 0) {
+        end->unsent = malloc(len);
+        if (!end->unsent) {
+            xcomm_loge("no memory.\n");
+            return -1;
+        }
+        for (node = xcomm_list_head(&conn->sendq);
+             node != xcomm_list_sentinel(&conn->sendq);
+             node = xcomm_list_next(node)) {
+            async_tcp_send_req_t* req =
+                xcomm_list_data(node, async_tcp_send_req_t, node);
+            memcpy(end->unsent + end->unsentlen, req->buf + req->off,
+                   req->len - req->off);
+            end->unsentlen += req->len - req->off;
+        }
+    }
+    /** the packetizer only ever holds the head of one frame, unwrapped. */
+    xcomm_ringbuf_t* ring = conn->packetizer ? &conn->packetizer->ring : NULL;
+    if (ring && ring->buf && !xcomm_ringbuf_empty(ring)) {
+        end->unreadlen = xcomm_ringbuf_len(ring);
+        end->unread    = malloc(end->unreadlen);
+        if (!end->unread) {
+            xcomm_loge("no memory.\n");
+            return -1;
+        }
+        memcpy(end->unread, ring->buf + ring->rpos, end->unreadlen);
+    }
+    return 0;
+}
+
+/**
+ * runs on the connection's own loop. queued bytes get one more chance to
+ * go out, the rest is carried over. the connection closes around its
+ * socket, which the relay keeps, the close callback does not fire.
+ */
+static void _async_tcp_relay_detach(void* param) {
+    async_tcp_relay_end_t*  end   = param;
+    async_tcp_relay_t*      relay = end->relay;
+    async_tcp_connection_t* conn  = end->conn;
+
+    if (!conn->closed && !xcomm_list_empty(&conn->sendq)) {
+        _async_tcp_flush(conn);
+    }
+    if (!conn->closed && _async_tcp_relay_collect(end, conn)) {
+        end->err = PLATFORM_SO_ERROR_ENOBUFS;
+    }
+    if (!conn->closed) {
+        if (conn->registered) {
+            xcomm_event_io_del(conn->loop, &conn->io);
+            conn->registered = false;
+        }
+        end->sock      = conn->sock;
+        conn->sock     = PLATFORM_SO_ERROR_INVALID_SOCKET;
+        conn->close_cb = NULL;
+        _async_tcp_connection_close(conn);
+    }
+    end->conn = NULL;
+
+    if (atomic_fetch_add(&relay->detached, 1) == 1) {
+        _async_tcp_dispatch(relay->loop, _async_tcp_relay_start, relay);
+    }
+}
+
+/** a dial that never got started still owes its connect_cb. */
+static void _async_tcp_dial_failed(
+    xcomm_tcp_connect_cb_t connect_cb, int err, void* userdata) {
+    if (connect_cb) {
+        connect_cb(NULL, err, platform_socket_tostring(err), userdata);
+    }
+}
+
+static void _async_tcp_dial_start(
+    tcp_tls_t*             tls,
+    const char* restrict   host,
+    const char* restrict   port,
+    int                    timeout_ms,
+    xcomm_tcp_connect_cb_t connect_cb,
+    void*                  userdata) {
+    async_tcp_dial_context_t* context = calloc(1, sizeof(async_tcp_dial_context_t));
+    if (!context) {
+        xcomm_loge("no memory.\n");
+        _async_tcp_dial_failed(connect_cb, ENOMEM, userdata);
+        return;
+    }
+    context->host       = strdup(host);
+    context->port       = port ? strdup(port) : NULL;
+    context->timeout_ms = timeout_ms;
+    context->err        = PLATFORM_SO_ERROR_EHOSTUNREACH;
+    context->conn       = _async_tcp_connection_create(
+        PLATFORM_SO_ERROR_INVALID_SOCKET, &engine.roundrobin()->looper);
+
+    if (tls && context->conn) {
+        context->conn->tls = xcomm_tcp_tls_conn_create(tls, host, port);
+    }
+    if (!context->host || (port && !context->port) || !context->conn ||
+        (tls && !context->conn->tls)) {
+        xcomm_loge("no memory.\n");
+        free(context->host);
+        free(context->port);
+        _async_tcp_connection_free(context->conn);
+        free(context);
+        _async_tcp_dial_failed(connect_cb, ENOMEM, userdata);
+        return;
+    }
+    context->conn->local      = !port;
+    context->conn->connect_cb = connect_cb;
+    context->conn->connect_ud = userdata;
+
+    _async_tcp_dispatch(context->conn->loop, _async_tcp_dial, context);
+}
 
 void xcomm_async_tcp_dial(
     const char* restrict   host,
@@ -27,6 +2458,35 @@ void xcomm_async_tcp_dial(
     int                    timeout_ms,
     xcomm_tcp_connect_cb_t connect_cb,
     void*                  userdata) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    _async_tcp_dial_start(NULL, host, port, timeout_ms, connect_cb, userdata);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+}
+
+/**
+ * connect_cb fires once the tls handshake is done, a session cached for
+ * host:port by an earlier connection on any worker is offered for resumption.
+ */
+void xcomm_async_tcp_dial_tls(
+    xcomm_tcp_tls_t*       tls,
+    const char* restrict   host,
+    const char* restrict   port,
+    int                    timeout_ms,
+    xcomm_tcp_connect_cb_t connect_cb,
+    void*                  userdata) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    tcp_tls_t* self = tls->opaque;
+    if (self->server) {
+        xcomm_loge("tls context is not a client one.\n");
+        _async_tcp_dial_failed(connect_cb, EINVAL, userdata);
+        return;
+    }
+    _async_tcp_dial_start(self, host, port, timeout_ms, connect_cb, userdata);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
 }
 
 void xcomm_async_tcp_listen(
@@ -34,77 +2494,590 @@ void xcomm_async_tcp_listen(
     const char* restrict  port,
     xcomm_tcp_listen_cb_t listen_cb,
     void*                 userdata) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    _async_tcp_listen_start(host, port, listen_cb, userdata, false);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+}
+
+void xcomm_async_tcp_listen_sharded(
+    const char* restrict  host,
+    const char* restrict  port,
+    xcomm_tcp_listen_cb_t listen_cb,
+    void*                 userdata) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    _async_tcp_listen_start(host, port, listen_cb, userdata, true);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+}
+
+void xcomm_async_tcp_dial_unix(
+    const char* restrict   path,
+    int                    timeout_ms,
+    xcomm_tcp_connect_cb_t connect_cb,
+    void*                  userdata) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    _async_tcp_dial_start(NULL, path, NULL, timeout_ms, connect_cb, userdata);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+}
+
+/** reuseport does not spread unix domain sockets, so never sharded. */
+void xcomm_async_tcp_listen_unix(
+    const char* restrict  path,
+    xcomm_tcp_listen_cb_t listen_cb,
+    void*                 userdata) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    _async_tcp_listen_start(path, NULL, listen_cb, userdata, false);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+}
+
+/**
+ * steered shards pin their workers by default, turn it off from listen_cb
+ * before the shards join their pollers.
+ */
+void xcomm_async_tcp_set_listener_affinity(
+    xcomm_tcp_listener_t* listener, bool on) {
+    async_tcp_listener_t* self = listener->opaque;
+
+    self->affinity = on;
+}
+
+void xcomm_async_tcp_set_accept_batch(
+    xcomm_tcp_listener_t* listener, int batch) {
+    async_tcp_listener_t* self = listener->opaque;
 
+    self->accept_batch = batch > 0 ? batch : ASYNC_TCP_ACCEPT_BATCH;
 }
 
 void xcomm_async_tcp_set_accept_cb(
     xcomm_tcp_listener_t* listener,
     xcomm_tcp_accept_cb_t accept_cb,
     void*                 userdata) {
+    async_tcp_listener_t* self = listener->opaque;
 
+    self->accept_cb = accept_cb;
+    self->accept_ud = userdata;
 }
 
 void xcomm_async_tcp_set_listener_close_cb(
     xcomm_tcp_listener_t*         listener,
     xcomm_tcp_listener_close_cb_t listener_close_cb,
     void*                         userdata) {
+    async_tcp_listener_t* self = listener->opaque;
+
+    self->close_cb = listener_close_cb;
+    self->close_ud = userdata;
+}
+
+/**
+ * connections accepted afterwards finish a tls handshake before accept_cb,
+ * install it from listen_cb like the accept callback.
+ */
+void xcomm_async_tcp_set_listener_tls(
+    xcomm_tcp_listener_t* listener, xcomm_tcp_tls_t* tls) {
+    async_tcp_listener_t* self = listener->opaque;
+    tcp_tls_t*            prev = self->tls;
 
+    if (tls && !((tcp_tls_t*)tls->opaque)->server) {
+        xcomm_loge("tls context is not a server one.\n");
+        return;
+    }
+    self->tls = tls ? tls->opaque : NULL;
+    if (self->tls) {
+        xcomm_tcp_tls_ref(self->tls);
+    }
+    if (prev) {
+        xcomm_tcp_tls_unref(prev);
+    }
 }
 
 void xcomm_async_tcp_close_listener(xcomm_tcp_listener_t* listener) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
 
+    async_tcp_listener_t* self    = listener->opaque;
+    int                   nshards = self->nshards;
+
+    /** the last shard to close frees the listener, do not touch it after. */
+    if (!atomic_exchange(&self->closed, true)) {
+        for (int i = 0; i < nshards; i++) {
+            _async_tcp_dispatch(
+                self->shards[i].loop,
+                _async_tcp_listener_shard_close,
+                &self->shards[i]);
+        }
+    }
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
 }
 
 void xcomm_async_tcp_set_recv_cb(
     xcomm_tcp_connection_t* conn, xcomm_tcp_recv_cb_t recv_cb, void* userdata) {
+    async_tcp_connection_t* self = conn->opaque;
 
+    self->recv_cb = recv_cb;
+    self->recv_ud = userdata;
 }
 
 void xcomm_async_tcp_set_send_completed_cb(
     xcomm_tcp_connection_t*       conn,
     xcomm_tcp_send_completed_cb_t send_completed_cb,
     void*                         userdata) {
+    async_tcp_connection_t* self = conn->opaque;
 
+    self->send_completed_cb = send_completed_cb;
+    self->send_completed_ud = userdata;
 }
 
 void xcomm_async_tcp_set_connection_close_cb(
     xcomm_tcp_connection_t*         conn,
     xcomm_tcp_connection_close_cb_t connection_close_cb,
     void*                           userdata) {
+    async_tcp_connection_t* self = conn->opaque;
 
+    self->close_cb = connection_close_cb;
+    self->close_ud = userdata;
 }
 
 void xcomm_async_tcp_close_connection(xcomm_tcp_connection_t* conn) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
 
+    async_tcp_connection_t* self = conn->opaque;
+    _async_tcp_dispatch(self->loop, _async_tcp_close_connection, self);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
 }
 
 void xcomm_async_tcp_set_heartbeat_cb(
     xcomm_tcp_connection_t*  conn,
     xcomm_tcp_heartbeat_cb_t heartbeat_cb,
     void*                    userdata) {
+    async_tcp_connection_t* self = conn->opaque;
+
+    self->heartbeat_cb = heartbeat_cb;
+    self->heartbeat_ud = userdata;
+}
+
+/**
+ * the loop may drain below the low watermark between the add and raising
+ * throttled, in that case nobody else will see the flag and the writable
+ * callback is posted from here.
+ */
+static int _async_tcp_send_account(async_tcp_connection_t* conn, size_t len) {
+    size_t pending =
+        atomic_fetch_add(&conn->backpressure.pending, len) + len;
+
+    if (pending < atomic_load(&conn->backpressure.high)) {
+        return 0;
+    }
+    atomic_store(&conn->backpressure.throttled, true);
+
+    if (atomic_load(&conn->backpressure.pending) <=
+            atomic_load(&conn->backpressure.low) &&
+        atomic_exchange(&conn->backpressure.throttled, false)) {
+        xcomm_event_routine_add(conn->loop, _async_tcp_writable, conn);
+    }
+    return 1;
+}
+
+/**
+ * returns 1 once the pending bytes reach the high watermark, the writable
+ * callback fires when they drain back to the low watermark.
+ */
+int xcomm_async_tcp_send(xcomm_tcp_connection_t* conn, void* buf, size_t len) {
+    async_tcp_connection_t* self = conn->opaque;
+
+    async_tcp_send_req_t* req = calloc(1, sizeof(async_tcp_send_req_t));
+    if (!req) {
+        xcomm_loge("no memory.\n");
+        return -1;
+    }
+    req->buf  = buf;
+    req->len  = len;
+    req->conn = self;
+
+    int ret = _async_tcp_send_account(self, len);
+
+    _async_tcp_dispatch(self->loop, _async_tcp_send, req);
+    return ret;
+}
+
+/**
+ * len bytes of fd from offset go out in order with the other sends, the
+ * file has to stay open until send_completed_cb reports the request.
+ */
+int xcomm_async_tcp_send_file(
+    xcomm_tcp_connection_t* conn, int fd, int64_t offset, size_t len) {
+    async_tcp_connection_t* self = conn->opaque;
+
+    async_tcp_send_req_t* req = calloc(1, sizeof(async_tcp_send_req_t));
+    if (!req) {
+        xcomm_loge("no memory.\n");
+        return -1;
+    }
+    req->file = true;
+    req->fd   = fd;
+    req->foff = offset;
+    req->len  = len;
+    req->conn = self;
+
+    int ret = _async_tcp_send_account(self, len);
+
+    _async_tcp_dispatch(self->loop, _async_tcp_send, req);
+    return ret;
+}
+
+void xcomm_async_tcp_set_send_watermark(
+    xcomm_tcp_connection_t* conn, size_t low, size_t high) {
+    async_tcp_connection_t* self = conn->opaque;
+
+    if (low > high) {
+        low = high;
+    }
+    atomic_store(&self->backpressure.low, low);
+    atomic_store(&self->backpressure.high, high);
+}
+
+void xcomm_async_tcp_set_writable_cb(
+    xcomm_tcp_connection_t* conn,
+    xcomm_tcp_writable_cb_t writable_cb,
+    void*                   userdata) {
+    async_tcp_connection_t* self = conn->opaque;
 
+    self->writable_cb = writable_cb;
+    self->writable_ud = userdata;
 }
 
-void xcomm_async_tcp_send(xcomm_tcp_connection_t* conn, void* buf, size_t len) {
+static void _async_tcp_set_idle_option(
+    async_tcp_connection_t* conn, int* option, int value) {
+    async_tcp_option_context_t* context =
+        calloc(1, sizeof(async_tcp_option_context_t));
+    if (!context) {
+        xcomm_loge("no memory.\n");
+        return;
+    }
+    context->conn  = conn;
+    context->value = value;
+    context->ptr   = option;
 
+    _async_tcp_dispatch(conn->loop, _async_tcp_set_idle, context);
 }
 
 void xcomm_async_tcp_set_sendtimeo(
     xcomm_tcp_connection_t* conn, int timeout_ms) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
 
+    async_tcp_connection_t* self = conn->opaque;
+    _async_tcp_set_idle_option(self, &self->idle.sendtimeo, timeout_ms);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
 }
 
 void xcomm_async_tcp_set_recvtimeo(
     xcomm_tcp_connection_t* conn, int timeout_ms) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    async_tcp_connection_t* self = conn->opaque;
+    _async_tcp_set_idle_option(self, &self->idle.recvtimeo, timeout_ms);
 
+    xcomm_logi("%s leave.\n", __FUNCTION__);
 }
 
 void xcomm_async_tcp_set_heartbeat_interval(
     xcomm_tcp_connection_t* conn, int interval_ms) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
 
+    async_tcp_connection_t* self = conn->opaque;
+    _async_tcp_set_idle_option(
+        self, &self->idle.heartbeat_interval, interval_ms);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
 }
 
 void xcomm_async_tcp_set_packetizer(
     xcomm_tcp_connection_t* conn, xcomm_tcp_packetizer_t* packetizer) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    async_tcp_connection_t*     self = conn->opaque;
+    async_tcp_option_context_t* context =
+        calloc(1, sizeof(async_tcp_option_context_t));
+    if (!context) {
+        xcomm_loge("no memory.\n");
+        return;
+    }
+    if (packetizer) {
+        context->ptr = malloc(sizeof(tcp_packetizer_t));
+        if (!context->ptr) {
+            xcomm_loge("no memory.\n");
+            free(context);
+            return;
+        }
+        if (xcomm_tcp_packetizer_init(context->ptr, packetizer)) {
+            xcomm_loge("invalid tcp packetizer.\n");
+            free(context->ptr);
+            free(context);
+            return;
+        }
+    }
+    context->conn = self;
+
+    _async_tcp_dispatch(self->loop, _async_tcp_set_packetizer, context);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+}
+
+void xcomm_async_tcp_set_zerocopy(xcomm_tcp_connection_t* conn, bool enable) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    async_tcp_connection_t*     self = conn->opaque;
+    async_tcp_option_context_t* context =
+        calloc(1, sizeof(async_tcp_option_context_t));
+    if (!context) {
+        xcomm_loge("no memory.\n");
+        return;
+    }
+    context->conn  = self;
+    context->value = enable;
+
+    _async_tcp_dispatch(self->loop, _async_tcp_set_zerocopy, context);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+}
+
+/** a connection closed before the sample is taken reports stats NULL. */
+void xcomm_async_tcp_get_stats(
+    xcomm_tcp_connection_t* conn, xcomm_tcp_stats_cb_t stats_cb, void* userdata) {
+    async_tcp_connection_t*    self = conn->opaque;
+    async_tcp_stats_context_t* context =
+        calloc(1, sizeof(async_tcp_stats_context_t));
+    if (!context) {
+        xcomm_loge("no memory.\n");
+        return;
+    }
+    context->conn     = self;
+    context->stats_cb = stats_cb;
+    context->userdata = userdata;
+
+    _async_tcp_dispatch(self->loop, _async_tcp_get_stats, context);
+}
+
+/** worker is the engine worker index, from 0 to the concurrency. */
+void xcomm_async_tcp_collect_stats(
+    int worker, xcomm_tcp_stats_cb_t stats_cb, void* userdata) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    if (worker < 0 || worker >= engine.concurrency) {
+        xcomm_loge("no such worker %d.\n", worker);
+        return;
+    }
+    engine_worker_t** workers =
+        malloc(sizeof(engine_worker_t*) * engine.concurrency);
+    async_tcp_stats_context_t* context =
+        calloc(1, sizeof(async_tcp_stats_context_t));
+    if (!workers || !context) {
+        xcomm_loge("no memory.\n");
+        free(workers);
+        free(context);
+        return;
+    }
+    engine.snapshot(workers, engine.concurrency);
+
+    context->loop     = &workers[worker]->looper;
+    context->stats_cb = stats_cb;
+    context->userdata = userdata;
+    free(workers);
+
+    _async_tcp_dispatch(context->loop, _async_tcp_collect_stats, context);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+}
+
+/**
+ * bytes still queued by send or held by a packetizer are carried over ahead
+ * of the relayed ones, up to one chunk each way. a pending send_file fails
+ * the relay.
+ */
+int xcomm_async_tcp_relay(
+    xcomm_tcp_connection_t*    front,
+    xcomm_tcp_connection_t*    back,
+    xcomm_tcp_relay_close_cb_t relay_close_cb,
+    void*                      userdata) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    async_tcp_connection_t* ends[2] = {front->opaque, back->opaque};
+
+    if (ends[0] == ends[1]) {
+        xcomm_loge("tcp relay needs two connections.\n");
+        return -1;
+    }
+    if (ends[0]->tls || ends[1]->tls) {
+        xcomm_loge("tcp relay needs plain connections.\n");
+        return -1;
+    }
+    async_tcp_relay_t* relay = calloc(1, sizeof(async_tcp_relay_t));
+    if (!relay) {
+        xcomm_loge("no memory.\n");
+        return -1;
+    }
+    relay->loop     = ends[0]->loop;
+    relay->close_cb = relay_close_cb;
+    relay->close_ud = userdata;
+    atomic_init(&relay->detached, 0);
+
+    for (int i = 0; i < 2; i++) {
+        relay->ends[i].relay = relay;
+        relay->ends[i].conn  = ends[i];
+        relay->ends[i].sock  = PLATFORM_SO_ERROR_INVALID_SOCKET;
+        relay->dirs[i].pipe[0] = relay->dirs[i].pipe[1] = -1;
+    }
+    for (int i = 0; i < 2; i++) {
+        _async_tcp_dispatch(
+            ends[i]->loop, _async_tcp_relay_detach, &relay->ends[i]);
+    }
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+    return 0;
+}
+
+void xcomm_async_tcp_set_default_sockopts(const xcomm_tcp_sockopts_t* opts) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    xcomm_tcp_sockopts_store(&async_tcp_sockopts, opts);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+}
+
+void xcomm_async_tcp_set_sockopts(
+    xcomm_tcp_connection_t* conn, const xcomm_tcp_sockopts_t* opts) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    async_tcp_connection_t*     self = conn->opaque;
+    async_tcp_option_context_t* context =
+        calloc(1, sizeof(async_tcp_option_context_t));
+    if (!context) {
+        xcomm_loge("no memory.\n");
+        return;
+    }
+    if (opts) {
+        context->ptr = malloc(sizeof(xcomm_tcp_sockopts_t));
+        if (!context->ptr) {
+            xcomm_loge("no memory.\n");
+            free(context);
+            return;
+        }
+        memcpy(context->ptr, opts, sizeof(xcomm_tcp_sockopts_t));
+    }
+    context->conn = self;
+
+    _async_tcp_dispatch(self->loop, _async_tcp_set_sockopts, context);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+}
+
+void xcomm_async_tcp_destroy_pool(xcomm_tcp_pool_t* pool) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    tcp_pool_t*  self = pool->opaque;
+    xcomm_list_t waiters;
+
+    xcomm_list_init(&waiters);
+
+    mtx_lock(&self->mtx);
+    self->closing = true;
+
+    xcomm_rbtree_node_t* node = xcomm_rbtree_first(&self->keys);
+    while (node) {
+        tcp_pool_key_t* key = xcomm_rbtree_data(node, tcp_pool_key_t, node);
+        node = xcomm_rbtree_next(node);
+
+        xcomm_list_node_t* idle = xcomm_list_head(&key->idle);
+        while (idle != xcomm_list_sentinel(&key->idle)) {
+            async_tcp_connection_t* conn =
+                xcomm_list_data(idle, async_tcp_connection_t, pool.node);
+            idle = xcomm_list_next(idle);
+
+            xcomm_event_routine_add(conn->loop, _async_tcp_pool_evict, conn);
+        }
+        while (!xcomm_list_empty(&key->waiters)) {
+            xcomm_list_node_t* waiter = xcomm_list_head(&key->waiters);
+            xcomm_list_remove(waiter);
+            xcomm_list_insert_tail(&waiters, waiter);
+        }
+    }
+    mtx_unlock(&self->mtx);
+
+    while (!xcomm_list_empty(&waiters)) {
+        xcomm_list_node_t* waiter = xcomm_list_head(&waiters);
+        xcomm_list_remove(waiter);
+
+        async_tcp_checkout_context_t* context =
+            xcomm_list_data(waiter, async_tcp_checkout_context_t, node);
+        if (context->connect_cb) {
+            int err = PLATFORM_SO_ERROR_ECONNABORTED;
+            context->connect_cb(
+                NULL, err, platform_socket_tostring(err), context->userdata);
+        }
+        _async_tcp_pool_checkout_free(context);
+    }
+    /** members and pending checkouts keep the pool alive until they finish. */
+    xcomm_tcp_pool_unref(self);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+}
+
+/**
+ * connect_cb gets the most recently returned healthy connection for
+ * host:port or a newly dialed one. while max_active connections are out the
+ * checkout waits for one to come back or close.
+ */
+void xcomm_async_tcp_checkout(
+    xcomm_tcp_pool_t*      pool,
+    const char* restrict   host,
+    const char* restrict   port,
+    xcomm_tcp_connect_cb_t connect_cb,
+    void*                  userdata) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    tcp_pool_t* self = pool->opaque;
+
+    async_tcp_checkout_context_t* context =
+        calloc(1, sizeof(async_tcp_checkout_context_t));
+    if (!context) {
+        xcomm_loge("no memory.\n");
+        return;
+    }
+    context->connect_cb = connect_cb;
+    context->userdata   = userdata;
+
+    mtx_lock(&self->mtx);
+    context->key = xcomm_tcp_pool_key(self, host, port);
+    if (!context->key) {
+        mtx_unlock(&self->mtx);
+        xcomm_loge("no memory.\n");
+        free(context);
+        return;
+    }
+    xcomm_tcp_pool_ref(self);
+    mtx_unlock(&self->mtx);
+
+    _async_tcp_pool_checkout(context);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+}
+
+/**
+ * returns a checked out connection to its pool, connections that were not
+ * checked out, or that do not fit under max_idle, are closed.
+ */
+void xcomm_async_tcp_checkin(xcomm_tcp_connection_t* conn) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    async_tcp_connection_t* self = conn->opaque;
+    _async_tcp_dispatch(self->loop, _async_tcp_pool_checkin, self);
 
+    xcomm_logi("%s leave.\n", __FUNCTION__);
 }
@@ -21,13 +21,203 @@
 
 _Pragma("once")
 
+#include <stdatomic.h>
+
+#include "xcomm-list.h"
+#include "xcomm-slab.h"
+#include "xcomm-event-io.h"
+#include "xcomm-event-timer.h"
+#include "xcomm-tcp-pool.h"
+#include "xcomm-tcp-tls.h"
+#include "xcomm-tcp-packetizer.h"
 #include "xcomm/xcomm-tcp-module.h"
+#include "platform/platform-types.h"
+
+#define ASYNC_TCP_RECV_BUFSIZE       65536
+#define ASYNC_TCP_RELAY_CHUNK        65536
+#define ASYNC_TCP_ZEROCOPY_THRESHOLD 16384
+#define ASYNC_TCP_ACCEPT_BATCH       128
+#define ASYNC_TCP_SLAB_CHUNK         64
+#define ASYNC_TCP_SLAB_WARMUP        256
+#define ASYNC_TCP_IDLE_TICK          100
+#define ASYNC_TCP_IDLE_WHEEL         256
+#define ASYNC_TCP_SEND_LOW_WATERMARK  (1024 * 1024)
+#define ASYNC_TCP_SEND_HIGH_WATERMARK (4 * 1024 * 1024)
+
+typedef struct async_tcp_worker_s     async_tcp_worker_t;
+typedef struct async_tcp_send_req_s   async_tcp_send_req_t;
+typedef struct async_tcp_connection_s async_tcp_connection_t;
+typedef struct async_tcp_listener_s   async_tcp_listener_t;
+typedef struct async_tcp_listener_shard_s async_tcp_listener_shard_t;
+
+/**
+ * per worker state, connections with a timeout or heartbeat sit in a coarse
+ * timing wheel that is swept once per tick while nidle of them are linked,
+ * the data path only stamps the clock the loop keeps. conns holds every
+ * established connection for stats. pinned counts the sharded listener
+ * shards holding the worker on its cpu.
+ */
+struct async_tcp_worker_s {
+    xcomm_slab_t         slab;
+    int                  pinned;
+    xcomm_event_timer_t* sweep_timer;
+    size_t               nidle;
+    uint64_t             now;
+    uint64_t             tick;
+    xcomm_list_t         wheel[ASYNC_TCP_IDLE_WHEEL];
+    xcomm_list_t         conns;
+};
+
+/** a send_file request has no buf, its bytes come from fd at foff + off. */
+struct async_tcp_send_req_s {
+    char*                   buf;
+    size_t                  len;
+    size_t                  off;
+    bool                    file;
+    int                     fd;
+    int64_t                 foff;
+    uint64_t                queued;
+    uint64_t                zc_first;
+    uint64_t                zc_count;
+    uint64_t                zc_done;
+    async_tcp_connection_t* conn;
+    xcomm_list_node_t       node;
+};
+
+struct async_tcp_connection_s {
+    xcomm_tcp_connection_t handle;
+    platform_sock_t        sock;
+    xcomm_event_loop_t*    loop;
+    async_tcp_worker_t*    worker;
+    xcomm_event_io_t       io;
+    bool                   registered;
+    bool                   connected;
+    bool                   closed;
+    xcomm_list_t           sendq;
+    tcp_packetizer_t*      packetizer;
+    bool                   quickack;
+    bool                   local;
+    xcomm_list_node_t      node;
+    tcp_pool_member_t      pool;
+    tcp_tls_conn_t*        tls;
+
+    /**
+     * set while a handshake step runs on the engine crypto pool, the memory
+     * stays until the step is back on the loop even if closed meanwhile.
+     */
+    struct {
+        bool busy;
+        bool orphaned;
+        int  rc;
+    } offload;
+
+    xcomm_tcp_connect_cb_t          connect_cb;
+    void*                           connect_ud;
+    xcomm_tcp_recv_cb_t             recv_cb;
+    void*                           recv_ud;
+    xcomm_tcp_send_completed_cb_t   send_completed_cb;
+    void*                           send_completed_ud;
+    xcomm_tcp_heartbeat_cb_t        heartbeat_cb;
+    void*                           heartbeat_ud;
+    xcomm_tcp_writable_cb_t         writable_cb;
+    void*                           writable_ud;
+    xcomm_tcp_connection_close_cb_t close_cb;
+    void*                           close_ud;
+
+    /**
+     * buffers sent with MSG_ZEROCOPY stay pinned until the kernel reports
+     * them on the error queue, requests wait in inflight until then.
+     */
+    struct {
+        bool         enabled;
+        uint64_t     next_id;
+        xcomm_list_t inflight;
+    } zerocopy;
+
+    /**
+     * pending counts bytes handed to send and not yet completed, it is
+     * raised by the caller thread so send can answer without a round trip.
+     * the watermarks are read there too.
+     */
+    struct {
+        atomic_size_t pending;
+        atomic_bool   throttled;
+        atomic_size_t low;
+        atomic_size_t high;
+    } backpressure;
+
+    struct {
+        int               recvtimeo;
+        int               sendtimeo;
+        int               heartbeat_interval;
+        uint64_t          last_recv;
+        uint64_t          last_send;
+        uint64_t          last_heartbeat;
+        bool              linked;
+        xcomm_list_node_t node;
+    } idle;
+
+    struct {
+        uint64_t          bytes_in;
+        uint64_t          bytes_out;
+        uint64_t          sends;
+        uint64_t          queue_time_us;
+        bool              linked;
+        xcomm_list_node_t node;
+    } stats;
+};
+
+struct async_tcp_listener_shard_s {
+    int                   idx;
+    platform_sock_t       sock;
+    xcomm_event_loop_t*   loop;
+    xcomm_event_io_t      io;
+    bool                  registered;
+    bool                  closed;
+    bool                  pinned;
+    async_tcp_listener_t* listener;
+};
+
+/**
+ * a plain listener has a single shard and spreads accepted connections over
+ * the workers, a sharded one owns a reuseport socket on every worker and
+ * keeps each connection on the worker that accepted it. steered is set when
+ * there is a shard per cpu and the kernel picks the shard by receiving cpu.
+ */
+struct async_tcp_listener_s {
+    xcomm_tcp_listener_t          handle;
+    bool                          sharded;
+    bool                          steered;
+    bool                          affinity;
+    bool                          local;
+    atomic_bool                   closed;
+    atomic_int                    alive;
+    int                           accept_batch;
+    tcp_tls_t*                    tls;
+    xcomm_tcp_accept_cb_t         accept_cb;
+    void*                         accept_ud;
+    xcomm_tcp_listener_close_cb_t close_cb;
+    void*                         close_ud;
+    int                           nshards;
+    async_tcp_listener_shard_t    shards[];
+};
+
+extern void xcomm_async_tcp_startup(int concurrency);
+extern void xcomm_async_tcp_cleanup(void);
+extern void xcomm_async_tcp_worker_exit(xcomm_event_loop_t* loop);
 
 extern void xcomm_async_tcp_dial(const char* restrict host, const char* restrict port, int timeout_ms, xcomm_tcp_connect_cb_t connect_cb, void* userdata);
+extern void xcomm_async_tcp_dial_tls(xcomm_tcp_tls_t* tls, const char* restrict host, const char* restrict port, int timeout_ms, xcomm_tcp_connect_cb_t connect_cb, void* userdata);
 extern void xcomm_async_tcp_listen(const char* restrict host, const char* restrict port, xcomm_tcp_listen_cb_t listen_cb, void* userdata);
+extern void xcomm_async_tcp_listen_sharded(const char* restrict host, const char* restrict port, xcomm_tcp_listen_cb_t listen_cb, void* userdata);
+extern void xcomm_async_tcp_dial_unix(const char* restrict path, int timeout_ms, xcomm_tcp_connect_cb_t connect_cb, void* userdata);
+extern void xcomm_async_tcp_listen_unix(const char* restrict path, xcomm_tcp_listen_cb_t listen_cb, void* userdata);
 
+extern void xcomm_async_tcp_set_accept_batch(xcomm_tcp_listener_t* listener, int batch);
+extern void xcomm_async_tcp_set_listener_affinity(xcomm_tcp_listener_t* listener, bool on);
 extern void xcomm_async_tcp_set_accept_cb(xcomm_tcp_listener_t* listener, xcomm_tcp_accept_cb_t accept_cb, void* userdata);
 extern void xcomm_async_tcp_set_listener_close_cb(xcomm_tcp_listener_t* listener, xcomm_tcp_listener_close_cb_t listener_close_cb, void* userdata);
+extern void xcomm_async_tcp_set_listener_tls(xcomm_tcp_listener_t* listener, xcomm_tcp_tls_t* tls);
 extern void xcomm_async_tcp_close_listener(xcomm_tcp_listener_t* listener);
 
 extern void xcomm_async_tcp_set_recv_cb(xcomm_tcp_connection_t* conn, xcomm_tcp_recv_cb_t recv_cb, void* userdata);
@@ -35,8 +225,20 @@ extern void xcomm_async_tcp_set_send_completed_cb(xcomm_tcp_connection_t* conn,
 extern void xcomm_async_tcp_set_connection_close_cb(xcomm_tcp_connection_t* conn, xcomm_tcp_connection_close_cb_t connection_close_cb, void* userdata);
 extern void xcomm_async_tcp_close_connection(xcomm_tcp_connection_t* conn);
 extern void xcomm_async_tcp_set_heartbeat_cb(xcomm_tcp_connection_t* conn, xcomm_tcp_heartbeat_cb_t heartbeat_cb, void* userdata);
-extern void xcomm_async_tcp_send(xcomm_tcp_connection_t* conn, void* buf, size_t len);
+extern int  xcomm_async_tcp_send(xcomm_tcp_connection_t* conn, void* buf, size_t len);
+extern int  xcomm_async_tcp_send_file(xcomm_tcp_connection_t* conn, int fd, int64_t offset, size_t len);
+extern void xcomm_async_tcp_set_send_watermark(xcomm_tcp_connection_t* conn, size_t low, size_t high);
+extern void xcomm_async_tcp_set_writable_cb(xcomm_tcp_connection_t* conn, xcomm_tcp_writable_cb_t writable_cb, void* userdata);
 extern void xcomm_async_tcp_set_sendtimeo(xcomm_tcp_connection_t* conn, int timeout_ms);
 extern void xcomm_async_tcp_set_recvtimeo(xcomm_tcp_connection_t* conn, int timeout_ms);
 extern void xcomm_async_tcp_set_heartbeat_interval(xcomm_tcp_connection_t* conn, int interval_ms);
-extern void xcomm_async_tcp_set_packetizer(xcomm_tcp_connection_t* conn, xcomm_tcp_packetizer_t* packetizer);
\ No newline at end of file
+extern void xcomm_async_tcp_set_packetizer(xcomm_tcp_connection_t* conn, xcomm_tcp_packetizer_t* packetizer);
+extern void xcomm_async_tcp_set_zerocopy(xcomm_tcp_connection_t* conn, bool enable);
+extern int  xcomm_async_tcp_relay(xcomm_tcp_connection_t* front, xcomm_tcp_connection_t* back, xcomm_tcp_relay_close_cb_t relay_close_cb, void* userdata);
+extern void xcomm_async_tcp_get_stats(xcomm_tcp_connection_t* conn, xcomm_tcp_stats_cb_t stats_cb, void* userdata);
+extern void xcomm_async_tcp_collect_stats(int worker, xcomm_tcp_stats_cb_t stats_cb, void* userdata);
+extern void xcomm_async_tcp_set_default_sockopts(const xcomm_tcp_sockopts_t* opts);
+extern void xcomm_async_tcp_set_sockopts(xcomm_tcp_connection_t* conn, const xcomm_tcp_sockopts_t* opts);
+extern void xcomm_async_tcp_destroy_pool(xcomm_tcp_pool_t* pool);
+extern void xcomm_async_tcp_checkout(xcomm_tcp_pool_t* pool, const char* restrict host, const char* restrict port, xcomm_tcp_connect_cb_t connect_cb, void* userdata);
+extern void xcomm_async_tcp_checkin(xcomm_tcp_connection_t* conn);
@@ -19,9 +19,80 @@
  *  IN THE SOFTWARE.
  */
 
+#include "xcomm-utils.h"
 #include "xcomm-logger.h"
 #include "xcomm-sync-tcp.h"
+#include "xcomm-tcp-eyeballs.h"
+#include "xcomm-tcp-sockopts.h"
 #include "platform/platform-socket.h"
+#include "deprecated/c11-threads.h"
+
+static once_flag    sync_tcp_slab_once = ONCE_FLAG_INIT;
+static xcomm_slab_t sync_tcp_slab;
+
+static tcp_sockopts_default_t sync_tcp_sockopts;
+
+/**
+ * connections are shared by whatever threads use the blocking api, so one
+ * warm slab serves all of them.
+ */
+static void _sync_tcp_slab_setup(void) {
+    xcomm_slab_init(
+        &sync_tcp_slab, sizeof(sync_tcp_connection_t), SYNC_TCP_SLAB_CHUNK);
+    xcomm_slab_reserve(&sync_tcp_slab, SYNC_TCP_SLAB_WARMUP);
+}
+
+static sync_tcp_connection_t* _sync_tcp_connection_create(void) {
+    call_once(&sync_tcp_slab_once, _sync_tcp_slab_setup);
+
+    sync_tcp_connection_t* conn = xcomm_slab_alloc(&sync_tcp_slab);
+    if (!conn) {
+        return NULL;
+    }
+    conn->handle.opaque = conn;
+    conn->sock          = PLATFORM_SO_ERROR_INVALID_SOCKET;
+    conn->pool.key      = NULL;
+    conn->pool.state    = TCP_POOL_STATE_NONE;
+    return conn;
+}
+
+static void _sync_tcp_connection_free(sync_tcp_connection_t* conn) {
+    platform_socket_close(conn->sock);
+    xcomm_slab_free(&sync_tcp_slab, conn);
+}
+
+/** caller holds the pool mutex and drops the reference after unlocking. */
+static void _sync_tcp_pool_leave(sync_tcp_connection_t* conn) {
+    tcp_pool_key_t* key = conn->pool.key;
+
+    if (conn->pool.state == TCP_POOL_STATE_IDLE) {
+        xcomm_list_remove(&conn->pool.node);
+        key->nidle--;
+    } else {
+        key->nactive--;
+        cnd_broadcast(&key->pool->cnd);
+    }
+    conn->pool.key   = NULL;
+    conn->pool.state = TCP_POOL_STATE_NONE;
+}
+
+/** idle connections are kept newest first, so expired ones gather at the tail. */
+static int _sync_tcp_pool_evict(tcp_pool_key_t* key, uint64_t now) {
+    int timeout = key->pool->config.idle_timeout_ms;
+    int n = 0;
+
+    while (timeout > 0 && !xcomm_list_empty(&key->idle)) {
+        sync_tcp_connection_t* conn = xcomm_list_data(
+            xcomm_list_tail(&key->idle), sync_tcp_connection_t, pool.node);
+        if (now - conn->pool.since < (uint64_t)timeout) {
+            break;
+        }
+        _sync_tcp_pool_leave(conn);
+        _sync_tcp_connection_free(conn);
+        n++;
+    }
+    return n;
+}
 
 void xcomm_sync_tcp_close_listener(xcomm_tcp_listener_t* listener) {
     xcomm_logi("%s enter.\n", __FUNCTION__);
@@ -37,49 +108,49 @@ void xcomm_sync_tcp_close_listener(xcomm_tcp_listener_t* listener) {
 void xcomm_sync_tcp_close_connection(xcomm_tcp_connection_t* conn) {
     xcomm_logi("%s enter.\n", __FUNCTION__);
 
-    platform_sock_t* sock = conn->opaque;
-    platform_socket_close(*sock);
+    sync_tcp_connection_t* self = conn->opaque;
+    tcp_pool_key_t*        key  = self->pool.key;
+
+    if (key) {
+        tcp_pool_t* pool = key->pool;
 
-    free(conn->opaque);
-    free(conn);
+        mtx_lock(&pool->mtx);
+        _sync_tcp_pool_leave(self);
+        mtx_unlock(&pool->mtx);
+        xcomm_tcp_pool_unref(pool);
+    }
+    _sync_tcp_connection_free(self);
 
     xcomm_logi("%s leave.\n", __FUNCTION__);
 }
 
-xcomm_tcp_connection_t*
-xcomm_sync_tcp_dial(const char* restrict host, const char* restrict port) {
-    xcomm_logi("%s enter.\n", __FUNCTION__);
-
-    xcomm_tcp_connection_t* conn = malloc(sizeof(xcomm_tcp_connection_t));
+/** unix domain sockets have no tcp level options to apply. */
+static xcomm_tcp_connection_t* _sync_tcp_dial(
+    xcomm_resolver_addrs_t* addrs, int timeout_ms, bool local) {
+    sync_tcp_connection_t* conn = _sync_tcp_connection_create();
     if (!conn) {
         xcomm_loge("no memory.\n");
         return NULL;
     }
-    conn->opaque = malloc(sizeof(platform_sock_t));
-    if (!conn->opaque) {
-        xcomm_loge("no memory.\n");
-        free(conn);
-        return NULL;
-    }
-    bool noused;
-    platform_sock_t sock =
-        platform_socket_dial(host, port, SOCK_STREAM, &noused, false);
-    if (sock != PLATFORM_SO_ERROR_INVALID_SOCKET) {
-        memcpy(conn->opaque, &sock, sizeof(platform_sock_t));
-    } else {
+    xcomm_tcp_sockopts_t        storage;
+    const xcomm_tcp_sockopts_t* opts =
+        xcomm_tcp_sockopts_load(&sync_tcp_sockopts, &storage);
+
+    conn->sock = xcomm_tcp_eyeballs_connect(
+        addrs, timeout_ms, local ? NULL : opts);
+    if (conn->sock == PLATFORM_SO_ERROR_INVALID_SOCKET) {
         xcomm_loge("tcp dial error.\n");
-        free(conn->opaque);
-        free(conn);
+        xcomm_slab_free(&sync_tcp_slab, conn);
         return NULL;
     }
-    xcomm_logi("%s leave.\n", __FUNCTION__);
-    return conn;
+    if (!local) {
+        xcomm_tcp_sockopts_apply(conn->sock, opts);
+    }
+    return &conn->handle;
 }
 
-xcomm_tcp_listener_t*
-xcomm_sync_tcp_listen(const char* restrict host, const char* restrict port) {
-    xcomm_logi("%s enter.\n", __FUNCTION__);
-
+static xcomm_tcp_listener_t* _sync_tcp_listen(
+    const char* restrict host, const char* restrict port) {
     xcomm_tcp_listener_t* listener = malloc(sizeof(xcomm_tcp_listener_t));
     if (!listener) {
         xcomm_loge("no memory.\n");
@@ -91,9 +162,18 @@ xcomm_sync_tcp_listen(const char* restrict host, const char* restrict port) {
         free(listener);
         return NULL;
     }
-    platform_sock_t sock =
-        platform_socket_listen(host, port, SOCK_STREAM, 0, 0, false);
+    /** a NULL port means host is the path of a unix domain socket. */
+    platform_sock_t sock = port
+        ? platform_socket_listen(host, port, SOCK_STREAM, 0, 0, false)
+        : platform_socket_listen_unix(host, false);
     if (sock != PLATFORM_SO_ERROR_INVALID_SOCKET) {
+        /** mss has to be on the listening socket to reach the syn-ack. */
+        if (port) {
+            xcomm_tcp_sockopts_t storage;
+
+            xcomm_tcp_sockopts_apply(
+                sock, xcomm_tcp_sockopts_load(&sync_tcp_sockopts, &storage));
+        }
         memcpy(listener->opaque, &sock, sizeof(platform_sock_t));
     } else {
         xcomm_loge("tcp listen error.\n");
@@ -101,65 +181,268 @@ xcomm_sync_tcp_listen(const char* restrict host, const char* restrict port) {
         free(listener);
         return NULL;
     }
-    xcomm_logi("%s leave.\n", __FUNCTION__);
     return listener;
 }
 
-xcomm_tcp_connection_t* xcomm_sync_tcp_accept(xcomm_tcp_listener_t* listener) {
-    xcomm_logi("%s enter.\n", __FUNCTION__);
-
+static xcomm_tcp_connection_t*
+_sync_tcp_accept(xcomm_tcp_listener_t* listener, bool local) {
     platform_sock_t* srv_sock = listener->opaque;
 
-    xcomm_tcp_connection_t* conn = malloc(sizeof(xcomm_tcp_connection_t));
+    sync_tcp_connection_t* conn = _sync_tcp_connection_create();
     if (!conn) {
         xcomm_loge("no memory.\n");
         return NULL;
     }
-    conn->opaque = malloc(sizeof(platform_sock_t));
-    if (!conn->opaque) {
-        xcomm_loge("no memory.\n");
-        free(conn);
+    conn->sock = platform_socket_accept(*srv_sock, false);
+    if (conn->sock == PLATFORM_SO_ERROR_INVALID_SOCKET) {
+        xcomm_loge("tcp accept error.\n");
+        xcomm_slab_free(&sync_tcp_slab, conn);
         return NULL;
     }
-    platform_sock_t cli_sock = platform_socket_accept(*srv_sock, false);
-    if (cli_sock != PLATFORM_SO_ERROR_INVALID_SOCKET) {
-        memcpy(conn->opaque, &cli_sock, sizeof(platform_sock_t));
-    } else {
-        xcomm_loge("tcp accept error.\n");
-        free(conn->opaque);
-        free(conn);
+    if (!local) {
+        xcomm_tcp_sockopts_t storage;
+
+        xcomm_tcp_sockopts_apply(
+            conn->sock, xcomm_tcp_sockopts_load(&sync_tcp_sockopts, &storage));
+    }
+    return &conn->handle;
+}
+
+xcomm_tcp_connection_t*
+xcomm_sync_tcp_dial(
+    const char* restrict host, const char* restrict port, int timeout_ms) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    xcomm_resolver_addrs_t addrs;
+
+    addrs.naddrs = platform_socket_getaddrinfo(
+        host, port, SOCK_STREAM, addrs.addrs, addrs.addrlens, XCOMM_RESOLVER_MAXADDRS);
+    if (addrs.naddrs <= 0) {
+        xcomm_loge("tcp resolve error.\n");
+        return NULL;
+    }
+    xcomm_tcp_eyeballs_interleave(&addrs);
+
+    xcomm_tcp_connection_t* conn = _sync_tcp_dial(&addrs, timeout_ms, false);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+    return conn;
+}
+
+xcomm_tcp_connection_t*
+xcomm_sync_tcp_dial_unix(const char* restrict path, int timeout_ms) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    xcomm_resolver_addrs_t addrs;
+
+    if (platform_socket_unix_address(path, &addrs.addrs[0], &addrs.addrlens[0])) {
+        xcomm_loge("unix socket path invalid.\n");
         return NULL;
     }
+    addrs.naddrs = 1;
+
+    xcomm_tcp_connection_t* conn = _sync_tcp_dial(&addrs, timeout_ms, true);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+    return conn;
+}
+
+xcomm_tcp_listener_t*
+xcomm_sync_tcp_listen(const char* restrict host, const char* restrict port) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    xcomm_tcp_listener_t* listener = _sync_tcp_listen(host, port);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+    return listener;
+}
+
+xcomm_tcp_listener_t* xcomm_sync_tcp_listen_unix(const char* restrict path) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    xcomm_tcp_listener_t* listener = _sync_tcp_listen(path, NULL);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+    return listener;
+}
+
+xcomm_tcp_connection_t* xcomm_sync_tcp_accept(xcomm_tcp_listener_t* listener) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    xcomm_tcp_connection_t* conn = _sync_tcp_accept(listener, false);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+    return conn;
+}
+
+xcomm_tcp_connection_t*
+xcomm_sync_tcp_accept_unix(xcomm_tcp_listener_t* listener) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    xcomm_tcp_connection_t* conn = _sync_tcp_accept(listener, true);
+
     xcomm_logi("%s leave.\n", __FUNCTION__);
     return conn;
 }
 
-int xcomm_sync_tcp_send(xcomm_tcp_connection_t* conn, void* buf, int len) {
-    platform_sock_t* sock = conn->opaque;
+/**
+ * moves every byte of the vector, a syscall takes up to PLATFORM_SO_IOV_MAX
+ * entries starting at the first one not yet done. a receive stops short only
+ * at end of stream.
+ */
+static int64_t _sync_tcp_transferv(
+    sync_tcp_connection_t*   self,
+    const xcomm_tcp_iovec_t* iov,
+    int                      iovcnt,
+    bool                     sending) {
+    platform_iovec_t vec[PLATFORM_SO_IOV_MAX];
+    int64_t          total = 0;
+    size_t           off   = 0;
+    int              idx   = 0;
+
+    while (true) {
+        while (idx < iovcnt && off == iov[idx].len) {
+            idx++;
+            off = 0;
+        }
+        if (idx == iovcnt) {
+            return total;
+        }
+        int cnt = 0;
+        for (int i = idx; i < iovcnt && cnt < PLATFORM_SO_IOV_MAX; i++) {
+            vec[cnt].base = (char*)iov[i].base + (i == idx ? off : 0);
+            vec[cnt].len  = iov[i].len - (i == idx ? off : 0);
+            cnt++;
+        }
+        ssize_t n = sending ? platform_socket_sendv(self->sock, vec, cnt)
+                            : platform_socket_recvv(self->sock, vec, cnt);
+        if (n == PLATFORM_SO_ERROR_SOCKET_ERROR) {
+            return -1;
+        }
+        if (n == 0 && !sending) {
+            return total;
+        }
+        total += n;
+        while (n > 0) {
+            size_t step = iov[idx].len - off;
+            if ((size_t)n < step) {
+                off += n;
+                break;
+            }
+            n  -= step;
+            off = 0;
+            idx++;
+        }
+    }
+}
+
+int64_t xcomm_sync_tcp_send(xcomm_tcp_connection_t* conn, void* buf, size_t len) {
+    sync_tcp_connection_t* self = conn->opaque;
+
+    ssize_t ret = platform_socket_sendall(self->sock, buf, len);
+    if (ret == PLATFORM_SO_ERROR_SOCKET_ERROR) {
+        return -1;
+    }
+    return ret;
+}
+
+int64_t xcomm_sync_tcp_recv(xcomm_tcp_connection_t* conn, void* buf, size_t len) {
+    sync_tcp_connection_t* self = conn->opaque;
+
+    ssize_t ret = platform_socket_recvall(self->sock, buf, len);
+    if (ret == PLATFORM_SO_ERROR_SOCKET_ERROR) {
+        return -1;
+    }
+    return ret;
+}
+
+int64_t xcomm_sync_tcp_sendv(
+    xcomm_tcp_connection_t* conn, const xcomm_tcp_iovec_t* iov, int iovcnt) {
+    return _sync_tcp_transferv(conn->opaque, iov, iovcnt, true);
+}
+
+int64_t xcomm_sync_tcp_recvv(
+    xcomm_tcp_connection_t* conn, const xcomm_tcp_iovec_t* iov, int iovcnt) {
+    return _sync_tcp_transferv(conn->opaque, iov, iovcnt, false);
+}
+
+/** stops short only when the file ends before offset + len. */
+int64_t xcomm_sync_tcp_send_file(
+    xcomm_tcp_connection_t* conn, int fd, int64_t offset, int64_t len) {
+    sync_tcp_connection_t* self  = conn->opaque;
+    int64_t                total = 0;
+
+    while (total < len) {
+        ssize_t n = platform_socket_sendfile(
+            self->sock, fd, offset + total, (size_t)(len - total));
+        if (n == PLATFORM_SO_ERROR_SOCKET_ERROR) {
+            return -1;
+        }
+        if (n == 0) {
+            break;
+        }
+        total += n;
+    }
+    return total;
+}
+
+/** returns what has arrived, blocking only while nothing has, 0 at the end. */
+int64_t xcomm_sync_tcp_recv_some(
+    xcomm_tcp_connection_t* conn, void* buf, size_t len) {
+    sync_tcp_connection_t* self = conn->opaque;
 
-    int ret = (int)platform_socket_sendall(*sock, buf, len);
+    ssize_t ret = platform_socket_recv(
+        self->sock, buf, (len > INT_MAX) ? INT_MAX : (int)len);
     if (ret == PLATFORM_SO_ERROR_SOCKET_ERROR) {
         return -1;
     }
     return ret;
 }
 
-int xcomm_sync_tcp_recv(xcomm_tcp_connection_t* conn, void* buf, int len) {
-    platform_sock_t* sock = conn->opaque;
+/** like recv_some, but the bytes stay queued for the next receive. */
+int64_t xcomm_sync_tcp_peek(
+    xcomm_tcp_connection_t* conn, void* buf, size_t len) {
+    sync_tcp_connection_t* self = conn->opaque;
 
-    int ret = (int)platform_socket_recvall(*sock, buf, len);
+    ssize_t ret = platform_socket_peek(
+        self->sock, buf, (len > INT_MAX) ? INT_MAX : (int)len);
     if (ret == PLATFORM_SO_ERROR_SOCKET_ERROR) {
         return -1;
     }
     return ret;
 }
 
+/** the descriptor travels with a single byte, recv_fd consumes it. */
+int xcomm_sync_tcp_send_fd(xcomm_tcp_connection_t* conn, int fd) {
+    sync_tcp_connection_t* self = conn->opaque;
+    char                   c    = 0;
+
+    ssize_t ret = platform_socket_send_fd(self->sock, fd, &c, 1);
+    if (ret != 1) {
+        return -1;
+    }
+    return 0;
+}
+
+/** returns the received descriptor, owned by the caller, or -1. */
+int xcomm_sync_tcp_recv_fd(xcomm_tcp_connection_t* conn) {
+    sync_tcp_connection_t* self = conn->opaque;
+    char                   c;
+    int                    fd;
+
+    ssize_t ret = platform_socket_recv_fd(self->sock, &fd, &c, 1);
+    if (ret != 1) {
+        return -1;
+    }
+    return fd;
+}
+
 void xcomm_sync_tcp_set_sndtimeout(
     xcomm_tcp_connection_t* conn, int timeout_ms) {
     xcomm_logi("%s enter.\n", __FUNCTION__);
 
-    platform_sock_t* sock = conn->opaque;
-    platform_socket_set_sndtimeout(*sock, timeout_ms);
+    sync_tcp_connection_t* self = conn->opaque;
+    platform_socket_set_sndtimeout(self->sock, timeout_ms);
 
     xcomm_logi("%s leave.\n", __FUNCTION__);
 }
@@ -168,8 +451,211 @@ void xcomm_sync_tcp_set_rcvtimeout(
     xcomm_tcp_connection_t* conn, int timeout_ms) {
     xcomm_logi("%s enter.\n", __FUNCTION__);
 
-    platform_sock_t* sock = conn->opaque;
-    platform_socket_set_rcvtimeout(*sock, timeout_ms);
+    sync_tcp_connection_t* self = conn->opaque;
+    platform_socket_set_rcvtimeout(self->sock, timeout_ms);
 
     xcomm_logi("%s leave.\n", __FUNCTION__);
-}
\ No newline at end of file
+}
+
+void xcomm_sync_tcp_set_default_sockopts(const xcomm_tcp_sockopts_t* opts) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    xcomm_tcp_sockopts_store(&sync_tcp_sockopts, opts);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+}
+
+void xcomm_sync_tcp_set_sockopts(
+    xcomm_tcp_connection_t* conn, const xcomm_tcp_sockopts_t* opts) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    sync_tcp_connection_t* self = conn->opaque;
+    xcomm_tcp_sockopts_apply(self->sock, opts);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+}
+
+void xcomm_sync_tcp_destroy_pool(xcomm_tcp_pool_t* pool) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    tcp_pool_t* self = pool->opaque;
+    int         n    = 0;
+
+    mtx_lock(&self->mtx);
+    self->closing = true;
+
+    xcomm_rbtree_node_t* node = xcomm_rbtree_first(&self->keys);
+    while (node) {
+        tcp_pool_key_t* key = xcomm_rbtree_data(node, tcp_pool_key_t, node);
+        node = xcomm_rbtree_next(node);
+
+        while (!xcomm_list_empty(&key->idle)) {
+            sync_tcp_connection_t* conn = xcomm_list_data(
+                xcomm_list_head(&key->idle), sync_tcp_connection_t, pool.node);
+            _sync_tcp_pool_leave(conn);
+            _sync_tcp_connection_free(conn);
+            n++;
+        }
+    }
+    cnd_broadcast(&self->cnd);
+    mtx_unlock(&self->mtx);
+
+    /** checked out connections keep the pool alive until they come back. */
+    for (int i = 0; i < n; i++) {
+        xcomm_tcp_pool_unref(self);
+    }
+    xcomm_tcp_pool_unref(self);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+}
+
+/**
+ * hands out the most recently returned healthy connection for host:port,
+ * otherwise dials a new one. blocks while max_active connections are out,
+ * for at most connect_timeout_ms when it is set, or until the pool is
+ * destroyed. the checkout holds a pool reference while it waits.
+ */
+xcomm_tcp_connection_t* xcomm_sync_tcp_checkout(
+    xcomm_tcp_pool_t* pool, const char* restrict host, const char* restrict port) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    tcp_pool_t*            self = pool->opaque;
+    sync_tcp_connection_t* conn = NULL;
+    int                    nevicted = 0;
+    int                    timeout = self->config.connect_timeout_ms;
+    struct timespec        deadline;
+
+    timespec_get(&deadline, TIME_UTC);
+    deadline.tv_sec  += timeout / 1000;
+    deadline.tv_nsec += (timeout % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    xcomm_tcp_pool_ref(self);
+    mtx_lock(&self->mtx);
+
+    tcp_pool_key_t* key = xcomm_tcp_pool_key(self, host, port);
+    if (!key) {
+        mtx_unlock(&self->mtx);
+        xcomm_tcp_pool_unref(self);
+        xcomm_loge("no memory.\n");
+        return NULL;
+    }
+    while (!conn && !self->closing) {
+        nevicted += _sync_tcp_pool_evict(
+            key, xcomm_utils_getnow(XCOMM_TIME_PRECISION_MSEC));
+
+        while (!xcomm_list_empty(&key->idle)) {
+            conn = xcomm_list_data(
+                xcomm_list_head(&key->idle), sync_tcp_connection_t, pool.node);
+            xcomm_list_remove(&conn->pool.node);
+            key->nidle--;
+
+            if (platform_socket_is_idle(conn->sock)) {
+                conn->pool.state = TCP_POOL_STATE_ACTIVE;
+                key->nactive++;
+                break;
+            }
+            /** closed by the peer or holding stale bytes. */
+            conn->pool.key   = NULL;
+            conn->pool.state = TCP_POOL_STATE_NONE;
+            _sync_tcp_connection_free(conn);
+            conn = NULL;
+            nevicted++;
+        }
+        if (conn || xcomm_tcp_pool_has_slot(key)) {
+            break;
+        }
+        if (timeout > 0) {
+            if (cnd_timedwait(&self->cnd, &self->mtx, &deadline) == thrd_timedout) {
+                break;
+            }
+        } else {
+            cnd_wait(&self->cnd, &self->mtx);
+        }
+    }
+    bool closing = self->closing;
+    bool dial    = !conn && !closing && xcomm_tcp_pool_has_slot(key);
+    if (dial) {
+        /** the slot is held while dialing. */
+        key->nactive++;
+    }
+    mtx_unlock(&self->mtx);
+
+    for (int i = 0; i < nevicted; i++) {
+        xcomm_tcp_pool_unref(self);
+    }
+    if (conn) {
+        xcomm_tcp_pool_unref(self);
+        xcomm_logi("%s leave.\n", __FUNCTION__);
+        return &conn->handle;
+    }
+    if (!dial) {
+        xcomm_tcp_pool_unref(self);
+        if (closing) {
+            xcomm_loge("tcp pool closed.\n");
+        } else {
+            xcomm_loge("tcp pool exhausted.\n");
+        }
+        return NULL;
+    }
+    xcomm_tcp_connection_t* handle = xcomm_sync_tcp_dial(host, port, timeout);
+
+    mtx_lock(&self->mtx);
+    if (handle) {
+        conn = handle->opaque;
+        conn->pool.key   = key;
+        conn->pool.state = TCP_POOL_STATE_ACTIVE;
+        xcomm_tcp_pool_ref(self);
+    } else {
+        key->nactive--;
+        cnd_broadcast(&self->cnd);
+    }
+    mtx_unlock(&self->mtx);
+    xcomm_tcp_pool_unref(self);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+    return handle;
+}
+
+/**
+ * returns a checked out connection to its pool, connections that were not
+ * checked out, or that do not fit under max_idle, are closed.
+ */
+void xcomm_sync_tcp_checkin(xcomm_tcp_connection_t* conn) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    sync_tcp_connection_t* self = conn->opaque;
+    tcp_pool_key_t*        key  = self->pool.key;
+
+    if (!key) {
+        _sync_tcp_connection_free(self);
+        xcomm_logi("%s leave.\n", __FUNCTION__);
+        return;
+    }
+    tcp_pool_t* pool = key->pool;
+
+    /** the next user starts without the previous one's timeouts. */
+    platform_socket_set_rcvtimeout(self->sock, 0);
+    platform_socket_set_sndtimeout(self->sock, 0);
+
+    mtx_lock(&pool->mtx);
+    _sync_tcp_pool_leave(self);
+
+    bool keep = !pool->closing && key->nidle < pool->config.max_idle;
+    if (keep) {
+        self->pool.key   = key;
+        self->pool.state = TCP_POOL_STATE_IDLE;
+        self->pool.since = xcomm_utils_getnow(XCOMM_TIME_PRECISION_MSEC);
+        xcomm_list_insert_head(&key->idle, &self->pool.node);
+        key->nidle++;
+    }
+    mtx_unlock(&pool->mtx);
+
+    if (!keep) {
+        _sync_tcp_connection_free(self);
+        xcomm_tcp_pool_unref(pool);
+    }
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+}
@@ -21,14 +21,43 @@
 
 _Pragma("once")
 
+#include "xcomm-slab.h"
+#include "xcomm-tcp-pool.h"
 #include "xcomm/xcomm-tcp-module.h"
+#include "platform/platform-types.h"
 
-extern xcomm_tcp_connection_t* xcomm_sync_tcp_dial(const char* restrict host, const char* restrict port);
+#define SYNC_TCP_SLAB_CHUNK  16
+#define SYNC_TCP_SLAB_WARMUP 16
+
+typedef struct sync_tcp_connection_s sync_tcp_connection_t;
+
+struct sync_tcp_connection_s {
+    xcomm_tcp_connection_t handle;
+    platform_sock_t        sock;
+    tcp_pool_member_t      pool;
+};
+
+extern xcomm_tcp_connection_t* xcomm_sync_tcp_dial(const char* restrict host, const char* restrict port, int timeout_ms);
 extern xcomm_tcp_listener_t* xcomm_sync_tcp_listen(const char* restrict host, const char* restrict port);
 extern xcomm_tcp_connection_t* xcomm_sync_tcp_accept(xcomm_tcp_listener_t* listener);
+extern xcomm_tcp_connection_t* xcomm_sync_tcp_dial_unix(const char* restrict path, int timeout_ms);
+extern xcomm_tcp_listener_t* xcomm_sync_tcp_listen_unix(const char* restrict path);
+extern xcomm_tcp_connection_t* xcomm_sync_tcp_accept_unix(xcomm_tcp_listener_t* listener);
 extern void xcomm_sync_tcp_close_connection(xcomm_tcp_connection_t* conn);
 extern void xcomm_sync_tcp_close_listener(xcomm_tcp_listener_t* listener);
-extern int  xcomm_sync_tcp_send(xcomm_tcp_connection_t* conn, void* buf, int len);
-extern int  xcomm_sync_tcp_recv(xcomm_tcp_connection_t* conn, void* buf, int len);
+extern int64_t xcomm_sync_tcp_send(xcomm_tcp_connection_t* conn, void* buf, size_t len);
+extern int64_t xcomm_sync_tcp_recv(xcomm_tcp_connection_t* conn, void* buf, size_t len);
+extern int64_t xcomm_sync_tcp_sendv(xcomm_tcp_connection_t* conn, const xcomm_tcp_iovec_t* iov, int iovcnt);
+extern int64_t xcomm_sync_tcp_recvv(xcomm_tcp_connection_t* conn, const xcomm_tcp_iovec_t* iov, int iovcnt);
+extern int64_t xcomm_sync_tcp_recv_some(xcomm_tcp_connection_t* conn, void* buf, size_t len);
+extern int64_t xcomm_sync_tcp_peek(xcomm_tcp_connection_t* conn, void* buf, size_t len);
+extern int64_t xcomm_sync_tcp_send_file(xcomm_tcp_connection_t* conn, int fd, int64_t offset, int64_t len);
+extern int xcomm_sync_tcp_send_fd(xcomm_tcp_connection_t* conn, int fd);
+extern int xcomm_sync_tcp_recv_fd(xcomm_tcp_connection_t* conn);
 extern void xcomm_sync_tcp_set_sndtimeout(xcomm_tcp_connection_t* conn, int timeout_ms);
-extern void xcomm_sync_tcp_set_rcvtimeout(xcomm_tcp_connection_t* conn, int timeout_ms);
\ No newline at end of file
+extern void xcomm_sync_tcp_set_rcvtimeout(xcomm_tcp_connection_t* conn, int timeout_ms);
+extern void xcomm_sync_tcp_set_default_sockopts(const xcomm_tcp_sockopts_t* opts);
+extern void xcomm_sync_tcp_set_sockopts(xcomm_tcp_connection_t* conn, const xcomm_tcp_sockopts_t* opts);
+extern void xcomm_sync_tcp_destroy_pool(xcomm_tcp_pool_t* pool);
+extern xcomm_tcp_connection_t* xcomm_sync_tcp_checkout(xcomm_tcp_pool_t* pool, const char* restrict host, const char* restrict port);
+extern void xcomm_sync_tcp_checkin(xcomm_tcp_connection_t* conn);
@@ -0,0 +1,149 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "xcomm-utils.h"
+#include "xcomm-tcp-eyeballs.h"
+#include "xcomm-tcp-sockopts.h"
+#include "platform/platform-socket.h"
+
+/**
+ * keeps the resolver's order inside each family but alternates families,
+ * starting with the family of the first answer (rfc 8305 section 4).
+ */
+void xcomm_tcp_eyeballs_interleave(xcomm_resolver_addrs_t* addrs) {
+    xcomm_resolver_addrs_t sorted;
+    int                    first[XCOMM_RESOLVER_MAXADDRS];
+    int                    other[XCOMM_RESOLVER_MAXADDRS];
+    int                    nfirst = 0;
+    int                    nother = 0;
+
+    if (addrs->naddrs < 2) {
+        return;
+    }
+    int family = addrs->addrs[0].ss_family;
+    for (int i = 0; i < addrs->naddrs; i++) {
+        if (addrs->addrs[i].ss_family == family) {
+            first[nfirst++] = i;
+        } else {
+            other[nother++] = i;
+        }
+    }
+    sorted.naddrs = 0;
+    for (int i = 0; i < nfirst || i < nother; i++) {
+        if (i < nfirst) {
+            sorted.addrs[sorted.naddrs] = addrs->addrs[first[i]];
+            sorted.addrlens[sorted.naddrs++] = addrs->addrlens[first[i]];
+        }
+        if (i < nother) {
+            sorted.addrs[sorted.naddrs] = addrs->addrs[other[i]];
+            sorted.addrlens[sorted.naddrs++] = addrs->addrlens[other[i]];
+        }
+    }
+    memcpy(addrs, &sorted, sizeof(xcomm_resolver_addrs_t));
+}
+
+/**
+ * blocking happy eyeballs, a new attempt starts every connection attempt
+ * delay or as soon as one fails, the first to complete wins and the rest
+ * are dropped. timeout_ms <= 0 waits without a deadline. opts that shape
+ * the handshake go on every attempt before it connects.
+ */
+platform_sock_t xcomm_tcp_eyeballs_connect(
+    xcomm_resolver_addrs_t*     addrs,
+    int                         timeout_ms,
+    const xcomm_tcp_sockopts_t* opts) {
+    platform_sock_t socks[XCOMM_RESOLVER_MAXADDRS];
+    bool            ready[XCOMM_RESOLVER_MAXADDRS];
+    int             nsocks = 0;
+    int             next = 0;
+    platform_sock_t winner = PLATFORM_SO_ERROR_INVALID_SOCKET;
+
+    uint64_t now = xcomm_utils_getnow(XCOMM_TIME_PRECISION_MSEC);
+    uint64_t deadline = (timeout_ms > 0) ? now + timeout_ms : 0;
+    uint64_t stagger = now;
+
+    while (winner == PLATFORM_SO_ERROR_INVALID_SOCKET) {
+        now = xcomm_utils_getnow(XCOMM_TIME_PRECISION_MSEC);
+        if (deadline && now >= deadline) {
+            break;
+        }
+        if (next < addrs->naddrs && (nsocks == 0 || now >= stagger)) {
+            bool connected = false;
+
+            struct sockaddr* sa = (struct sockaddr*)&addrs->addrs[next];
+
+            platform_sock_t sock =
+                platform_socket_open(sa->sa_family, SOCK_STREAM, true);
+            if (sock == PLATFORM_SO_ERROR_INVALID_SOCKET) {
+                next++;
+                continue;
+            }
+            xcomm_tcp_sockopts_prepare(sock, opts);
+
+            if (platform_socket_start_connect(
+                    sock, sa, addrs->addrlens[next++], &connected)) {
+                continue;
+            }
+            if (connected) {
+                winner = sock;
+                break;
+            }
+            socks[nsocks++] = sock;
+            stagger = now + XCOMM_TCP_EYEBALLS_DELAY;
+            continue;
+        }
+        if (nsocks == 0) {
+            break;
+        }
+        int wait = -1;
+        if (next < addrs->naddrs) {
+            wait = (int)(stagger - now);
+        }
+        if (deadline && (wait < 0 || deadline - now < (uint64_t)wait)) {
+            wait = (int)(deadline - now);
+        }
+        if (platform_socket_wait_writable(socks, ready, nsocks, wait) < 0) {
+            break;
+        }
+        int n = 0;
+        for (int i = 0; i < nsocks; i++) {
+            if (ready[i] && winner == PLATFORM_SO_ERROR_INVALID_SOCKET) {
+                if (!platform_socket_get_soerror(socks[i])) {
+                    winner = socks[i];
+                    continue;
+                }
+                /** a failed attempt lets the next one start right away. */
+                platform_socket_close(socks[i]);
+                stagger = now;
+                continue;
+            }
+            socks[n++] = socks[i];
+        }
+        nsocks = n;
+    }
+    for (int i = 0; i < nsocks; i++) {
+        platform_socket_close(socks[i]);
+    }
+    if (winner != PLATFORM_SO_ERROR_INVALID_SOCKET) {
+        platform_socket_enable_nonblocking(winner, false);
+    }
+    return winner;
+}
@@ -21,6 +21,9 @@
 
 #include "xcomm-sync-tcp.h"
 #include "xcomm-async-tcp.h"
+#include "xcomm-tcp-pool.h"
+#include "xcomm-tcp-tls.h"
+#include "xcomm-tcp-sockopts.h"
 #include "xcomm/xcomm-tcp-module.h"
 
 xcomm_sync_tcp_module_t xcomm_sync_tcp = {
@@ -34,9 +37,23 @@ xcomm_sync_tcp_module_t xcomm_sync_tcp = {
 
     .send               = xcomm_sync_tcp_send,
     .recv               = xcomm_sync_tcp_recv,
+    .sendv              = xcomm_sync_tcp_sendv,
+    .recvv              = xcomm_sync_tcp_recvv,
+    .recv_some          = xcomm_sync_tcp_recv_some,
+    .peek               = xcomm_sync_tcp_peek,
+    .send_file          = xcomm_sync_tcp_send_file,
     .close_connection   = xcomm_sync_tcp_close_connection,
     .set_sndtimeo       = xcomm_sync_tcp_set_sndtimeout,
     .set_rcvtimeo       = xcomm_sync_tcp_set_rcvtimeout,
+
+    .load_profile         = xcomm_tcp_sockopts_profile,
+    .set_default_sockopts = xcomm_sync_tcp_set_default_sockopts,
+    .set_sockopts         = xcomm_sync_tcp_set_sockopts,
+
+    .create_pool          = xcomm_tcp_pool_create,
+    .destroy_pool         = xcomm_sync_tcp_destroy_pool,
+    .checkout             = xcomm_sync_tcp_checkout,
+    .checkin              = xcomm_sync_tcp_checkin,
 };
 
 xcomm_async_tcp_module_t xcomm_async_tcp = {
@@ -44,8 +61,11 @@ xcomm_async_tcp_module_t xcomm_async_tcp = {
 
     .dial                      = xcomm_async_tcp_dial,
     .listen                    = xcomm_async_tcp_listen,
+    .listen_sharded            = xcomm_async_tcp_listen_sharded,
 
     .set_accept_cb             = xcomm_async_tcp_set_accept_cb,
+    .set_accept_batch          = xcomm_async_tcp_set_accept_batch,
+    .set_listener_affinity     = xcomm_async_tcp_set_listener_affinity,
     .set_listener_close_cb     = xcomm_async_tcp_set_listener_close_cb,
     .close_listener            = xcomm_async_tcp_close_listener,
 
@@ -55,8 +75,29 @@ xcomm_async_tcp_module_t xcomm_async_tcp = {
     .set_connection_close_cb   = xcomm_async_tcp_set_connection_close_cb,
     .close_connection          = xcomm_async_tcp_close_connection,
     .send                      = xcomm_async_tcp_send,
+    .send_file                 = xcomm_async_tcp_send_file,
+    .set_send_watermark        = xcomm_async_tcp_set_send_watermark,
+    .set_writable_cb           = xcomm_async_tcp_set_writable_cb,
     .set_sendtimeo             = xcomm_async_tcp_set_sendtimeo,
     .set_recvtimeo             = xcomm_async_tcp_set_recvtimeo,
     .set_heartbeat_interval    = xcomm_async_tcp_set_heartbeat_interval,
     .set_packetizer            = xcomm_async_tcp_set_packetizer,
+    .set_zerocopy              = xcomm_async_tcp_set_zerocopy,
+    .relay                     = xcomm_async_tcp_relay,
+    .get_stats                 = xcomm_async_tcp_get_stats,
+    .collect_stats             = xcomm_async_tcp_collect_stats,
+
+    .load_profile              = xcomm_tcp_sockopts_profile,
+    .set_default_sockopts      = xcomm_async_tcp_set_default_sockopts,
+    .set_sockopts              = xcomm_async_tcp_set_sockopts,
+
+    .create_pool               = xcomm_tcp_pool_create,
+    .destroy_pool              = xcomm_async_tcp_destroy_pool,
+    .checkout                  = xcomm_async_tcp_checkout,
+    .checkin                   = xcomm_async_tcp_checkin,
+
+    .create_tls                = xcomm_tcp_tls_create,
+    .destroy_tls               = xcomm_tcp_tls_destroy,
+    .dial_tls                  = xcomm_async_tcp_dial_tls,
+    .set_listener_tls          = xcomm_async_tcp_set_listener_tls,
 };
@@ -0,0 +1,342 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "xcomm-logger.h"
+#include "xcomm-varint.h"
+#include "xcomm-tcp-packetizer.h"
+
+#define VARINT_MAXLEN 10
+#define RING_MINSIZE  1024
+
+static inline uint32_t _packetizer_roundup_pow_of_two(uint32_t n) {
+    n--;
+    n |= n >> 1;
+    n |= n >> 2;
+    n |= n >> 4;
+    n |= n >> 8;
+    n |= n >> 16;
+    return n + 1;
+}
+
+static int _packetizer_fixedlen(
+    xcomm_tcp_packetizer_t* conf, char* data, size_t len, size_t* flen) {
+    (void)data;
+
+    if (len < conf->fixedlen.len) {
+        return 0;
+    }
+    *flen = conf->fixedlen.len;
+    return 1;
+}
+
+static int _packetizer_delimiter(
+    xcomm_tcp_packetizer_t* conf, char* data, size_t len, size_t* flen) {
+    size_t size = conf->delimiter.size;
+
+    for (size_t i = 0; i + size <= len; i++) {
+        char* p = memchr(data + i, conf->delimiter.delimiter[0], len - i - size + 1);
+        if (!p) {
+            break;
+        }
+        i = p - data;
+        if (!memcmp(p, conf->delimiter.delimiter, size)) {
+            *flen = i + size;
+            return *flen > conf->maxlen ? -1 : 1;
+        }
+    }
+    return len >= conf->maxlen ? -1 : 0;
+}
+
+static int _packetizer_lengthfield(
+    xcomm_tcp_packetizer_t* conf, char* data, size_t len, size_t* flen) {
+    size_t   hdrlen = conf->lengthfield.offset + conf->lengthfield.size;
+    uint8_t* field  = (uint8_t*)data + conf->lengthfield.offset;
+    uint64_t value  = 0;
+
+    if (len < hdrlen) {
+        return 0;
+    }
+    for (size_t i = 0; i < conf->lengthfield.size; i++) {
+        if (conf->lengthfield.endian == XCOMM_TCP_PACKETIZER_ENDIAN_BIG) {
+            value = (value << 8) | field[i];
+        } else {
+            value |= (uint64_t)field[i] << (8 * i);
+        }
+    }
+    int64_t total = (int64_t)hdrlen + (int64_t)value + conf->lengthfield.adjustment;
+    if (value > conf->maxlen || total < (int64_t)hdrlen ||
+        total > (int64_t)conf->maxlen) {
+        return -1;
+    }
+    if (len < (size_t)total) {
+        return 0;
+    }
+    *flen = (size_t)total;
+    return 1;
+}
+
+static int _packetizer_varint(
+    xcomm_tcp_packetizer_t* conf, char* data, size_t len, size_t* flen) {
+    size_t   offset = conf->varint.offset;
+    uint8_t* field  = (uint8_t*)data + offset;
+    size_t   avail  = len > offset ? len - offset : 0;
+    size_t   i;
+
+    for (i = 0; i < avail && i < VARINT_MAXLEN; i++) {
+        if (!(field[i] & 0x80)) {
+            break;
+        }
+    }
+    if (i == VARINT_MAXLEN) {
+        return -1;
+    }
+    if (i == avail) {
+        return 0;
+    }
+    int      pos   = 0;
+    uint64_t value = xcomm_varint_decode(field, &pos);
+    int64_t  total = (int64_t)(offset + pos) + (int64_t)value + conf->varint.adjustment;
+
+    if (value > conf->maxlen || total < (int64_t)(offset + pos) ||
+        total > (int64_t)conf->maxlen) {
+        return -1;
+    }
+    if (len < (size_t)total) {
+        return 0;
+    }
+    *flen = (size_t)total;
+    return 1;
+}
+
+static int _packetizer_frame(
+    xcomm_tcp_packetizer_t* conf, char* data, size_t len, size_t* flen) {
+    switch (conf->type) {
+    case XCOMM_TCP_PACKETIZER_TYPE_FIXEDLEN:
+        return _packetizer_fixedlen(conf, data, len, flen);
+    case XCOMM_TCP_PACKETIZER_TYPE_DELIMITER:
+        return _packetizer_delimiter(conf, data, len, flen);
+    case XCOMM_TCP_PACKETIZER_TYPE_LENGTHFIELD:
+        return _packetizer_lengthfield(conf, data, len, flen);
+    case XCOMM_TCP_PACKETIZER_TYPE_VARINT:
+        return _packetizer_varint(conf, data, len, flen);
+    default:
+        return -1;
+    }
+}
+
+/**
+ * delivers every complete frame in data, returns the number of bytes
+ * consumed, or -1 on a malformed frame.
+ */
+static ssize_t _packetizer_split(
+    xcomm_tcp_packetizer_t* conf,
+    char*                   data,
+    size_t                  len,
+    bool (*frame_cb)(void* param, void* frame, size_t len),
+    void*                   param,
+    bool*                   stopped) {
+    size_t off = 0;
+
+    while (off < len) {
+        size_t flen;
+        int    ret = _packetizer_frame(conf, data + off, len - off, &flen);
+        if (ret < 0) {
+            return -1;
+        }
+        if (ret == 0) {
+            break;
+        }
+        char* frame = data + off;
+        off += flen;
+        if (!frame_cb(param, frame, flen)) {
+            *stopped = true;
+            break;
+        }
+    }
+    return off;
+}
+
+/**
+ * grows the ring to at least size bytes, doubling up to the room for the
+ * longest frame. the contents always start at offset 0 and survive.
+ */
+static int _packetizer_reserve(tcp_packetizer_t* packetizer, uint32_t size) {
+    xcomm_ringbuf_t* ring = &packetizer->ring;
+    uint32_t         max  =
+        _packetizer_roundup_pow_of_two((uint32_t)packetizer->conf.maxlen);
+    uint32_t         cap  = ring->buf ? xcomm_ringbuf_cap(ring) : 0;
+
+    if (size > max) {
+        return -1;
+    }
+    if (cap >= size) {
+        return 0;
+    }
+    uint32_t newcap = cap ? cap : (RING_MINSIZE < max ? RING_MINSIZE : max);
+    while (newcap < size) {
+        newcap <<= 1;
+    }
+    char* buf = realloc(ring->buf, newcap);
+    if (!buf) {
+        xcomm_loge("no memory.\n");
+        return -1;
+    }
+    ring->buf  = buf;
+    ring->esz  = 1;
+    ring->mask = newcap - 1;
+    return 0;
+}
+
+/** the ring is allocated for the first incomplete frame and grows with it. */
+static int _packetizer_retain(
+    tcp_packetizer_t* packetizer, char* data, uint32_t len) {
+    xcomm_ringbuf_t* ring = &packetizer->ring;
+
+    ring->rpos = ring->wpos = 0;
+    if (_packetizer_reserve(packetizer, len) ||
+        xcomm_ringbuf_write(ring, data, len) != len) {
+        return -1;
+    }
+    return 0;
+}
+
+int xcomm_tcp_packetizer_init(
+    tcp_packetizer_t* packetizer, xcomm_tcp_packetizer_t* conf) {
+    packetizer->conf = *conf;
+    if (!packetizer->conf.maxlen) {
+        packetizer->conf.maxlen = TCP_PACKETIZER_DEFAULT_MAXLEN;
+    }
+    switch (conf->type) {
+    case XCOMM_TCP_PACKETIZER_TYPE_FIXEDLEN:
+        if (!conf->fixedlen.len || conf->fixedlen.len > packetizer->conf.maxlen) {
+            return -1;
+        }
+        break;
+    case XCOMM_TCP_PACKETIZER_TYPE_DELIMITER:
+        if (!conf->delimiter.size ||
+            conf->delimiter.size > sizeof(conf->delimiter.delimiter)) {
+            return -1;
+        }
+        break;
+    case XCOMM_TCP_PACKETIZER_TYPE_LENGTHFIELD:
+        if (!conf->lengthfield.size || conf->lengthfield.size > 8) {
+            return -1;
+        }
+        break;
+    case XCOMM_TCP_PACKETIZER_TYPE_VARINT:
+        break;
+    default:
+        return -1;
+    }
+    if (packetizer->conf.maxlen > UINT32_MAX / 2) {
+        return -1;
+    }
+    memset(&packetizer->ring, 0, sizeof(packetizer->ring));
+    return 0;
+}
+
+void xcomm_tcp_packetizer_destroy(tcp_packetizer_t* packetizer) {
+    xcomm_ringbuf_destroy(&packetizer->ring);
+}
+
+ssize_t xcomm_tcp_packetizer_feed(
+    tcp_packetizer_t* packetizer,
+    char*             buf,
+    size_t            len,
+    bool (*frame_cb)(void* param, void* frame, size_t len),
+    void*             param) {
+    xcomm_ringbuf_t* ring     = &packetizer->ring;
+    bool             stopped  = false;
+    size_t           consumed = 0;
+
+    while (len > 0) {
+        if (xcomm_ringbuf_empty(ring)) {
+            ssize_t n = _packetizer_split(
+                &packetizer->conf, buf, len, frame_cb, param, &stopped);
+            if (n < 0) {
+                return -1;
+            }
+            if (stopped) {
+                xcomm_ringbuf_destroy(ring);
+                return consumed + n;
+            }
+            if ((size_t)n == len) {
+                xcomm_ringbuf_destroy(ring);
+                return consumed + len;
+            }
+            if (_packetizer_retain(packetizer, buf + n, (uint32_t)(len - n))) {
+                return -1;
+            }
+            return consumed + len;
+        }
+        uint32_t old = xcomm_ringbuf_len(ring);
+
+        /** a full ring doubles until the pending frame fits. */
+        if (!xcomm_ringbuf_avail(ring) && _packetizer_reserve(packetizer, old + 1)) {
+            return -1;
+        }
+        uint32_t cnt = xcomm_ringbuf_write(
+            ring, buf, len > UINT32_MAX ? UINT32_MAX : (uint32_t)len);
+
+        ssize_t n = _packetizer_split(
+            &packetizer->conf,
+            ring->buf + ring->rpos,
+            old + cnt,
+            frame_cb,
+            param,
+            &stopped);
+        if (n < 0) {
+            return -1;
+        }
+        if (stopped) {
+            /** a frame that stops the feed always ends past the old bytes. */
+            ring->rpos = ring->wpos = 0;
+            xcomm_ringbuf_destroy(ring);
+            return consumed + (size_t)n - old;
+        }
+        uint32_t rest = old + cnt - (uint32_t)n;
+        if (rest <= cnt) {
+            /**
+             * the pending frame was completed, whatever follows it is still
+             * in buf and can be framed in place.
+             */
+            ring->rpos = ring->wpos = 0;
+            buf      += cnt - rest;
+            len      -= cnt - rest;
+            consumed += cnt - rest;
+            continue;
+        }
+        if (n > 0) {
+            memmove(ring->buf, ring->buf + ring->rpos + n, rest);
+        }
+        ring->rpos = 0;
+        ring->wpos = rest;
+        buf      += cnt;
+        len      -= cnt;
+        consumed += cnt;
+    }
+    if (xcomm_ringbuf_empty(ring)) {
+        xcomm_ringbuf_destroy(ring);
+    }
+    return consumed;
+}
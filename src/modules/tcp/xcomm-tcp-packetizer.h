@@ -0,0 +1,48 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+_Pragma("once")
+
+#include "xcomm-ringbuffer.h"
+#include "xcomm/xcomm-tcp-module.h"
+#include "platform/platform-types.h"
+
+#define TCP_PACKETIZER_DEFAULT_MAXLEN 65536
+
+typedef struct tcp_packetizer_s tcp_packetizer_t;
+
+/**
+ * feed returns how much of buf was consumed, which is short of len only
+ * when frame_cb asked to stop, and -1 on a malformed frame.
+ * the ring only ever holds the head of one incomplete frame and is rewound
+ * whenever it drains, so its contents never wrap. it is allocated when a
+ * frame is left incomplete, grows only as far as that frame needs and is
+ * released by a feed that leaves nothing behind, so an idle connection
+ * holds no receive memory.
+ */
+struct tcp_packetizer_s {
+    xcomm_tcp_packetizer_t conf;
+    xcomm_ringbuf_t        ring;
+};
+
+extern int     xcomm_tcp_packetizer_init(tcp_packetizer_t* packetizer, xcomm_tcp_packetizer_t* conf);
+extern void    xcomm_tcp_packetizer_destroy(tcp_packetizer_t* packetizer);
+extern ssize_t xcomm_tcp_packetizer_feed(tcp_packetizer_t* packetizer, char* buf, size_t len, bool (*frame_cb)(void* param, void* frame, size_t len), void* param);
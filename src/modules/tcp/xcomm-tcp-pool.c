@@ -0,0 +1,121 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "xcomm-logger.h"
+#include "xcomm-tcp-pool.h"
+
+static void _tcp_pool_free(tcp_pool_t* pool) {
+    while (!xcomm_rbtree_empty(&pool->keys)) {
+        xcomm_rbtree_node_t* node = xcomm_rbtree_first(&pool->keys);
+        xcomm_rbtree_erase(&pool->keys, node);
+
+        tcp_pool_key_t* key = xcomm_rbtree_data(node, tcp_pool_key_t, node);
+        free(key->node.key.str);
+        free(key->host);
+        free(key->port);
+        free(key);
+    }
+    mtx_destroy(&pool->mtx);
+    cnd_destroy(&pool->cnd);
+    free(pool);
+}
+
+xcomm_tcp_pool_t* xcomm_tcp_pool_create(const xcomm_tcp_pool_config_t* config) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    tcp_pool_t* pool = calloc(1, sizeof(tcp_pool_t));
+    if (!pool) {
+        xcomm_loge("no memory.\n");
+        return NULL;
+    }
+    if (config) {
+        pool->config = *config;
+    } else {
+        pool->config.max_idle           = TCP_POOL_MAX_IDLE;
+        pool->config.max_active         = 0;
+        pool->config.idle_timeout_ms    = TCP_POOL_IDLE_TIMEOUT;
+        pool->config.connect_timeout_ms = TCP_POOL_CONNECT_TIMEOUT;
+    }
+    pool->handle.opaque = pool;
+    pool->closing       = false;
+    atomic_init(&pool->refcnt, 1);
+
+    mtx_init(&pool->mtx, mtx_plain);
+    cnd_init(&pool->cnd);
+    xcomm_rbtree_init(&pool->keys, xcomm_rbtree_keycmp_str);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+    return &pool->handle;
+}
+
+void xcomm_tcp_pool_ref(tcp_pool_t* pool) {
+    atomic_fetch_add(&pool->refcnt, 1);
+}
+
+void xcomm_tcp_pool_unref(tcp_pool_t* pool) {
+    if (atomic_fetch_sub(&pool->refcnt, 1) == 1) {
+        _tcp_pool_free(pool);
+    }
+}
+
+/** caller holds the pool mutex, keys live as long as the pool. */
+tcp_pool_key_t* xcomm_tcp_pool_key(
+    tcp_pool_t* pool, const char* restrict host, const char* restrict port) {
+    size_t len = strlen(host) + strlen(port) + 2;
+    char*  str = malloc(len);
+    if (!str) {
+        return NULL;
+    }
+    snprintf(str, len, "%s:%s", host, port);
+
+    xcomm_rbtree_node_t* node =
+        xcomm_rbtree_find(&pool->keys, (xcomm_rbtree_key_t){.str = str});
+    if (node) {
+        free(str);
+        return xcomm_rbtree_data(node, tcp_pool_key_t, node);
+    }
+    tcp_pool_key_t* key = calloc(1, sizeof(tcp_pool_key_t));
+    if (!key) {
+        free(str);
+        return NULL;
+    }
+    key->host = strdup(host);
+    key->port = strdup(port);
+    if (!key->host || !key->port) {
+        free(key->host);
+        free(key->port);
+        free(key);
+        free(str);
+        return NULL;
+    }
+    key->node.key.str = str;
+    key->pool         = pool;
+    xcomm_list_init(&key->idle);
+    xcomm_list_init(&key->waiters);
+
+    xcomm_rbtree_insert(&pool->keys, &key->node);
+    return key;
+}
+
+bool xcomm_tcp_pool_has_slot(tcp_pool_key_t* key) {
+    return key->pool->config.max_active <= 0 ||
+           key->nactive < key->pool->config.max_active;
+}
@@ -0,0 +1,84 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+_Pragma("once")
+
+#include <stdatomic.h>
+
+#include "xcomm-list.h"
+#include "xcomm-rbtree.h"
+#include "xcomm/xcomm-tcp-module.h"
+#include "platform/platform-types.h"
+
+#define TCP_POOL_MAX_IDLE        8
+#define TCP_POOL_IDLE_TIMEOUT    60000
+#define TCP_POOL_CONNECT_TIMEOUT 3000
+
+typedef struct tcp_pool_s        tcp_pool_t;
+typedef struct tcp_pool_key_s    tcp_pool_key_t;
+typedef struct tcp_pool_member_s tcp_pool_member_t;
+typedef enum tcp_pool_state_e    tcp_pool_state_t;
+
+enum tcp_pool_state_e {
+    TCP_POOL_STATE_NONE   = 0,
+    TCP_POOL_STATE_IDLE   = 1,
+    TCP_POOL_STATE_ACTIVE = 2,
+};
+
+/** idle holds the most recently returned connection first. */
+struct tcp_pool_key_s {
+    xcomm_rbtree_node_t node;
+    tcp_pool_t*         pool;
+    char*               host;
+    char*               port;
+    int                 nactive;
+    int                 nidle;
+    xcomm_list_t        idle;
+    xcomm_list_t        waiters;
+};
+
+/** embedded in pooled connections, state and node are guarded by the pool mutex. */
+struct tcp_pool_member_s {
+    tcp_pool_key_t*   key;
+    tcp_pool_state_t  state;
+    uint64_t          since;
+    xcomm_list_node_t node;
+};
+
+/**
+ * the owner, every member connection and every pending checkout hold a
+ * reference, the pool is released when the last of them goes away.
+ */
+struct tcp_pool_s {
+    xcomm_tcp_pool_t        handle;
+    xcomm_tcp_pool_config_t config;
+    mtx_t                   mtx;
+    cnd_t                   cnd;
+    atomic_int              refcnt;
+    bool                    closing;
+    xcomm_rbtree_t          keys;
+};
+
+extern xcomm_tcp_pool_t* xcomm_tcp_pool_create(const xcomm_tcp_pool_config_t* config);
+extern void              xcomm_tcp_pool_ref(tcp_pool_t* pool);
+extern void              xcomm_tcp_pool_unref(tcp_pool_t* pool);
+extern tcp_pool_key_t*   xcomm_tcp_pool_key(tcp_pool_t* pool, const char* restrict host, const char* restrict port);
+extern bool              xcomm_tcp_pool_has_slot(tcp_pool_key_t* key);
@@ -0,0 +1,144 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "xcomm-tcp-sockopts.h"
+#include "platform/platform-socket.h"
+
+/**
+ * both profiles keep nagle off, writes are already coalesced by the send
+ * paths so it would only add delay. throughput leaves mss and buffers to the
+ * kernel's autotuning, latency trades cpu for shorter queues and faster acks.
+ */
+static const xcomm_tcp_sockopts_t tcp_sockopts_profiles[] = {
+    [XCOMM_TCP_PROFILE_THROUGHPUT] = {
+        .mss             = 0,
+        .nodelay         = true,
+        .cork            = false,
+        .sndbuf          = 0,
+        .rcvbuf          = 0,
+        .quickack        = false,
+        .keepalive       = true,
+        .keepalive_idle  = 60,
+        .keepalive_intvl = 1,
+        .keepalive_cnt   = 10,
+        .busy_poll       = 0,
+        .notsent_lowat   = 0,
+    },
+    [XCOMM_TCP_PROFILE_LATENCY] = {
+        .mss             = 0,
+        .nodelay         = true,
+        .cork            = false,
+        .sndbuf          = 0,
+        .rcvbuf          = 0,
+        .quickack        = true,
+        .keepalive       = true,
+        .keepalive_idle  = 10,
+        .keepalive_intvl = 1,
+        .keepalive_cnt   = 5,
+        .busy_poll       = 50,
+        .notsent_lowat   = 16384,
+    },
+};
+
+void xcomm_tcp_sockopts_profile(
+    xcomm_tcp_profile_t profile, xcomm_tcp_sockopts_t* opts) {
+    if (profile != XCOMM_TCP_PROFILE_LATENCY) {
+        profile = XCOMM_TCP_PROFILE_THROUGHPUT;
+    }
+    *opts = tcp_sockopts_profiles[profile];
+}
+
+void xcomm_tcp_sockopts_store(
+    tcp_sockopts_default_t* def, const xcomm_tcp_sockopts_t* opts) {
+    xcomm_spinlock_lock(&def->lock);
+    if (opts) {
+        def->opts = *opts;
+    }
+    def->set = opts != NULL;
+    xcomm_spinlock_unlock(&def->lock);
+}
+
+/** copies the default into opts, NULL selects the throughput profile. */
+const xcomm_tcp_sockopts_t* xcomm_tcp_sockopts_load(
+    tcp_sockopts_default_t* def, xcomm_tcp_sockopts_t* opts) {
+    bool set;
+
+    xcomm_spinlock_lock(&def->lock);
+    set = def->set;
+    if (set) {
+        *opts = def->opts;
+    }
+    xcomm_spinlock_unlock(&def->lock);
+
+    return set ? opts : NULL;
+}
+
+/**
+ * the mss and the window scale are announced in the syn, so they only take
+ * effect when set on the socket before connect.
+ */
+void xcomm_tcp_sockopts_prepare(
+    platform_sock_t sock, const xcomm_tcp_sockopts_t* opts) {
+    if (!opts) {
+        return;
+    }
+    if (opts->mss > 0) {
+        platform_socket_set_maxseg(sock, opts->mss);
+    }
+    if (opts->rcvbuf > 0) {
+        platform_socket_set_rcvbuf(sock, opts->rcvbuf);
+    }
+}
+
+void xcomm_tcp_sockopts_apply(
+    platform_sock_t sock, const xcomm_tcp_sockopts_t* opts) {
+    if (!opts) {
+        opts = &tcp_sockopts_profiles[XCOMM_TCP_PROFILE_THROUGHPUT];
+    }
+    if (opts->mss > 0) {
+        platform_socket_set_maxseg(sock, opts->mss);
+    }
+    platform_socket_enable_nodelay(sock, opts->nodelay);
+    platform_socket_enable_cork(sock, opts->cork);
+
+    if (opts->sndbuf > 0) {
+        platform_socket_set_sndbuf(sock, opts->sndbuf);
+    }
+    if (opts->rcvbuf > 0) {
+        platform_socket_set_rcvbuf(sock, opts->rcvbuf);
+    }
+    if (opts->quickack) {
+        platform_socket_enable_quickack(sock, true);
+    }
+    platform_socket_set_keepalive(
+        sock,
+        opts->keepalive,
+        opts->keepalive_idle,
+        opts->keepalive_intvl,
+        opts->keepalive_cnt);
+
+    if (opts->busy_poll > 0) {
+        platform_socket_set_busypoll(sock, opts->busy_poll);
+    }
+    if (opts->notsent_lowat > 0) {
+        platform_socket_set_notsent_lowat(sock, opts->notsent_lowat);
+    }
+}
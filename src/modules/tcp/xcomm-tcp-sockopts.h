@@ -0,0 +1,41 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+_Pragma("once")
+
+#include "xcomm-spinlock.h"
+#include "xcomm/xcomm-tcp-module.h"
+#include "platform/platform-types.h"
+
+typedef struct tcp_sockopts_default_s tcp_sockopts_default_t;
+
+/** a module wide default, set from any thread and copied out by readers. */
+struct tcp_sockopts_default_s {
+    xcomm_spinlock_t     lock;
+    bool                 set;
+    xcomm_tcp_sockopts_t opts;
+};
+
+extern void xcomm_tcp_sockopts_profile(xcomm_tcp_profile_t profile, xcomm_tcp_sockopts_t* opts);
+extern void xcomm_tcp_sockopts_store(tcp_sockopts_default_t* def, const xcomm_tcp_sockopts_t* opts);
+extern const xcomm_tcp_sockopts_t* xcomm_tcp_sockopts_load(tcp_sockopts_default_t* def, xcomm_tcp_sockopts_t* opts);
+extern void xcomm_tcp_sockopts_prepare(platform_sock_t sock, const xcomm_tcp_sockopts_t* opts);
+extern void xcomm_tcp_sockopts_apply(platform_sock_t sock, const xcomm_tcp_sockopts_t* opts);
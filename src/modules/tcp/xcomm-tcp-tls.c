@@ -0,0 +1,735 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <limits.h>
+#include <openssl/err.h>
+#include <openssl/kdf.h>
+#include <openssl/core_names.h>
+#include <openssl/x509v3.h>
+
+#include "xcomm-logger.h"
+#include "xcomm-tcp-tls.h"
+#include "platform/platform-socket.h"
+
+static void _tcp_tls_log_error(const char* what) {
+    char          buf[256];
+    unsigned long err = ERR_get_error();
+
+    ERR_error_string_n(err, buf, sizeof(buf));
+    xcomm_loge("tls %s error: %s.\n", what, err ? buf : "unknown");
+    ERR_clear_error();
+}
+
+static bool _tcp_tls_numeric(const char* host) {
+    struct in6_addr addr;
+
+    return inet_pton(AF_INET, host, &addr) == 1 ||
+           inet_pton(AF_INET6, host, &addr) == 1;
+}
+
+/** caller holds the mutex. */
+static void _tcp_tls_session_erase(tcp_tls_t* tls, tcp_tls_session_t* entry) {
+    xcomm_rbtree_erase(&tls->sessions, &entry->node);
+    xcomm_list_remove(&entry->lru);
+    tls->nsessions--;
+
+    SSL_SESSION_free(entry->session);
+    free(entry->node.key.str);
+    free(entry);
+}
+
+/** takes over the reference handed in by the new session callback. */
+static void _tcp_tls_session_put(
+    tcp_tls_t* tls, const char* key, SSL_SESSION* session) {
+    mtx_lock(&tls->mtx);
+
+    xcomm_rbtree_node_t* node = xcomm_rbtree_find(
+        &tls->sessions, (xcomm_rbtree_key_t){.str = (char*)key});
+    if (node) {
+        tcp_tls_session_t* entry =
+            xcomm_rbtree_data(node, tcp_tls_session_t, node);
+
+        SSL_SESSION_free(entry->session);
+        entry->session = session;
+        xcomm_list_remove(&entry->lru);
+        xcomm_list_insert_head(&tls->lru, &entry->lru);
+
+        mtx_unlock(&tls->mtx);
+        return;
+    }
+    tcp_tls_session_t* entry = malloc(sizeof(tcp_tls_session_t));
+    char*              str   = strdup(key);
+    if (!entry || !str) {
+        mtx_unlock(&tls->mtx);
+        free(entry);
+        free(str);
+        SSL_SESSION_free(session);
+        return;
+    }
+    entry->node.key.str = str;
+    entry->session      = session;
+    xcomm_rbtree_insert(&tls->sessions, &entry->node);
+    xcomm_list_insert_head(&tls->lru, &entry->lru);
+    tls->nsessions++;
+
+    if (tls->nsessions > tls->maxsessions) {
+        _tcp_tls_session_erase(
+            tls,
+            xcomm_list_data(
+                xcomm_list_tail(&tls->lru), tcp_tls_session_t, lru));
+    }
+    mtx_unlock(&tls->mtx);
+}
+
+/** returns a referenced session, expired ones are dropped on the way. */
+static SSL_SESSION* _tcp_tls_session_get(tcp_tls_t* tls, const char* key) {
+    SSL_SESSION* session = NULL;
+
+    mtx_lock(&tls->mtx);
+
+    xcomm_rbtree_node_t* node = xcomm_rbtree_find(
+        &tls->sessions, (xcomm_rbtree_key_t){.str = (char*)key});
+    if (node) {
+        tcp_tls_session_t* entry =
+            xcomm_rbtree_data(node, tcp_tls_session_t, node);
+
+        long expiry = SSL_SESSION_get_time(entry->session) +
+                      SSL_SESSION_get_timeout(entry->session);
+        if (SSL_SESSION_is_resumable(entry->session) &&
+            (long)time(NULL) < expiry) {
+            session = entry->session;
+            SSL_SESSION_up_ref(session);
+        } else {
+            _tcp_tls_session_erase(tls, entry);
+        }
+    }
+    mtx_unlock(&tls->mtx);
+    return session;
+}
+
+static void _tcp_tls_session_drop(tcp_tls_t* tls, const char* key) {
+    mtx_lock(&tls->mtx);
+
+    xcomm_rbtree_node_t* node = xcomm_rbtree_find(
+        &tls->sessions, (xcomm_rbtree_key_t){.str = (char*)key});
+    if (node) {
+        _tcp_tls_session_erase(
+            tls, xcomm_rbtree_data(node, tcp_tls_session_t, node));
+    }
+    mtx_unlock(&tls->mtx);
+}
+
+/** tls 1.3 tickets arrive after the handshake, each one replaces the last. */
+static int _tcp_tls_new_session(SSL* ssl, SSL_SESSION* session) {
+    tcp_tls_conn_t* conn = SSL_get_app_data(ssl);
+
+    if (!conn || !conn->key) {
+        return 0;
+    }
+    _tcp_tls_session_put(conn->tls, conn->key, session);
+    return 1;
+}
+
+/**
+ * keeps the initial application traffic secret of our sending side, which
+ * the kernel keys are derived from. lines read "LABEL client_random secret".
+ */
+static void _tcp_tls_keylog(const SSL* ssl, const char* line) {
+    tcp_tls_conn_t* conn = SSL_get_app_data(ssl);
+
+    if (!conn) {
+        return;
+    }
+    const char* label = conn->tls->server ? "SERVER_TRAFFIC_SECRET_0 "
+                                          : "CLIENT_TRAFFIC_SECRET_0 ";
+    if (strncmp(line, label, strlen(label))) {
+        return;
+    }
+    const char* hex = strchr(line + strlen(label), ' ');
+    if (!hex) {
+        return;
+    }
+    hex++;
+
+    size_t len = strlen(hex) / 2;
+    if (len > sizeof(conn->ktls.secret)) {
+        return;
+    }
+    for (size_t i = 0; i < len; i++) {
+        unsigned int byte;
+        if (sscanf(hex + 2 * i, "%2x", &byte) != 1) {
+            return;
+        }
+        conn->ktls.secret[i] = (uint8_t)byte;
+    }
+    conn->ktls.secretlen = len;
+}
+
+/** notes a peer key update that asks for ours, the kernel has to send it. */
+static void _tcp_tls_message(
+    int         write_p,
+    int         version,
+    int         type,
+    const void* buf,
+    size_t      len,
+    SSL*        ssl,
+    void*       arg) {
+    tcp_tls_conn_t* conn = SSL_get_app_data(ssl);
+    const uint8_t*  msg  = buf;
+
+    (void)(version);
+    (void)(arg);
+
+    if (!conn || write_p || type != SSL3_RT_HANDSHAKE || len < 5 ||
+        msg[0] != SSL3_MT_KEY_UPDATE) {
+        return;
+    }
+    if (msg[4] == SSL_KEY_UPDATE_REQUESTED &&
+        conn->ktls.state == TCP_TLS_KTLS_ACTIVE) {
+        conn->ktls.update = true;
+    }
+}
+
+/** HKDF-Expand-Label of rfc 8446 with an empty context. */
+static int _tcp_tls_expand_label(
+    const EVP_MD*  md,
+    const uint8_t* secret,
+    size_t         secretlen,
+    const char*    label,
+    uint8_t*       out,
+    size_t         outlen) {
+    uint8_t info[64];
+    size_t  labellen = strlen("tls13 ") + strlen(label);
+    int     mode     = EVP_KDF_HKDF_MODE_EXPAND_ONLY;
+
+    info[0] = (uint8_t)(outlen >> 8);
+    info[1] = (uint8_t)outlen;
+    info[2] = (uint8_t)labellen;
+    memcpy(info + 3, "tls13 ", 6);
+    memcpy(info + 9, label, strlen(label));
+    info[3 + labellen] = 0;
+
+    EVP_KDF*     kdf = EVP_KDF_fetch(NULL, OSSL_KDF_NAME_HKDF, NULL);
+    EVP_KDF_CTX* ctx = kdf ? EVP_KDF_CTX_new(kdf) : NULL;
+    EVP_KDF_free(kdf);
+    if (!ctx) {
+        return -1;
+    }
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_utf8_string(
+            OSSL_KDF_PARAM_DIGEST, (char*)EVP_MD_get0_name(md), 0),
+        OSSL_PARAM_construct_int(OSSL_KDF_PARAM_MODE, &mode),
+        OSSL_PARAM_construct_octet_string(
+            OSSL_KDF_PARAM_KEY, (void*)secret, secretlen),
+        OSSL_PARAM_construct_octet_string(
+            OSSL_KDF_PARAM_INFO, info, 4 + labellen),
+        OSSL_PARAM_construct_end(),
+    };
+    int ret = EVP_KDF_derive(ctx, out, outlen, params) == 1 ? 0 : -1;
+
+    EVP_KDF_CTX_free(ctx);
+    return ret;
+}
+
+/** moves the sending secret one generation on and derives its key and iv. */
+static int _tcp_tls_ktls_next(tcp_tls_conn_t* conn) {
+    const SSL_CIPHER* cipher = SSL_get_current_cipher(conn->ssl);
+    const EVP_MD*     md = cipher ? SSL_CIPHER_get_handshake_digest(cipher) : NULL;
+    size_t            keylen =
+        conn->ktls.cipher == PLATFORM_KTLS_CIPHER_AES_GCM_128 ? 16 : 32;
+    uint8_t           next[EVP_MAX_MD_SIZE];
+
+    if (!md ||
+        _tcp_tls_expand_label(
+            md, conn->ktls.secret, conn->ktls.secretlen, "traffic upd",
+            next, conn->ktls.secretlen) ||
+        _tcp_tls_expand_label(
+            md, next, conn->ktls.secretlen, "key", conn->ktls.key, keylen) ||
+        _tcp_tls_expand_label(
+            md, next, conn->ktls.secretlen, "iv", conn->ktls.iv,
+            sizeof(conn->ktls.iv))) {
+        OPENSSL_cleanse(next, sizeof(next));
+        return -1;
+    }
+    memcpy(conn->ktls.secret, next, conn->ktls.secretlen);
+    OPENSSL_cleanse(next, sizeof(next));
+    return 0;
+}
+
+/**
+ * the record sequence openssl reached is not exposed, so a key update is
+ * sent instead, it restarts the sequence at zero under keys derived here
+ * from the captured secret. anything that does not fit stays in userspace,
+ * so does everything on kernels that could not answer a peer key update.
+ */
+static void _tcp_tls_ktls_prepare(tcp_tls_conn_t* conn) {
+    const SSL_CIPHER* cipher = SSL_get_current_cipher(conn->ssl);
+
+    if (!conn->ktls.secretlen || !cipher ||
+        SSL_version(conn->ssl) != TLS1_3_VERSION || !platform_socket_ktls_rekey()) {
+        return;
+    }
+    switch (SSL_CIPHER_get_id(cipher)) {
+    case TLS1_3_CK_AES_128_GCM_SHA256:
+        conn->ktls.cipher = PLATFORM_KTLS_CIPHER_AES_GCM_128;
+        break;
+    case TLS1_3_CK_AES_256_GCM_SHA384:
+        conn->ktls.cipher = PLATFORM_KTLS_CIPHER_AES_GCM_256;
+        break;
+    case TLS1_3_CK_CHACHA20_POLY1305_SHA256:
+        conn->ktls.cipher = PLATFORM_KTLS_CIPHER_CHACHA20_POLY1305;
+        break;
+    default:
+        return;
+    }
+    ERR_clear_error();
+    if (SSL_key_update(conn->ssl, SSL_KEY_UPDATE_NOT_REQUESTED) != 1 ||
+        SSL_do_handshake(conn->ssl) != 1) {
+        ERR_clear_error();
+        return;
+    }
+    if (_tcp_tls_ktls_next(conn)) {
+        /** openssl moved on to the new keys itself and stays in charge. */
+        _tcp_tls_log_error("key update");
+        return;
+    }
+    conn->ktls.written = BIO_number_written(conn->wbio);
+    conn->ktls.state   = TCP_TLS_KTLS_PENDING;
+}
+
+static void _tcp_tls_free(tcp_tls_t* tls) {
+    while (!xcomm_list_empty(&tls->lru)) {
+        _tcp_tls_session_erase(
+            tls,
+            xcomm_list_data(xcomm_list_head(&tls->lru), tcp_tls_session_t, lru));
+    }
+    mtx_destroy(&tls->mtx);
+    SSL_CTX_free(tls->ctx);
+    free(tls);
+}
+
+xcomm_tcp_tls_t* xcomm_tcp_tls_create(const xcomm_tcp_tls_config_t* config) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    xcomm_tcp_tls_config_t defaults = {0};
+    if (!config) {
+        config = &defaults;
+    }
+    int cache = config->session_cache_size > 0 ? config->session_cache_size
+                                               : TCP_TLS_SESSION_CACHE;
+    int timeout = config->session_timeout_s > 0 ? config->session_timeout_s
+                                                : TCP_TLS_SESSION_TIMEOUT;
+
+    if (config->server && (!config->cert_file || !config->key_file)) {
+        xcomm_loge("tls server needs a certificate and a key.\n");
+        return NULL;
+    }
+    tcp_tls_t* tls = calloc(1, sizeof(tcp_tls_t));
+    if (!tls) {
+        xcomm_loge("no memory.\n");
+        return NULL;
+    }
+    tls->server = config->server;
+    tls->ktls   = config->ktls;
+    tls->ctx    = SSL_CTX_new(
+        config->server ? TLS_server_method() : TLS_client_method());
+    if (!tls->ctx) {
+        _tcp_tls_log_error("context");
+        free(tls);
+        return NULL;
+    }
+    SSL_CTX_set_min_proto_version(tls->ctx, TLS1_2_VERSION);
+    /** idle connections give their record buffers back. */
+    SSL_CTX_set_mode(tls->ctx, SSL_MODE_RELEASE_BUFFERS);
+    SSL_CTX_set_timeout(tls->ctx, timeout);
+
+    if (config->ktls) {
+        SSL_CTX_set_keylog_callback(tls->ctx, _tcp_tls_keylog);
+        SSL_CTX_set_msg_callback(tls->ctx, _tcp_tls_message);
+    }
+
+    if (config->cert_file &&
+        SSL_CTX_use_certificate_chain_file(tls->ctx, config->cert_file) != 1) {
+        _tcp_tls_log_error("certificate");
+        goto fail;
+    }
+    if (config->key_file &&
+        (SSL_CTX_use_PrivateKey_file(
+             tls->ctx, config->key_file, SSL_FILETYPE_PEM) != 1 ||
+         SSL_CTX_check_private_key(tls->ctx) != 1)) {
+        _tcp_tls_log_error("private key");
+        goto fail;
+    }
+    /** clients verify unless told not to, servers only when asked. */
+    bool verify = config->server ? config->verify_peer : !config->skip_verify;
+    if (verify) {
+        int ok = config->ca_file
+                     ? SSL_CTX_load_verify_locations(tls->ctx, config->ca_file, NULL)
+                     : SSL_CTX_set_default_verify_paths(tls->ctx);
+        if (ok != 1) {
+            _tcp_tls_log_error("ca");
+            goto fail;
+        }
+        SSL_CTX_set_verify(
+            tls->ctx,
+            SSL_VERIFY_PEER |
+                (config->server ? SSL_VERIFY_FAIL_IF_NO_PEER_CERT : 0),
+            NULL);
+    }
+    if (config->server) {
+        /**
+         * ticket keys belong to the context, so a ticket issued on one worker
+         * resumes on any other. the stateful cache serves peers without
+         * ticket support.
+         */
+        SSL_CTX_clear_options(tls->ctx, SSL_OP_NO_TICKET);
+        SSL_CTX_set_session_cache_mode(tls->ctx, SSL_SESS_CACHE_SERVER);
+        SSL_CTX_sess_set_cache_size(tls->ctx, cache);
+        SSL_CTX_set_session_id_context(
+            tls->ctx, (const unsigned char*)"xcomm", 5);
+    } else {
+        SSL_CTX_set_session_cache_mode(
+            tls->ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        SSL_CTX_sess_set_new_cb(tls->ctx, _tcp_tls_new_session);
+    }
+    tls->handle.opaque = tls;
+    tls->maxsessions   = cache;
+    atomic_init(&tls->refcnt, 1);
+
+    mtx_init(&tls->mtx, mtx_plain);
+    xcomm_rbtree_init(&tls->sessions, xcomm_rbtree_keycmp_str);
+    xcomm_list_init(&tls->lru);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+    return &tls->handle;
+
+fail:
+    SSL_CTX_free(tls->ctx);
+    free(tls);
+    return NULL;
+}
+
+/** connections still using the context keep it alive until they close. */
+void xcomm_tcp_tls_destroy(xcomm_tcp_tls_t* tls) {
+    xcomm_logi("%s enter.\n", __FUNCTION__);
+
+    xcomm_tcp_tls_unref(tls->opaque);
+
+    xcomm_logi("%s leave.\n", __FUNCTION__);
+}
+
+void xcomm_tcp_tls_ref(tcp_tls_t* tls) {
+    atomic_fetch_add(&tls->refcnt, 1);
+}
+
+void xcomm_tcp_tls_unref(tcp_tls_t* tls) {
+    if (atomic_fetch_sub(&tls->refcnt, 1) == 1) {
+        _tcp_tls_free(tls);
+    }
+}
+
+/**
+ * host and port are only used by clients, for sni, peer name checks and to
+ * look up a session to resume.
+ */
+tcp_tls_conn_t* xcomm_tcp_tls_conn_create(
+    tcp_tls_t* tls, const char* restrict host, const char* restrict port) {
+    tcp_tls_conn_t* conn = calloc(1, sizeof(tcp_tls_conn_t));
+    if (!conn) {
+        return NULL;
+    }
+    if (!tls->server) {
+        size_t len = strlen(host) + strlen(port) + 2;
+
+        conn->key = malloc(len);
+        if (!conn->key) {
+            free(conn);
+            return NULL;
+        }
+        snprintf(conn->key, len, "%s:%s", host, port);
+    }
+    conn->tls  = tls;
+    conn->ssl  = SSL_new(tls->ctx);
+    conn->rbio = BIO_new(BIO_s_mem());
+    conn->wbio = BIO_new(BIO_s_mem());
+
+    if (!conn->ssl || !conn->rbio || !conn->wbio) {
+        _tcp_tls_log_error("session");
+        SSL_free(conn->ssl);
+        BIO_free(conn->rbio);
+        BIO_free(conn->wbio);
+        free(conn->key);
+        free(conn);
+        return NULL;
+    }
+    /** an empty read bio means more bytes are due, not end of stream. */
+    BIO_set_mem_eof_return(conn->rbio, -1);
+    SSL_set_bio(conn->ssl, conn->rbio, conn->wbio);
+    SSL_set_app_data(conn->ssl, conn);
+
+    if (tls->server) {
+        SSL_set_accept_state(conn->ssl);
+    } else {
+        SSL_set_connect_state(conn->ssl);
+
+        bool numeric = _tcp_tls_numeric(host);
+        if (!numeric) {
+            SSL_set_tlsext_host_name(conn->ssl, host);
+        }
+        if (SSL_CTX_get_verify_mode(tls->ctx) & SSL_VERIFY_PEER) {
+            if (numeric) {
+                X509_VERIFY_PARAM_set1_ip_asc(SSL_get0_param(conn->ssl), host);
+            } else {
+                SSL_set1_host(conn->ssl, host);
+            }
+        }
+        SSL_SESSION* session = _tcp_tls_session_get(tls, conn->key);
+        if (session) {
+            SSL_set_session(conn->ssl, session);
+            SSL_SESSION_free(session);
+        }
+    }
+    xcomm_tcp_tls_ref(tls);
+    return conn;
+}
+
+void xcomm_tcp_tls_conn_destroy(tcp_tls_conn_t* conn) {
+    tcp_tls_t* tls = conn->tls;
+
+    OPENSSL_cleanse(&conn->ktls, sizeof(conn->ktls));
+    SSL_free(conn->ssl);
+    BIO_free(conn->backlog);
+    free(conn->key);
+    free(conn);
+
+    xcomm_tcp_tls_unref(tls);
+}
+
+bool xcomm_tcp_tls_conn_server(tcp_tls_conn_t* conn) {
+    return conn->tls->server;
+}
+
+/** hands ciphertext read from the socket to the session. */
+int xcomm_tcp_tls_conn_feed(tcp_tls_conn_t* conn, const void* buf, size_t len) {
+    if (len > INT_MAX || BIO_write(conn->rbio, buf, (int)len) != (int)len) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * parks ciphertext while a handshake step owns the session, returns 1 once
+ * the backlog is full and the caller should stop reading, -1 on failure.
+ */
+int xcomm_tcp_tls_conn_stash(tcp_tls_conn_t* conn, const void* buf, size_t len) {
+    if (!conn->backlog) {
+        conn->backlog = BIO_new(BIO_s_mem());
+        if (!conn->backlog) {
+            return -1;
+        }
+    }
+    if (len > INT_MAX || BIO_write(conn->backlog, buf, (int)len) != (int)len) {
+        return -1;
+    }
+    return BIO_ctrl_pending(conn->backlog) >= TCP_TLS_BACKLOG;
+}
+
+/** moves parked ciphertext to the session, returns its length or -1. */
+int xcomm_tcp_tls_conn_unstash(tcp_tls_conn_t* conn) {
+    char* buf;
+
+    if (!conn->backlog) {
+        return 0;
+    }
+    long len = BIO_get_mem_data(conn->backlog, &buf);
+    if (len <= 0) {
+        return 0;
+    }
+    if (xcomm_tcp_tls_conn_feed(conn, buf, (size_t)len)) {
+        return -1;
+    }
+    BIO_free(conn->backlog);
+    conn->backlog = NULL;
+    return (int)len;
+}
+
+/** returns 1 once established, 0 while more bytes are due, -1 on failure. */
+int xcomm_tcp_tls_conn_handshake(tcp_tls_conn_t* conn) {
+    ERR_clear_error();
+
+    int rc = SSL_do_handshake(conn->ssl);
+    if (rc == 1) {
+        if (conn->tls->ktls) {
+            _tcp_tls_ktls_prepare(conn);
+            /** the kernel needs it again to answer key updates. */
+            if (conn->ktls.state != TCP_TLS_KTLS_PENDING) {
+                OPENSSL_cleanse(conn->ktls.secret, sizeof(conn->ktls.secret));
+                conn->ktls.secretlen = 0;
+            }
+        }
+        return 1;
+    }
+    int err = SSL_get_error(conn->ssl, rc);
+    if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE) {
+        return 0;
+    }
+    _tcp_tls_log_error("handshake");
+
+    /** do not offer the session again, the next attempt starts clean. */
+    if (conn->key) {
+        _tcp_tls_session_drop(conn->tls, conn->key);
+    }
+    return -1;
+}
+
+/** returns the plaintext length, 0 while more bytes are due, -1 at the end. */
+int xcomm_tcp_tls_conn_read(tcp_tls_conn_t* conn, void* buf, int len) {
+    ERR_clear_error();
+
+    int n = SSL_read(conn->ssl, buf, len);
+    if (n > 0) {
+        return n;
+    }
+    int err = SSL_get_error(conn->ssl, n);
+    if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE) {
+        return 0;
+    }
+    if (err != SSL_ERROR_ZERO_RETURN) {
+        _tcp_tls_log_error("read");
+    }
+    return -1;
+}
+
+/** the write bio grows as needed, so the whole buffer is always taken. */
+int xcomm_tcp_tls_conn_write(tcp_tls_conn_t* conn, const void* buf, int len) {
+    ERR_clear_error();
+
+    if (SSL_write(conn->ssl, buf, len) != len) {
+        _tcp_tls_log_error("write");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * ciphertext due on the socket. it is sent straight out of the write bio
+ * and consumed by what the socket took.
+ */
+size_t xcomm_tcp_tls_conn_output(tcp_tls_conn_t* conn, char** buf) {
+    long len = BIO_get_mem_data(conn->wbio, buf);
+
+    return len > 0 ? (size_t)len : 0;
+}
+
+void xcomm_tcp_tls_conn_consume(tcp_tls_conn_t* conn, size_t len) {
+    char skip[4096];
+
+    while (len > 0) {
+        int n = BIO_read(
+            conn->wbio, skip, len > sizeof(skip) ? (int)sizeof(skip) : (int)len);
+        if (n <= 0) {
+            break;
+        }
+        len -= n;
+    }
+}
+
+/**
+ * queues close_notify, openssl only keeps a session resumable after it.
+ * under ktls the alert is the caller's to send and openssl is just told.
+ */
+void xcomm_tcp_tls_conn_shutdown(tcp_tls_conn_t* conn) {
+    if (conn->ktls.state == TCP_TLS_KTLS_ACTIVE) {
+        SSL_set_shutdown(conn->ssl, SSL_get_shutdown(conn->ssl) | SSL_SENT_SHUTDOWN);
+        return;
+    }
+    ERR_clear_error();
+    SSL_shutdown(conn->ssl);
+    ERR_clear_error();
+}
+
+tcp_tls_ktls_t xcomm_tcp_tls_conn_ktls(tcp_tls_conn_t* conn) {
+    return conn->ktls.state;
+}
+
+/**
+ * call once every record openssl wrote before the key update reached the
+ * socket. on failure openssl carries on with the same keys in userspace.
+ */
+bool xcomm_tcp_tls_conn_ktls_enable(tcp_tls_conn_t* conn, platform_sock_t sock) {
+    /** a record written under the new keys already took sequence zero. */
+    bool ok = BIO_number_written(conn->wbio) == conn->ktls.written &&
+              platform_socket_enable_ktls(
+                  sock, conn->ktls.cipher, conn->ktls.key, conn->ktls.iv, 0);
+
+    OPENSSL_cleanse(conn->ktls.key, sizeof(conn->ktls.key));
+    OPENSSL_cleanse(conn->ktls.iv, sizeof(conn->ktls.iv));
+
+    conn->ktls.state = ok ? TCP_TLS_KTLS_ACTIVE : TCP_TLS_KTLS_OFF;
+    if (!ok) {
+        OPENSSL_cleanse(conn->ktls.secret, sizeof(conn->ktls.secret));
+        conn->ktls.secretlen = 0;
+        xcomm_logw("ktls not supported, fall back to userspace tls.\n");
+    }
+    return ok;
+}
+
+bool xcomm_tcp_tls_conn_ktls_due(tcp_tls_conn_t* conn) {
+    char* out;
+
+    return conn->ktls.update || xcomm_tcp_tls_conn_output(conn, &out) > 0;
+}
+
+/**
+ * answers a peer key update under ktls. the reply openssl queued is sealed
+ * with keys the socket no longer uses and is dropped, the kernel sends a
+ * fresh one and moves on to the next keys. returns 0 when done or nothing
+ * was due, 1 while the socket is full, -1 on failure or when openssl queued
+ * anything else.
+ */
+int xcomm_tcp_tls_conn_ktls_update(tcp_tls_conn_t* conn, platform_sock_t sock) {
+    uint8_t msg[5] = {SSL3_MT_KEY_UPDATE, 0, 0, 1, SSL_KEY_UPDATE_NOT_REQUESTED};
+    char*   out;
+    size_t  len = xcomm_tcp_tls_conn_output(conn, &out);
+
+    if (!conn->ktls.update) {
+        return len > 0 ? -1 : 0;
+    }
+    xcomm_tcp_tls_conn_consume(conn, len);
+
+    if (platform_socket_send_record(
+            sock, TCP_TLS_HANDSHAKE_RECORD, msg, sizeof(msg)) < 0) {
+        int err = platform_socket_get_lasterror();
+        return err == PLATFORM_SO_ERROR_EAGAIN ||
+                       err == PLATFORM_SO_ERROR_EWOULDBLOCK
+                   ? 1
+                   : -1;
+    }
+    conn->ktls.update = false;
+
+    bool ok = !_tcp_tls_ktls_next(conn) &&
+              platform_socket_enable_ktls(
+                  sock, conn->ktls.cipher, conn->ktls.key, conn->ktls.iv, 0);
+
+    OPENSSL_cleanse(conn->ktls.key, sizeof(conn->ktls.key));
+    OPENSSL_cleanse(conn->ktls.iv, sizeof(conn->ktls.iv));
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,128 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+_Pragma("once")
+
+#include <stdatomic.h>
+
+#include "xcomm-list.h"
+#include "xcomm-rbtree.h"
+#include "xcomm/xcomm-tcp-module.h"
+#include "platform/platform-types.h"
+
+/** windows.h has to be in before the openssl headers. */
+#include <openssl/ssl.h>
+
+#define TCP_TLS_RECORD            16384
+#define TCP_TLS_WRITE_CHUNK       65536
+#define TCP_TLS_SESSION_CACHE     1024
+#define TCP_TLS_SESSION_TIMEOUT   7200
+#define TCP_TLS_HANDSHAKE_TIMEOUT 10000
+#define TCP_TLS_ALERT_RECORD      21
+#define TCP_TLS_HANDSHAKE_RECORD  22
+#define TCP_TLS_BACKLOG           (1024 * 1024)
+
+typedef enum tcp_tls_ktls_e tcp_tls_ktls_t;
+
+typedef struct tcp_tls_s         tcp_tls_t;
+typedef struct tcp_tls_session_s tcp_tls_session_t;
+typedef struct tcp_tls_conn_s    tcp_tls_conn_t;
+
+enum tcp_tls_ktls_e {
+    TCP_TLS_KTLS_OFF     = 0,
+    TCP_TLS_KTLS_PENDING = 1,
+    TCP_TLS_KTLS_ACTIVE  = 2,
+};
+
+/** a resumable client session for one host:port, lru holds the newest first. */
+struct tcp_tls_session_s {
+    xcomm_rbtree_node_t node;
+    SSL_SESSION*        session;
+    xcomm_list_node_t   lru;
+};
+
+/**
+ * shared by every connection on every worker. servers resume from the
+ * context's own session cache and tickets, clients from the sessions kept
+ * here under the mutex. the owner and every connection hold a reference.
+ */
+struct tcp_tls_s {
+    xcomm_tcp_tls_t handle;
+    SSL_CTX*        ctx;
+    bool            server;
+    bool            ktls;
+    atomic_int      refcnt;
+    mtx_t           mtx;
+    xcomm_rbtree_t  sessions;
+    xcomm_list_t    lru;
+    int             nsessions;
+    int             maxsessions;
+};
+
+/**
+ * per connection state, touched only from the connection's loop, except for
+ * handshake steps which run on the engine crypto pool. ciphertext arriving
+ * meanwhile waits in backlog, which the pool never touches. with ktls
+ * the sending traffic secret is kept for as long as the kernel sends, the
+ * keys derived from it wait in pending until the socket took all prior
+ * records. update is set when the peer asked for a key update of ours.
+ */
+struct tcp_tls_conn_s {
+    tcp_tls_t* tls;
+    SSL*       ssl;
+    BIO*       rbio;
+    BIO*       wbio;
+    BIO*       backlog;
+    char*      key;
+
+    struct {
+        tcp_tls_ktls_t         state;
+        platform_ktls_cipher_t cipher;
+        bool                   update;
+        uint64_t               written;
+        size_t                 secretlen;
+        uint8_t                secret[EVP_MAX_MD_SIZE];
+        uint8_t                key[32];
+        uint8_t                iv[12];
+    } ktls;
+};
+
+extern xcomm_tcp_tls_t* xcomm_tcp_tls_create(const xcomm_tcp_tls_config_t* config);
+extern void             xcomm_tcp_tls_destroy(xcomm_tcp_tls_t* tls);
+extern void             xcomm_tcp_tls_ref(tcp_tls_t* tls);
+extern void             xcomm_tcp_tls_unref(tcp_tls_t* tls);
+
+extern tcp_tls_conn_t* xcomm_tcp_tls_conn_create(tcp_tls_t* tls, const char* restrict host, const char* restrict port);
+extern void            xcomm_tcp_tls_conn_destroy(tcp_tls_conn_t* conn);
+extern bool            xcomm_tcp_tls_conn_server(tcp_tls_conn_t* conn);
+extern int             xcomm_tcp_tls_conn_feed(tcp_tls_conn_t* conn, const void* buf, size_t len);
+extern int             xcomm_tcp_tls_conn_stash(tcp_tls_conn_t* conn, const void* buf, size_t len);
+extern int             xcomm_tcp_tls_conn_unstash(tcp_tls_conn_t* conn);
+extern int             xcomm_tcp_tls_conn_handshake(tcp_tls_conn_t* conn);
+extern int             xcomm_tcp_tls_conn_read(tcp_tls_conn_t* conn, void* buf, int len);
+extern int             xcomm_tcp_tls_conn_write(tcp_tls_conn_t* conn, const void* buf, int len);
+extern size_t          xcomm_tcp_tls_conn_output(tcp_tls_conn_t* conn, char** buf);
+extern void            xcomm_tcp_tls_conn_consume(tcp_tls_conn_t* conn, size_t len);
+extern void            xcomm_tcp_tls_conn_shutdown(tcp_tls_conn_t* conn);
+extern tcp_tls_ktls_t  xcomm_tcp_tls_conn_ktls(tcp_tls_conn_t* conn);
+extern bool            xcomm_tcp_tls_conn_ktls_enable(tcp_tls_conn_t* conn, platform_sock_t sock);
+extern bool            xcomm_tcp_tls_conn_ktls_due(tcp_tls_conn_t* conn);
+extern int             xcomm_tcp_tls_conn_ktls_update(tcp_tls_conn_t* conn, platform_sock_t sock);
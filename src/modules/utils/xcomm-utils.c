@@ -21,6 +21,7 @@
 
 #include "xcomm-utils.h"
 #include "xcomm-logger.h"
+#include "xcomm-engine.h"
 #include "xcomm-event-timer.h"
 #include "xcomm-event-routine.h"
 
@@ -34,8 +35,6 @@ struct async_timer_context_s {
     xcomm_event_loop_t*  loop;
 };
 
-extern engine_t engine;
-
 static void _async_timer_add(void* param) {
     async_timer_context_t* context = param;
 
@@ -51,7 +50,8 @@ static void _async_timer_add(void* param) {
 
 void xcomm_utils_post_routine(void (*routine)(void* param), void* param) {
     xcomm_logi("%s enter.\n", __FUNCTION__);
-    engine.roundrobin();
+
+    xcomm_event_loop_t* loop = &engine.roundrobin()->looper;
     xcomm_event_routine_add(loop, routine, param);
 
     xcomm_logi("%s leave.\n", __FUNCTION__);
@@ -64,6 +64,7 @@ void xcomm_utils_post_timer(
     bool     repeat) {
     xcomm_logi("%s enter.\n", __FUNCTION__);
 
+    xcomm_event_loop_t*    loop = &engine.roundrobin()->looper;
     async_timer_context_t* context = malloc(sizeof(async_timer_context_t));
     if (!context) {
         return;
@@ -26,4 +26,8 @@ _Pragma("once")
 extern platform_tid_t platform_info_gettid(void);
 extern platform_pid_t platform_info_getpid(void);
 extern int            platform_info_getcpus(void);
-extern void           platform_info_getlocaltime(const time_t* restrict time, struct tm* restrict tm);
\ No newline at end of file
+/** a negative cpu lets the thread run on any cpu again. */
+extern void           platform_info_setaffinity(int cpu);
+extern void           platform_info_getlocaltime(const time_t* restrict time, struct tm* restrict tm);
+/** nanoseconds from an unspecified start, never steps with the wall clock. */
+extern uint64_t       platform_info_getclock(void);
\ No newline at end of file
@@ -24,5 +24,8 @@ _Pragma("once")
 #include <stdio.h>
 #include <stdarg.h>
 
+#include "platform-types.h"
+
 extern FILE* platform_io_fopen(const char* restrict file, const char* restrict mode);
-extern int platform_io_vsprintf(char* str, size_t size, const char* restrict format, va_list ap);
\ No newline at end of file
+extern int platform_io_vsprintf(char* str, size_t size, const char* restrict format, va_list ap);
+extern ssize_t platform_io_pread(int fd, void* buf, size_t size, int64_t offset);
\ No newline at end of file
@@ -0,0 +1,41 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+_Pragma("once")
+
+#include "platform-types.h"
+
+/**
+ * named shared memory. create replaces a region left behind under the same
+ * name, open reports the mapped size through size.
+ */
+extern void* platform_shm_create(const char* restrict name, size_t size);
+extern void* platform_shm_open(const char* restrict name, size_t* size);
+extern void  platform_shm_close(void* addr, size_t size);
+extern void  platform_shm_unlink(const char* restrict name);
+
+/**
+ * cross process doorbell on a word inside shared memory. wait sleeps while
+ * the word still holds expected, at most timeout_ms (-1 forever), and may
+ * return early. where the kernel has no such primitive it naps instead.
+ */
+extern void platform_shm_wait(atomic_uint* word, unsigned int expected, int timeout_ms);
+extern void platform_shm_wake(atomic_uint* word);
@@ -26,10 +26,14 @@ _Pragma("once")
 extern void    platform_socket_startup(void);
 extern void    platform_socket_cleanup(void);
 extern void    platform_socket_close(platform_sock_t sock);
+extern void    platform_socket_shutdown_write(platform_sock_t sock);
 extern ssize_t platform_socket_recv(platform_sock_t sock, void* buf, int size);
 extern ssize_t platform_socket_send(platform_sock_t sock, void* buf, int size);
-extern ssize_t platform_socket_recvall(platform_sock_t sock, void* buf, int size);
-extern ssize_t platform_socket_sendall(platform_sock_t sock, void* buf, int size);
+extern ssize_t platform_socket_recvall(platform_sock_t sock, void* buf, size_t size);
+extern ssize_t platform_socket_sendall(platform_sock_t sock, void* buf, size_t size);
+extern ssize_t platform_socket_recvv(platform_sock_t sock, const platform_iovec_t* iov, int iovcnt);
+extern ssize_t platform_socket_sendv(platform_sock_t sock, const platform_iovec_t* iov, int iovcnt);
+extern ssize_t platform_socket_peek(platform_sock_t sock, void* buf, int size);
 extern ssize_t platform_socket_recvfrom(platform_sock_t sock, void* buf, int size, struct sockaddr_storage* ss, socklen_t* sslen);
 extern ssize_t platform_socket_sendto(platform_sock_t sock, void* buf, int size, struct sockaddr_storage* ss, socklen_t sslen);
 extern int     platform_socket_socketpair(int domain, int type, int protocol, platform_sock_t socks[2]);
@@ -37,23 +41,52 @@ extern char*   platform_socket_tostring(int error);
 extern platform_sock_t platform_socket_accept(platform_sock_t sock, bool nonblocking);
 extern platform_sock_t platform_socket_listen(const char* restrict host, const char* restrict port, int protocol, int idx, int cores, bool nonblocking);
 extern platform_sock_t platform_socket_dial(const char* restrict host, const char* restrict port, int protocol, bool* connected, bool  nonblocking);
+extern platform_sock_t platform_socket_connect(const struct sockaddr* sa, socklen_t salen, int protocol, bool* connected, bool nonblocking);
+/** open plus start_connect leaves room for options that shape the syn. */
+extern platform_sock_t platform_socket_open(int family, int protocol, bool nonblocking);
+extern int     platform_socket_start_connect(platform_sock_t sock, const struct sockaddr* sa, socklen_t salen, bool* connected);
+extern int     platform_socket_wait_writable(platform_sock_t* socks, bool* ready, int nsocks, int timeout_ms);
+extern int     platform_socket_getaddrinfo(const char* restrict host, const char* restrict port, int protocol, struct sockaddr_storage* addrs, socklen_t* addrlens, int maxaddrs);
+extern ssize_t platform_socket_send_zerocopy(platform_sock_t sock, void* buf, int size);
+extern int     platform_socket_recv_zerocopy(platform_sock_t sock, uint32_t* lo, uint32_t* hi, bool* copied);
+extern ssize_t platform_socket_send_record(platform_sock_t sock, uint8_t type, void* buf, int size);
+extern ssize_t platform_socket_sendfile(platform_sock_t sock, int fd, int64_t offset, size_t size);
+extern int     platform_socket_unix_address(const char* restrict path, struct sockaddr_storage* ss, socklen_t* sslen);
+extern platform_sock_t platform_socket_listen_unix(const char* restrict path, bool nonblocking);
+extern ssize_t platform_socket_send_fd(platform_sock_t sock, int fd, void* buf, int size);
+extern ssize_t platform_socket_recv_fd(platform_sock_t sock, int* fd, void* buf, int size);
+extern int     platform_socket_pipe(int fds[2]);
+extern void    platform_socket_pipe_close(int fds[2]);
+extern ssize_t platform_socket_splice_in(platform_sock_t sock, int pipefd, size_t size);
+extern ssize_t platform_socket_splice_out(int pipefd, platform_sock_t sock, size_t size);
+extern ssize_t platform_socket_pipe_write(int pipefd, const void* buf, size_t size);
 
 extern void platform_socket_set_rcvtimeout(platform_sock_t sock, int timeout_ms);
 extern void platform_socket_set_sndtimeout(platform_sock_t sock, int timeout_ms);
 extern void platform_socket_set_rcvbuf(platform_sock_t sock, int val);
 extern void platform_socket_set_sndbuf(platform_sock_t sock, int val);
 extern void platform_socket_set_rss(platform_sock_t sock, uint16_t idx, int cores);
+extern void platform_socket_set_maxseg(platform_sock_t sock, int mss);
+extern void platform_socket_set_keepalive(platform_sock_t sock, bool on, int idle, int intvl, int cnt);
+extern void platform_socket_set_busypoll(platform_sock_t sock, int usec);
+extern void platform_socket_set_notsent_lowat(platform_sock_t sock, int bytes);
 extern int  platform_socket_get_addressfamily(platform_sock_t sock);
 extern int  platform_socket_get_socktype(platform_sock_t sock);
 extern int  platform_socket_get_lasterror(void);
+extern int  platform_socket_get_soerror(platform_sock_t sock);
+extern int  platform_socket_get_tcpinfo(platform_sock_t sock, platform_tcp_info_t* info);
+extern bool platform_socket_is_idle(platform_sock_t sock);
 
 extern void platform_socket_enable_nodelay(platform_sock_t sock, bool on);
 extern void platform_socket_enable_v6only(platform_sock_t sock, bool on);
-extern void platform_socket_enable_keepalive(platform_sock_t sock, bool on);
-extern void platform_socket_enable_maxseg(platform_sock_t sock, bool on);
+extern void platform_socket_enable_cork(platform_sock_t sock, bool on);
+extern void platform_socket_enable_quickack(platform_sock_t sock, bool on);
 extern void platform_socket_enable_nonblocking(platform_sock_t sock, bool on);
 extern void platform_socket_enable_reuseaddr(platform_sock_t sock, bool on);
 extern void platform_socket_enable_reuseport(platform_sock_t sock, bool on);
+extern bool platform_socket_enable_zerocopy(platform_sock_t sock, bool on);
+extern bool platform_socket_enable_ktls(platform_sock_t sock, platform_ktls_cipher_t cipher, const uint8_t* key, const uint8_t* iv, uint64_t seq);
+extern bool platform_socket_ktls_rekey(void);
 
 
 
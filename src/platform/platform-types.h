@@ -23,8 +23,10 @@ _Pragma("once")
 
 #include "deprecated/c11-threads.h"
 #include <errno.h>
+#include <limits.h>
 #include <stdatomic.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -38,28 +40,45 @@ _Pragma("once")
 #include <netdb.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
+#include <poll.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/un.h>
 #include <unistd.h>
 #include <termios.h>
+#include <sys/ioctl.h>
 
 #if defined(__linux__)
+#include <linux/errqueue.h>
 #include <linux/filter.h>
+#include <linux/serial.h>
+#include <linux/tls.h>
 #include <sys/epoll.h>
+#include <sys/sendfile.h>
 #include <sys/syscall.h>
 #endif
 
+#if defined(__FreeBSD__)
+#include <sys/uio.h>
+#endif
+
 #if defined(__APPLE__)
 #include <sys/event.h>
+#include <IOKit/serial/ioss.h>
 #endif
 
 #define PLATFORM_SO_ERROR_EAGAIN          EAGAIN
 #define PLATFORM_SO_ERROR_EWOULDBLOCK     EWOULDBLOCK
 #define PLATFORM_SO_ERROR_ECONNRESET      ECONNRESET
 #define PLATFORM_SO_ERROR_ETIMEDOUT       ETIMEDOUT
+#define PLATFORM_SO_ERROR_ENOBUFS         ENOBUFS
+#define PLATFORM_SO_ERROR_ECONNABORTED    ECONNABORTED
+#define PLATFORM_SO_ERROR_EHOSTUNREACH    EHOSTUNREACH
 #define PLATFORM_SO_ERROR_INVALID_SOCKET  -1
 #define PLATFORM_SO_ERROR_SOCKET_ERROR    -1
 
+#define PLATFORM_UA_ERROR_EAGAIN          EAGAIN
 #define PLATFORM_UA_ERROR_INVALID_UART    -1
 #define PLATFORM_UA_ERROR_UART_ERROR      -1
 
@@ -73,6 +92,7 @@ _Pragma("once")
 #include <WS2tcpip.h>
 #include <WinSock2.h>
 #include <Windows.h>
+#include <afunix.h>
 #include <mstcpip.h>
 #include <process.h>
 #include <ws2ipdef.h>
@@ -81,9 +101,13 @@ _Pragma("once")
 #define PLATFORM_SO_ERROR_EWOULDBLOCK     WSAEWOULDBLOCK
 #define PLATFORM_SO_ERROR_ECONNRESET      WSAECONNRESET
 #define PLATFORM_SO_ERROR_ETIMEDOUT       WSAETIMEDOUT
+#define PLATFORM_SO_ERROR_ENOBUFS         WSAENOBUFS
+#define PLATFORM_SO_ERROR_ECONNABORTED    WSAECONNABORTED
+#define PLATFORM_SO_ERROR_EHOSTUNREACH    WSAEHOSTUNREACH
 #define PLATFORM_SO_ERROR_INVALID_SOCKET  INVALID_SOCKET
 #define PLATFORM_SO_ERROR_SOCKET_ERROR    SOCKET_ERROR
 
+#define PLATFORM_UA_ERROR_EAGAIN          ERROR_IO_PENDING
 #define PLATFORM_UA_ERROR_INVALID_UART    INVALID_HANDLE_VALUE
 #define PLATFORM_UA_ERROR_UART_ERROR      -1
 
@@ -93,6 +117,7 @@ _Pragma("once")
 #endif
 
 #define PLATFORM_POLLER_CQE_NUM 64
+#define PLATFORM_SO_IOV_MAX     64
 
 #if defined(__linux__) || defined(__APPLE__)
 #if defined(__APPLE__)
@@ -123,10 +148,39 @@ typedef enum platform_poller_op_e      platform_poller_op_t;
 typedef struct platform_poller_cqe_s   platform_poller_cqe_t;
 typedef struct platform_poller_sqe_s   platform_poller_sqe_t;
 typedef struct platform_uart_config_s  platform_uart_config_t;
-typedef enum platform_uart_baudrate_e  platform_uart_baudrate_t;
 typedef enum platform_uart_parity_e    platform_uart_parity_t;
 typedef enum platform_uart_databits_e  platform_uart_databits_t;
 typedef enum platform_uart_stopbits_e  platform_uart_stopbits_t;
+typedef enum platform_ktls_cipher_e    platform_ktls_cipher_t;
+typedef struct platform_iovec_s        platform_iovec_t;
+typedef struct platform_tcp_info_s     platform_tcp_info_t;
+
+enum platform_poller_op_e {
+    PLATFORM_POLLER_NO_OP = 0,
+    PLATFORM_POLLER_RD_OP = 1,
+    PLATFORM_POLLER_WR_OP = 2,
+    PLATFORM_POLLER_RW_OP = 3,
+};
+
+enum platform_ktls_cipher_e {
+    PLATFORM_KTLS_CIPHER_AES_GCM_128       = 1,
+    PLATFORM_KTLS_CIPHER_AES_GCM_256       = 2,
+    PLATFORM_KTLS_CIPHER_CHACHA20_POLY1305 = 3,
+};
+
+struct platform_iovec_s {
+    void*  base;
+    size_t len;
+};
+
+/** rtt in microseconds, cwnd in segments, delivery_rate in bytes per second. */
+struct platform_tcp_info_s {
+    uint32_t rtt_us;
+    uint32_t rttvar_us;
+    uint32_t retransmits;
+    uint32_t cwnd;
+    uint64_t delivery_rate;
+};
 
 struct platform_poller_cqe_s {
     platform_poller_op_t op;
@@ -139,21 +193,6 @@ struct platform_poller_sqe_s {
     void*                ud;
 };
 
-enum platform_poller_op_e {
-    PLATFORM_POLLER_NO_OP = 0,
-    PLATFORM_POLLER_RD_OP = 1,
-    PLATFORM_POLLER_WR_OP = 2,
-    PLATFORM_POLLER_RW_OP = 3,
-};
-
-enum platform_uart_baudrate_e {
-    PLATFORM_UART_BAUDRATE_9600,
-    PLATFORM_UART_BAUDRATE_19200,
-    PLATFORM_UART_BAUDRATE_38400,
-    PLATFORM_UART_BAUDRATE_57600,
-    PLATFORM_UART_BAUDRATE_115200,
-};
-
 enum platform_uart_parity_e { 
     PLATFORM_UART_PARITY_NO,
     PLATFORM_UART_PARITY_ODD,
@@ -170,11 +209,22 @@ enum platform_uart_stopbits_e {
     PLATFORM_UART_STOPBITS_TWO,
 };
 
+/** baudrate is in bits per second, rates without a termios constant are set as custom speeds. */
 struct platform_uart_config_s {
     const char* restrict     device;
-    platform_uart_baudrate_t baudrate;
+    uint32_t                 baudrate;
     platform_uart_parity_t   parity;
     platform_uart_databits_t databits;
     platform_uart_stopbits_t stopbits;
     size_t                   timeout_ms;
+    size_t                   interbyte_timeout_ms;
+    bool                     low_latency;
+    int                      latency_timer_ms;
+
+    struct {
+        bool     enabled;
+        bool     rts_on_send;
+        uint32_t delay_before_send_ms;
+        uint32_t delay_after_send_ms;
+    } rs485;
 };
\ No newline at end of file
@@ -24,6 +24,9 @@ _Pragma("once")
 #include "platform-types.h"
 
 extern void platform_uart_close(platform_uart_t uart);
-extern int  platform_uart_read(platform_uart_t uart, uint8_t* buf, int len);
+extern int  platform_uart_read(platform_uart_t uart, uint8_t* buf, int len, size_t timeout_ms, size_t interbyte_timeout_ms);
 extern int  platform_uart_write(platform_uart_t uart, uint8_t* buf, int len);
-extern platform_uart_t platform_uart_open(platform_uart_config_t* config);
\ No newline at end of file
+extern int  platform_uart_read_some(platform_uart_t uart, uint8_t* buf, int len);
+extern int  platform_uart_write_some(platform_uart_t uart, uint8_t* buf, int len);
+extern int  platform_uart_get_lasterror(void);
+extern platform_uart_t platform_uart_open(platform_uart_config_t* config, bool nonblocking);
\ No newline at end of file
@@ -19,6 +19,11 @@
  *  IN THE SOFTWARE.
  */
 
+#if defined(__linux__)
+#define _GNU_SOURCE
+#include <sched.h>
+#endif
+
 #include "platform/platform-info.h"
 
 int platform_info_getcpus(void) {
@@ -35,17 +40,44 @@ void platform_info_getlocaltime(
     localtime_r(time, tm);
 }
 
+uint64_t platform_info_getclock(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
 #if defined(__APPLE__)
 platform_tid_t platform_info_gettid(void) {
     uint64_t tid;
     pthread_threadid_np(NULL, &tid);
     return tid;
 }
+
+void platform_info_setaffinity(int cpu) {
+    /** macos offers affinity hints only, threads can not be pinned. */
+    (void)(cpu);
+}
 #endif
 
 #if defined(__linux__)
 platform_tid_t platform_info_gettid(void) {
     return syscall(SYS_gettid);
 }
+
+void platform_info_setaffinity(int cpu) {
+    cpu_set_t set;
+
+    CPU_ZERO(&set);
+    if (cpu < 0) {
+        for (int i = 0; i < CPU_SETSIZE; i++) {
+            CPU_SET(i, &set);
+        }
+    } else if (cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, &set);
+    } else {
+        return;
+    }
+    sched_setaffinity(0, sizeof(cpu_set_t), &set);
+}
 #endif
 
@@ -27,4 +27,12 @@ FILE* platform_io_fopen(const char* restrict file, const char* restrict mode) {
 
 int platform_io_vsprintf(char* str, size_t size, const char* restrict format, va_list ap) {
     return vsnprintf(str, size, format, ap);
-}
\ No newline at end of file
+}
+
+ssize_t platform_io_pread(int fd, void* buf, size_t size, int64_t offset) {
+    ssize_t n;
+    do {
+        n = pread(fd, buf, size, (off_t)offset);
+    } while (n == -1 && errno == EINTR);
+    return n;
+}
@@ -0,0 +1,114 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "platform/platform-shm.h"
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#endif
+
+#include <sys/mman.h>
+
+/** fails with EEXIST while the name is taken, a live owner keeps its region. */
+void* platform_shm_create(const char* restrict name, size_t size) {
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd == -1) {
+        return NULL;
+    }
+    if (ftruncate(fd, (off_t)size) == -1) {
+        close(fd);
+        shm_unlink(name);
+        return NULL;
+    }
+    void* addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        shm_unlink(name);
+        return NULL;
+    }
+    return addr;
+}
+
+void* platform_shm_open(const char* restrict name, size_t* size) {
+    struct stat st;
+
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd == -1) {
+        return NULL;
+    }
+    if (fstat(fd, &st) == -1 || st.st_size == 0) {
+        close(fd);
+        return NULL;
+    }
+    void* addr = mmap(
+        NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return NULL;
+    }
+    *size = (size_t)st.st_size;
+    return addr;
+}
+
+void platform_shm_close(void* addr, size_t size) {
+    munmap(addr, size);
+}
+
+void platform_shm_unlink(const char* restrict name) {
+    shm_unlink(name);
+}
+
+#if defined(__linux__)
+void platform_shm_wait(atomic_uint* word, unsigned int expected, int timeout_ms) {
+    struct timespec ts;
+
+    if (timeout_ms >= 0) {
+        ts.tv_sec  = timeout_ms / 1000;
+        ts.tv_nsec = (long)(timeout_ms % 1000) * 1000000;
+    }
+    /** not FUTEX_PRIVATE_FLAG, the word is shared with another process. */
+    syscall(
+        SYS_futex,
+        (unsigned int*)word,
+        FUTEX_WAIT,
+        expected,
+        (timeout_ms >= 0) ? &ts : NULL,
+        NULL,
+        0);
+}
+
+void platform_shm_wake(atomic_uint* word) {
+    syscall(SYS_futex, (unsigned int*)word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+#endif
+
+/** no public futex on darwin, so nap instead. */
+#if defined(__APPLE__)
+void platform_shm_wait(atomic_uint* word, unsigned int expected, int timeout_ms) {
+    if (atomic_load(word) == expected && timeout_ms != 0) {
+        usleep(1000);
+    }
+}
+
+void platform_shm_wake(atomic_uint* word) {
+    (void)(word);
+}
+#endif
@@ -19,10 +19,11 @@
  *  IN THE SOFTWARE.
  */
 
-#include "platform/platform-socket.h"
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
 
-#define TCPv4_MSS 536
-#define TCPv6_MSS 1220
+#include "platform/platform-socket.h"
 
 void platform_socket_enable_nonblocking(platform_sock_t sock, bool on) {
     int flag = fcntl(sock, F_GETFL, 0);
@@ -48,16 +49,8 @@ void platform_socket_close(platform_sock_t sock) {
     close(sock);
 }
 
-platform_sock_t platform_socket_accept(platform_sock_t sock, bool nonblocking) {
-    platform_sock_t cli;
-    do {
-        cli = accept(sock, NULL, NULL);
-    } while (cli == PLATFORM_SO_ERROR_INVALID_SOCKET && errno == EINTR);
-    if (cli == PLATFORM_SO_ERROR_INVALID_SOCKET) {
-        return PLATFORM_SO_ERROR_INVALID_SOCKET;
-    }
-    platform_socket_enable_nonblocking(cli, nonblocking);
-    return cli;
+void platform_socket_shutdown_write(platform_sock_t sock) {
+    shutdown(sock, SHUT_WR);
 }
 
 void platform_socket_enable_nodelay(platform_sock_t sock, bool on) {
@@ -147,21 +140,18 @@ platform_sock_t platform_socket_listen(
             platform_socket_close(sock);
             continue;
         }
-        /**
-         * these options inherited by connection-socket.
-         */
         if (protocol == SOCK_STREAM) {
             if (listen(sock, SOMAXCONN) == PLATFORM_SO_ERROR_SOCKET_ERROR) {
                 platform_socket_close(sock);
                 continue;
             }
-            platform_socket_enable_maxseg(sock, true);
             /**
-             * must be after enable maxseg. due to enable maxseg set TCP_NOOPT
-             * on macos.
+             * sharded listeners, one per worker. the group exists only once
+             * the socket is bound, attaching earlier forks a separate group.
              */
-            platform_socket_enable_nodelay(sock, true);
-            platform_socket_enable_keepalive(sock, true);
+            if (nonblocking && cores > 1) {
+                platform_socket_set_rss(sock, idx, cores);
+            }
         }
         /**
          * this option not inherited by connection-socket.
@@ -183,13 +173,112 @@ void platform_socket_startup(void) {
 void platform_socket_cleanup(void) {
 }
 
+platform_sock_t
+platform_socket_open(int family, int protocol, bool nonblocking) {
+    platform_sock_t sock = socket(family, protocol, 0);
+    if (sock == PLATFORM_SO_ERROR_INVALID_SOCKET) {
+        return PLATFORM_SO_ERROR_INVALID_SOCKET;
+    }
+    platform_socket_enable_nonblocking(sock, nonblocking);
+    return sock;
+}
+
+int platform_socket_start_connect(
+    platform_sock_t        sock,
+    const struct sockaddr* sa,
+    socklen_t              salen,
+    bool*                  connected) {
+    int ret;
+
+    do {
+        ret = connect(sock, sa, salen);
+    } while (ret == PLATFORM_SO_ERROR_SOCKET_ERROR && errno == EINTR);
+    if (ret == PLATFORM_SO_ERROR_SOCKET_ERROR) {
+        if (errno == EINPROGRESS) {
+            return 0;
+        }
+        int err = errno;
+        platform_socket_close(sock);
+        errno = err;
+        return -1;
+    }
+    *connected = true;
+    return 0;
+}
+
+platform_sock_t platform_socket_connect(
+    const struct sockaddr* sa,
+    socklen_t              salen,
+    int                    protocol,
+    bool*                  connected,
+    bool                   nonblocking) {
+    platform_sock_t sock =
+        platform_socket_open(sa->sa_family, protocol, nonblocking);
+    if (sock == PLATFORM_SO_ERROR_INVALID_SOCKET) {
+        return PLATFORM_SO_ERROR_INVALID_SOCKET;
+    }
+    if (platform_socket_start_connect(sock, sa, salen, connected)) {
+        return PLATFORM_SO_ERROR_INVALID_SOCKET;
+    }
+    return sock;
+}
+
+int platform_socket_wait_writable(
+    platform_sock_t* socks, bool* ready, int nsocks, int timeout_ms) {
+    struct pollfd* pfds = malloc(nsocks * sizeof(struct pollfd));
+    if (!pfds) {
+        return -1;
+    }
+    for (int i = 0; i < nsocks; i++) {
+        pfds[i].fd = socks[i];
+        pfds[i].events = POLLOUT;
+        pfds[i].revents = 0;
+    }
+    int n = poll(pfds, nsocks, timeout_ms);
+    if (n < 0 && errno == EINTR) {
+        n = 0;
+    }
+    for (int i = 0; i < nsocks; i++) {
+        ready[i] = (n > 0) && (pfds[i].revents & (POLLOUT | POLLERR | POLLHUP));
+    }
+    free(pfds);
+    return n;
+}
+
+int platform_socket_getaddrinfo(
+    const char* restrict     host,
+    const char* restrict     port,
+    int                      protocol,
+    struct sockaddr_storage* addrs,
+    socklen_t*               addrlens,
+    int                      maxaddrs) {
+    int              n = 0;
+    struct addrinfo  hints;
+    struct addrinfo* res;
+    struct addrinfo* rp;
+
+    memset(&hints, 0, sizeof(struct addrinfo));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = protocol;
+
+    if (getaddrinfo(host, port, &hints, &res)) {
+        return -1;
+    }
+    for (rp = res; rp != NULL && n < maxaddrs; rp = rp->ai_next) {
+        memcpy(&addrs[n], rp->ai_addr, rp->ai_addrlen);
+        addrlens[n] = rp->ai_addrlen;
+        n++;
+    }
+    freeaddrinfo(res);
+    return n;
+}
+
 platform_sock_t platform_socket_dial(
     const char* restrict host,
     const char* restrict port,
     int                  protocol,
     bool*                connected,
     bool                 nonblocking) {
-    int              ret;
     platform_sock_t  sock = PLATFORM_SO_ERROR_INVALID_SOCKET;
     struct addrinfo  hints;
     struct addrinfo* res;
@@ -207,36 +296,11 @@ platform_sock_t platform_socket_dial(
         return PLATFORM_SO_ERROR_INVALID_SOCKET;
     }
     for (rp = res; rp != NULL; rp = rp->ai_next) {
-        sock = socket(rp->ai_family, rp->ai_socktype, rp->ai_protocol);
-        if (sock == PLATFORM_SO_ERROR_INVALID_SOCKET) {
-            continue;
+        sock = platform_socket_connect(
+            rp->ai_addr, rp->ai_addrlen, protocol, connected, nonblocking);
+        if (sock != PLATFORM_SO_ERROR_INVALID_SOCKET) {
+            break;
         }
-        platform_socket_enable_nonblocking(sock, nonblocking);
-
-        if (protocol == SOCK_STREAM) {
-            platform_socket_enable_maxseg(sock, true);
-            platform_socket_enable_nodelay(sock, true);
-            platform_socket_enable_keepalive(sock, true);
-        }
-        do {
-            ret = connect(sock, rp->ai_addr, rp->ai_addrlen);
-        } while (ret == PLATFORM_SO_ERROR_SOCKET_ERROR && errno == EINTR);
-        if (ret == PLATFORM_SO_ERROR_SOCKET_ERROR) {
-            if (errno != EINPROGRESS) {
-                platform_socket_close(sock);
-                continue;
-            }
-            if (errno == EINPROGRESS) {
-                break;
-            }
-        } else {
-            *connected = true;
-        }
-        break;
-    }
-    if (rp == NULL) {
-        freeaddrinfo(res);
-        return PLATFORM_SO_ERROR_INVALID_SOCKET;
     }
     freeaddrinfo(res);
     return sock;
@@ -273,37 +337,100 @@ ssize_t platform_socket_send(platform_sock_t sock, void* buf, int size) {
     return n;
 }
 
-ssize_t platform_socket_recvall(platform_sock_t sock, void* buf, int size) {
-    ssize_t off = 0;
+ssize_t platform_socket_recvall(platform_sock_t sock, void* buf, size_t size) {
+    size_t off = 0;
     while (off < size) {
+        size_t  chunk = (size - off > INT_MAX) ? INT_MAX : size - off;
         ssize_t tmp;
         do {
-            tmp = recv(sock, buf + off, size - (int)off, 0);
+            tmp = recv(sock, (char*)buf + off, chunk, 0);
         } while (tmp == PLATFORM_SO_ERROR_SOCKET_ERROR && errno == EINTR);
         if (tmp == PLATFORM_SO_ERROR_SOCKET_ERROR) {
             return PLATFORM_SO_ERROR_SOCKET_ERROR;
         }
         if (tmp == 0) {
-            return off;
+            return (ssize_t)off;
         }
         off += tmp;
     }
-    return off;
+    return (ssize_t)off;
 }
 
-ssize_t platform_socket_sendall(platform_sock_t sock, void* buf, int size) {
-    ssize_t off = 0;
+ssize_t platform_socket_sendall(platform_sock_t sock, void* buf, size_t size) {
+    size_t off = 0;
     while (off < size) {
+        size_t  chunk = (size - off > INT_MAX) ? INT_MAX : size - off;
         ssize_t tmp;
         do {
-            tmp = send(sock, buf + off, size - (int)off, 0);
+            tmp = send(sock, (char*)buf + off, chunk, 0);
         } while (tmp == PLATFORM_SO_ERROR_SOCKET_ERROR && errno == EINTR);
         if (tmp == PLATFORM_SO_ERROR_SOCKET_ERROR) {
             return PLATFORM_SO_ERROR_SOCKET_ERROR;
         }
         off += tmp;
     }
-    return off;
+    return (ssize_t)off;
+}
+
+/** one recvmsg, entries past PLATFORM_SO_IOV_MAX are left for the next call. */
+ssize_t platform_socket_recvv(
+    platform_sock_t sock, const platform_iovec_t* iov, int iovcnt) {
+    struct iovec  vec[PLATFORM_SO_IOV_MAX];
+    struct msghdr msg = {0};
+    ssize_t       n;
+
+    if (iovcnt > PLATFORM_SO_IOV_MAX) {
+        iovcnt = PLATFORM_SO_IOV_MAX;
+    }
+    for (int i = 0; i < iovcnt; i++) {
+        vec[i].iov_base = iov[i].base;
+        vec[i].iov_len  = iov[i].len;
+    }
+    msg.msg_iov    = vec;
+    msg.msg_iovlen = iovcnt;
+    do {
+        n = recvmsg(sock, &msg, 0);
+    } while (n == PLATFORM_SO_ERROR_SOCKET_ERROR && errno == EINTR);
+    if (n == PLATFORM_SO_ERROR_SOCKET_ERROR) {
+        return PLATFORM_SO_ERROR_SOCKET_ERROR;
+    }
+    return n;
+}
+
+/** one sendmsg, entries past PLATFORM_SO_IOV_MAX are left for the next call. */
+ssize_t platform_socket_sendv(
+    platform_sock_t sock, const platform_iovec_t* iov, int iovcnt) {
+    struct iovec  vec[PLATFORM_SO_IOV_MAX];
+    struct msghdr msg = {0};
+    ssize_t       n;
+
+    if (iovcnt > PLATFORM_SO_IOV_MAX) {
+        iovcnt = PLATFORM_SO_IOV_MAX;
+    }
+    for (int i = 0; i < iovcnt; i++) {
+        vec[i].iov_base = iov[i].base;
+        vec[i].iov_len  = iov[i].len;
+    }
+    msg.msg_iov    = vec;
+    msg.msg_iovlen = iovcnt;
+    do {
+        n = sendmsg(sock, &msg, 0);
+    } while (n == PLATFORM_SO_ERROR_SOCKET_ERROR && errno == EINTR);
+    if (n == PLATFORM_SO_ERROR_SOCKET_ERROR) {
+        return PLATFORM_SO_ERROR_SOCKET_ERROR;
+    }
+    return n;
+}
+
+ssize_t platform_socket_peek(platform_sock_t sock, void* buf, int size) {
+    ssize_t n;
+    do {
+        n = recv(sock, buf, size, MSG_PEEK);
+    } while (n == PLATFORM_SO_ERROR_SOCKET_ERROR && errno == EINTR);
+    if (n == PLATFORM_SO_ERROR_SOCKET_ERROR) {
+        return PLATFORM_SO_ERROR_SOCKET_ERROR;
+    }
+    return n;
 }
 
 ssize_t platform_socket_recvfrom(
@@ -351,7 +478,201 @@ int platform_socket_get_lasterror(void) {
     return errno;
 }
 
+int platform_socket_get_soerror(platform_sock_t sock) {
+    int       err = 0;
+    socklen_t len = sizeof(int);
+
+    if (getsockopt(sock, SOL_SOCKET, SO_ERROR, &err, &len)) {
+        return errno;
+    }
+    return err;
+}
+
+/** open, with nothing from the peer waiting to be read. */
+bool platform_socket_is_idle(platform_sock_t sock) {
+    char    c;
+    ssize_t n;
+
+    do {
+        n = recv(sock, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    } while (n == PLATFORM_SO_ERROR_SOCKET_ERROR && errno == EINTR);
+
+    return n == PLATFORM_SO_ERROR_SOCKET_ERROR &&
+           (errno == EAGAIN || errno == EWOULDBLOCK);
+}
+
+int platform_socket_unix_address(
+    const char* restrict     path,
+    struct sockaddr_storage* ss,
+    socklen_t*               sslen) {
+    struct sockaddr_un* sun = (struct sockaddr_un*)ss;
+    size_t              len = strlen(path);
+
+    if (len == 0 || len >= sizeof(sun->sun_path)) {
+        return -1;
+    }
+    memset(ss, 0, sizeof(struct sockaddr_storage));
+    sun->sun_family = AF_UNIX;
+    memcpy(sun->sun_path, path, len);
+#if defined(__linux__)
+    /** "@name" lives in the abstract namespace, no file is created. */
+    if (path[0] == '@') {
+        sun->sun_path[0] = '\0';
+        *sslen = (socklen_t)(offsetof(struct sockaddr_un, sun_path) + len);
+        return 0;
+    }
+#endif
+    *sslen = (socklen_t)sizeof(struct sockaddr_un);
+    return 0;
+}
+
+/** a socket file nobody listens on any more refuses connections. */
+static bool _socket_unix_stale(struct sockaddr_storage* ss, socklen_t sslen) {
+    platform_sock_t probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    int             rc;
+
+    if (probe == PLATFORM_SO_ERROR_INVALID_SOCKET) {
+        return false;
+    }
+    do {
+        rc = connect(probe, (struct sockaddr*)ss, sslen);
+    } while (rc == PLATFORM_SO_ERROR_SOCKET_ERROR && errno == EINTR);
+    bool stale = rc == PLATFORM_SO_ERROR_SOCKET_ERROR && errno == ECONNREFUSED;
+
+    platform_socket_close(probe);
+    return stale;
+}
+
+platform_sock_t
+platform_socket_listen_unix(const char* restrict path, bool nonblocking) {
+    struct sockaddr_storage ss;
+    socklen_t               sslen;
+    struct stat             st;
+
+    if (platform_socket_unix_address(path, &ss, &sslen)) {
+        return PLATFORM_SO_ERROR_INVALID_SOCKET;
+    }
+    platform_sock_t sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock == PLATFORM_SO_ERROR_INVALID_SOCKET) {
+        return PLATFORM_SO_ERROR_INVALID_SOCKET;
+    }
+    /**
+     * a socket file left behind by a previous run, never a regular file and
+     * never one a live server still listens on.
+     */
+    if (path[0] != '@' && !lstat(path, &st) && S_ISSOCK(st.st_mode) &&
+        _socket_unix_stale(&ss, sslen)) {
+        unlink(path);
+    }
+    if (bind(sock, (struct sockaddr*)&ss, sslen) ==
+        PLATFORM_SO_ERROR_SOCKET_ERROR) {
+        platform_socket_close(sock);
+        return PLATFORM_SO_ERROR_INVALID_SOCKET;
+    }
+    if (listen(sock, SOMAXCONN) == PLATFORM_SO_ERROR_SOCKET_ERROR) {
+        platform_socket_close(sock);
+        return PLATFORM_SO_ERROR_INVALID_SOCKET;
+    }
+    platform_socket_enable_nonblocking(sock, nonblocking);
+    return sock;
+}
+
+ssize_t
+platform_socket_send_fd(platform_sock_t sock, int fd, void* buf, int size) {
+    ssize_t       n;
+    struct msghdr msg;
+    struct iovec  iov;
+    union {
+        struct cmsghdr hdr;
+        char           buf[CMSG_SPACE(sizeof(int))];
+    } ctl;
+
+    memset(&msg, 0, sizeof(msg));
+    memset(&ctl, 0, sizeof(ctl));
+    iov.iov_base = buf;
+    iov.iov_len = size;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctl.buf;
+    msg.msg_controllen = sizeof(ctl.buf);
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+    do {
+        n = sendmsg(sock, &msg, 0);
+    } while (n == PLATFORM_SO_ERROR_SOCKET_ERROR && errno == EINTR);
+    return n;
+}
+
+ssize_t
+platform_socket_recv_fd(platform_sock_t sock, int* fd, void* buf, int size) {
+    ssize_t       n;
+    int           flags = 0;
+    struct msghdr msg;
+    struct iovec  iov;
+    union {
+        struct cmsghdr hdr;
+        char           buf[CMSG_SPACE(sizeof(int) * 4)];
+    } ctl;
+
+    memset(&msg, 0, sizeof(msg));
+    iov.iov_base = buf;
+    iov.iov_len = size;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctl.buf;
+    msg.msg_controllen = sizeof(ctl.buf);
+    *fd = -1;
+#if defined(MSG_CMSG_CLOEXEC)
+    flags |= MSG_CMSG_CLOEXEC;
+#endif
+    do {
+        n = recvmsg(sock, &msg, flags);
+    } while (n == PLATFORM_SO_ERROR_SOCKET_ERROR && errno == EINTR);
+    if (n == PLATFORM_SO_ERROR_SOCKET_ERROR) {
+        return PLATFORM_SO_ERROR_SOCKET_ERROR;
+    }
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+            continue;
+        }
+        int  cnt = (int)((cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+        int* fds = (int*)CMSG_DATA(cmsg);
+        for (int i = 0; i < cnt; i++) {
+            int passed;
+            memcpy(&passed, &fds[i], sizeof(int));
+            /** keep the first, anything extra would otherwise leak. */
+            if (*fd == -1) {
+                *fd = passed;
+            } else {
+                close(passed);
+            }
+        }
+    }
+    return n;
+}
+
 #if defined(__linux__)
+platform_sock_t platform_socket_accept(platform_sock_t sock, bool nonblocking) {
+    platform_sock_t cli;
+    int             flags = SOCK_CLOEXEC | (nonblocking ? SOCK_NONBLOCK : 0);
+    /**
+     * accept4 sets the flags atomically, saving the two fcntl calls.
+     */
+    do {
+        cli = accept4(sock, NULL, NULL, flags);
+    } while (cli == PLATFORM_SO_ERROR_INVALID_SOCKET && errno == EINTR);
+    if (cli == PLATFORM_SO_ERROR_INVALID_SOCKET) {
+        return PLATFORM_SO_ERROR_INVALID_SOCKET;
+    }
+    return cli;
+}
+
 void platform_socket_set_rss(platform_sock_t sock, uint16_t idx, int cores) {
     (void)(idx);
     struct sock_filter bpf_code[] = {
@@ -379,33 +700,405 @@ int platform_socket_get_addressfamily(platform_sock_t sock) {
     return af;
 }
 
-void platform_socket_enable_keepalive(platform_sock_t sock, bool on) {
+void platform_socket_set_keepalive(
+    platform_sock_t sock, bool on, int idle, int intvl, int cnt) {
+    int val = on ? 1 : 0;
+
+    setsockopt(sock, SOL_SOCKET, SO_KEEPALIVE, (const void*)&val, sizeof(val));
     if (!on) {
         return;
     }
+    setsockopt(sock, IPPROTO_TCP, TCP_KEEPIDLE, (const void*)&idle, sizeof(idle));
+    setsockopt(sock, IPPROTO_TCP, TCP_KEEPINTVL, (const void*)&intvl, sizeof(intvl));
+    setsockopt(sock, IPPROTO_TCP, TCP_KEEPCNT, (const void*)&cnt, sizeof(cnt));
+}
+
+void platform_socket_set_maxseg(platform_sock_t sock, int mss) {
+    setsockopt(sock, IPPROTO_TCP, TCP_MAXSEG, (const void*)&mss, sizeof(int));
+}
+
+void platform_socket_enable_cork(platform_sock_t sock, bool on) {
     int val = on ? 1 : 0;
-    int d = 60;
-    int i = 1;  /** 1 second; same as default on win32 */
-    int c = 10; /** 10 retries; same as hardcoded on win32 since vista */
+    setsockopt(sock, IPPROTO_TCP, TCP_CORK, (const void*)&val, sizeof(val));
+}
 
-    setsockopt(sock, SOL_SOCKET, SO_KEEPALIVE, (const void*)&val, sizeof(val));
-    setsockopt(sock, IPPROTO_TCP, TCP_KEEPIDLE, (const void*)&d, sizeof(d));
-    setsockopt(sock, IPPROTO_TCP, TCP_KEEPINTVL, (const void*)&i, sizeof(i));
-    setsockopt(sock, IPPROTO_TCP, TCP_KEEPCNT, (const void*)&c, sizeof(c));
+/**
+ * the kernel drops back to delayed acks on its own, so this has to be
+ * re-armed after reads to stay in effect.
+ */
+void platform_socket_enable_quickack(platform_sock_t sock, bool on) {
+    int val = on ? 1 : 0;
+    setsockopt(sock, IPPROTO_TCP, TCP_QUICKACK, (const void*)&val, sizeof(val));
 }
 
-void platform_socket_enable_maxseg(platform_sock_t sock, bool on) {
-    if (!on) {
-        return;
+void platform_socket_set_busypoll(platform_sock_t sock, int usec) {
+#if defined(SO_BUSY_POLL)
+    setsockopt(sock, SOL_SOCKET, SO_BUSY_POLL, (const void*)&usec, sizeof(usec));
+#else
+    (void)sock;
+    (void)usec;
+#endif
+}
+
+void platform_socket_set_notsent_lowat(platform_sock_t sock, int bytes) {
+    setsockopt(
+        sock, IPPROTO_TCP, TCP_NOTSENT_LOWAT, (const void*)&bytes, sizeof(bytes));
+}
+
+/**
+ * glibc's tcp_info stops at tcpi_total_retrans, the kernel appends more
+ * fields behind it, delivery_rate is read at its fixed offset.
+ */
+#define PLATFORM_TCP_INFO_DELIVERY_RATE 160
+
+int platform_socket_get_tcpinfo(platform_sock_t sock, platform_tcp_info_t* info) {
+    uint8_t         raw[256];
+    struct tcp_info ti;
+    socklen_t       len = sizeof(raw);
+
+    memset(raw, 0, sizeof(raw));
+    if (getsockopt(sock, IPPROTO_TCP, TCP_INFO, raw, &len)) {
+        return -1;
     }
-    int af = platform_socket_get_addressfamily(sock);
-    int mss = af == AF_INET ? TCPv4_MSS : TCPv6_MSS;
+    memcpy(&ti, raw, sizeof(ti));
 
-    setsockopt(sock, IPPROTO_TCP, TCP_MAXSEG, (const void*)&mss, sizeof(int));
+    info->rtt_us        = ti.tcpi_rtt;
+    info->rttvar_us     = ti.tcpi_rttvar;
+    info->retransmits   = ti.tcpi_total_retrans;
+    info->cwnd          = ti.tcpi_snd_cwnd;
+    info->delivery_rate = 0;
+    if (len >= PLATFORM_TCP_INFO_DELIVERY_RATE + sizeof(uint64_t)) {
+        memcpy(
+            &info->delivery_rate,
+            raw + PLATFORM_TCP_INFO_DELIVERY_RATE,
+            sizeof(uint64_t));
+    }
+    return 0;
+}
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+bool platform_socket_enable_zerocopy(platform_sock_t sock, bool on) {
+    int val = on ? 1 : 0;
+    return setsockopt(
+               sock,
+               SOL_SOCKET,
+               SO_ZEROCOPY,
+               (const void*)&val,
+               sizeof(val)) == 0;
+}
+
+ssize_t platform_socket_send_zerocopy(platform_sock_t sock, void* buf, int size) {
+    ssize_t n;
+    do {
+        n = send(sock, buf, size, MSG_ZEROCOPY);
+    } while (n == PLATFORM_SO_ERROR_SOCKET_ERROR && errno == EINTR);
+    if (n == PLATFORM_SO_ERROR_SOCKET_ERROR) {
+        return PLATFORM_SO_ERROR_SOCKET_ERROR;
+    }
+    return n;
+}
+
+/**
+ * reads one completion from the error queue, returns 1 when [lo, hi] was
+ * released by the kernel, 0 when the queue is empty and -1 on error.
+ */
+int platform_socket_recv_zerocopy(
+    platform_sock_t sock, uint32_t* lo, uint32_t* hi, bool* copied) {
+    char            control[128];
+    struct msghdr   msg;
+    struct cmsghdr* cm;
+    ssize_t         n;
+
+    for (;;) {
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        do {
+            n = recvmsg(sock, &msg, MSG_ERRQUEUE);
+        } while (n == PLATFORM_SO_ERROR_SOCKET_ERROR && errno == EINTR);
+        if (n == PLATFORM_SO_ERROR_SOCKET_ERROR) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return 0;
+            }
+            return -1;
+        }
+        for (cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+            if (!((cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) ||
+                  (cm->cmsg_level == SOL_IPV6 &&
+                   cm->cmsg_type == IPV6_RECVERR))) {
+                continue;
+            }
+            struct sock_extended_err* ee =
+                (struct sock_extended_err*)CMSG_DATA(cm);
+            if (ee->ee_errno != 0 || ee->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                continue;
+            }
+            *lo = ee->ee_info;
+            *hi = ee->ee_data;
+            *copied = ee->ee_code & SO_EE_CODE_ZEROCOPY_COPIED;
+            return 1;
+        }
+    }
+}
+#else
+bool platform_socket_enable_zerocopy(platform_sock_t sock, bool on) {
+    (void)(sock);
+    (void)(on);
+    return false;
+}
+
+ssize_t platform_socket_send_zerocopy(platform_sock_t sock, void* buf, int size) {
+    return platform_socket_send(sock, buf, size);
+}
+
+int platform_socket_recv_zerocopy(
+    platform_sock_t sock, uint32_t* lo, uint32_t* hi, bool* copied) {
+    (void)(sock);
+    (void)(lo);
+    (void)(hi);
+    (void)(copied);
+    return 0;
+}
+#endif
+
+/** page cache to socket without a userspace copy, returns 0 at end of file. */
+ssize_t platform_socket_sendfile(
+    platform_sock_t sock, int fd, int64_t offset, size_t size) {
+    off_t   off = (off_t)offset;
+    ssize_t n;
+
+    /** sendfile moves at most 0x7ffff000 bytes per call anyway. */
+    if (size > INT_MAX) {
+        size = INT_MAX;
+    }
+    do {
+        n = sendfile(sock, fd, &off, size);
+    } while (n == PLATFORM_SO_ERROR_SOCKET_ERROR && errno == EINTR);
+    if (n == PLATFORM_SO_ERROR_SOCKET_ERROR) {
+        return PLATFORM_SO_ERROR_SOCKET_ERROR;
+    }
+    return n;
+}
+
+int platform_socket_pipe(int fds[2]) {
+    return pipe2(fds, O_NONBLOCK | O_CLOEXEC);
+}
+
+void platform_socket_pipe_close(int fds[2]) {
+    close(fds[0]);
+    close(fds[1]);
+}
+
+/** socket to pipe and back through pipe buffers, never touching userspace. */
+ssize_t platform_socket_splice_in(platform_sock_t sock, int pipefd, size_t size) {
+    ssize_t n;
+    do {
+        n = splice(
+            sock, NULL, pipefd, NULL, size, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    } while (n == PLATFORM_SO_ERROR_SOCKET_ERROR && errno == EINTR);
+    return n;
+}
+
+ssize_t platform_socket_splice_out(int pipefd, platform_sock_t sock, size_t size) {
+    ssize_t n;
+    do {
+        n = splice(
+            pipefd, NULL, sock, NULL, size, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    } while (n == PLATFORM_SO_ERROR_SOCKET_ERROR && errno == EINTR);
+    return n;
+}
+
+ssize_t platform_socket_pipe_write(int pipefd, const void* buf, size_t size) {
+    ssize_t n;
+    do {
+        n = write(pipefd, buf, size);
+    } while (n == PLATFORM_SO_ERROR_SOCKET_ERROR && errno == EINTR);
+    return n;
+}
+#endif
+
+#if defined(__linux__) && defined(TLS_TX) && defined(TCP_ULP)
+/**
+ * hands tls 1.3 record encryption of everything sent afterwards to the
+ * kernel. iv is the full 12 byte nonce, seq the next record sequence.
+ */
+bool platform_socket_enable_ktls(
+    platform_sock_t        sock,
+    platform_ktls_cipher_t cipher,
+    const uint8_t*         key,
+    const uint8_t*         iv,
+    uint64_t               seq) {
+    union {
+        struct tls12_crypto_info_aes_gcm_128 gcm128;
+        struct tls12_crypto_info_aes_gcm_256 gcm256;
+#if defined(TLS_CIPHER_CHACHA20_POLY1305)
+        struct tls12_crypto_info_chacha20_poly1305 chacha;
+#endif
+    } info;
+    uint8_t   recseq[8];
+    socklen_t len;
+
+    for (int i = 0; i < 8; i++) {
+        recseq[i] = (uint8_t)(seq >> (56 - 8 * i));
+    }
+    memset(&info, 0, sizeof(info));
+
+    switch (cipher) {
+    case PLATFORM_KTLS_CIPHER_AES_GCM_128:
+        info.gcm128.info.version     = TLS_1_3_VERSION;
+        info.gcm128.info.cipher_type = TLS_CIPHER_AES_GCM_128;
+        memcpy(info.gcm128.salt, iv, 4);
+        memcpy(info.gcm128.iv, iv + 4, 8);
+        memcpy(info.gcm128.key, key, 16);
+        memcpy(info.gcm128.rec_seq, recseq, 8);
+        len = sizeof(info.gcm128);
+        break;
+    case PLATFORM_KTLS_CIPHER_AES_GCM_256:
+        info.gcm256.info.version     = TLS_1_3_VERSION;
+        info.gcm256.info.cipher_type = TLS_CIPHER_AES_GCM_256;
+        memcpy(info.gcm256.salt, iv, 4);
+        memcpy(info.gcm256.iv, iv + 4, 8);
+        memcpy(info.gcm256.key, key, 32);
+        memcpy(info.gcm256.rec_seq, recseq, 8);
+        len = sizeof(info.gcm256);
+        break;
+#if defined(TLS_CIPHER_CHACHA20_POLY1305)
+    case PLATFORM_KTLS_CIPHER_CHACHA20_POLY1305:
+        info.chacha.info.version     = TLS_1_3_VERSION;
+        info.chacha.info.cipher_type = TLS_CIPHER_CHACHA20_POLY1305;
+        memcpy(info.chacha.iv, iv, 12);
+        memcpy(info.chacha.key, key, 32);
+        memcpy(info.chacha.rec_seq, recseq, 8);
+        len = sizeof(info.chacha);
+        break;
+#endif
+    default:
+        return false;
+    }
+    /** the ulp without keys passes data through, so a failed TLS_TX is harmless. */
+    if (setsockopt(sock, IPPROTO_TCP, TCP_ULP, "tls", sizeof("tls")) &&
+        errno != EEXIST) {
+        return false;
+    }
+    bool ok = setsockopt(sock, SOL_TLS, TLS_TX, &info, len) == 0;
+
+    memset(&info, 0, sizeof(info));
+    return ok;
+}
+
+/**
+ * whether the kernel takes TLS_TX again on a socket, which answering a tls
+ * 1.3 key update needs. probed once on a loopback connection that never
+ * sends, so setting the same keys twice is harmless.
+ */
+bool platform_socket_ktls_rekey(void) {
+    static atomic_int probed = 0;
+
+    int state = atomic_load(&probed);
+    if (state) {
+        return state > 0;
+    }
+    uint8_t            key[16] = {0};
+    uint8_t            iv[12]  = {0};
+    struct sockaddr_in addr;
+    socklen_t          len = sizeof(addr);
+    bool               ok  = false;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int lsock = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int sock  = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (lsock >= 0 && sock >= 0 &&
+        !bind(lsock, (struct sockaddr*)&addr, sizeof(addr)) && !listen(lsock, 1) &&
+        !getsockname(lsock, (struct sockaddr*)&addr, &len) &&
+        !connect(sock, (struct sockaddr*)&addr, sizeof(addr))) {
+        ok = platform_socket_enable_ktls(
+                 sock, PLATFORM_KTLS_CIPHER_AES_GCM_128, key, iv, 0) &&
+             platform_socket_enable_ktls(
+                 sock, PLATFORM_KTLS_CIPHER_AES_GCM_128, key, iv, 0);
+    }
+    if (sock >= 0) {
+        close(sock);
+    }
+    if (lsock >= 0) {
+        close(lsock);
+    }
+    atomic_store(&probed, ok ? 1 : -1);
+    return ok;
+}
+
+/** sends a record of the given content type through an enabled kernel tls. */
+ssize_t platform_socket_send_record(
+    platform_sock_t sock, uint8_t type, void* buf, int size) {
+    char            control[CMSG_SPACE(sizeof(type))];
+    struct msghdr   msg;
+    struct iovec    iov = {.iov_base = buf, .iov_len = (size_t)size};
+    struct cmsghdr* cm;
+    ssize_t         n;
+
+    memset(&msg, 0, sizeof(msg));
+    memset(control, 0, sizeof(control));
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof(control);
+
+    cm             = CMSG_FIRSTHDR(&msg);
+    cm->cmsg_level = SOL_TLS;
+    cm->cmsg_type  = TLS_SET_RECORD_TYPE;
+    cm->cmsg_len   = CMSG_LEN(sizeof(type));
+    memcpy(CMSG_DATA(cm), &type, sizeof(type));
+
+    do {
+        n = sendmsg(sock, &msg, 0);
+    } while (n == PLATFORM_SO_ERROR_SOCKET_ERROR && errno == EINTR);
+    return n;
+}
+#else
+bool platform_socket_enable_ktls(
+    platform_sock_t        sock,
+    platform_ktls_cipher_t cipher,
+    const uint8_t*         key,
+    const uint8_t*         iv,
+    uint64_t               seq) {
+    (void)(sock);
+    (void)(cipher);
+    (void)(key);
+    (void)(iv);
+    (void)(seq);
+    return false;
+}
+
+bool platform_socket_ktls_rekey(void) {
+    return false;
+}
+
+ssize_t platform_socket_send_record(
+    platform_sock_t sock, uint8_t type, void* buf, int size) {
+    (void)(sock);
+    (void)(type);
+    (void)(buf);
+    (void)(size);
+    errno = EOPNOTSUPP;
+    return PLATFORM_SO_ERROR_SOCKET_ERROR;
 }
 #endif
 
 #if defined(__APPLE__)
+platform_sock_t platform_socket_accept(platform_sock_t sock, bool nonblocking) {
+    platform_sock_t cli;
+    do {
+        cli = accept(sock, NULL, NULL);
+    } while (cli == PLATFORM_SO_ERROR_INVALID_SOCKET && errno == EINTR);
+    if (cli == PLATFORM_SO_ERROR_INVALID_SOCKET) {
+        return PLATFORM_SO_ERROR_INVALID_SOCKET;
+    }
+    fcntl(cli, F_SETFD, FD_CLOEXEC);
+    platform_socket_enable_nonblocking(cli, nonblocking);
+    return cli;
+}
+
 void platform_socket_set_rss(platform_sock_t sock, uint16_t idx, int cores) {
     (void)(sock);
     (void)(idx);
@@ -421,32 +1114,172 @@ int platform_socket_get_addressfamily(platform_sock_t sock) {
     return ss.ss_family;
 }
 
-void platform_socket_enable_keepalive(platform_sock_t sock, bool on) {
+void platform_socket_set_keepalive(
+    platform_sock_t sock, bool on, int idle, int intvl, int cnt) {
+    int val = on ? 1 : 0;
+
+    setsockopt(sock, SOL_SOCKET, SO_KEEPALIVE, (const void*)&val, sizeof(val));
     if (!on) {
         return;
     }
+    setsockopt(sock, IPPROTO_TCP, TCP_KEEPALIVE, (const void*)&idle, sizeof(idle));
+    setsockopt(sock, IPPROTO_TCP, TCP_KEEPINTVL, (const void*)&intvl, sizeof(intvl));
+    setsockopt(sock, IPPROTO_TCP, TCP_KEEPCNT, (const void*)&cnt, sizeof(cnt));
+}
+
+void platform_socket_set_maxseg(platform_sock_t sock, int mss) {
+    setsockopt(sock, IPPROTO_TCP, TCP_MAXSEG, (const void*)&mss, sizeof(int));
+}
+
+void platform_socket_enable_cork(platform_sock_t sock, bool on) {
     int val = on ? 1 : 0;
-    int d = 60;
-    int i = 1;  /* 1 second; same as default on win32 */
-    int c = 10; /* 10 retries; same as hardcoded on win32 since vista */
+    setsockopt(sock, IPPROTO_TCP, TCP_NOPUSH, (const void*)&val, sizeof(val));
+}
 
-    setsockopt(sock, SOL_SOCKET, SO_KEEPALIVE, (const void*)&val, sizeof(val));
-    setsockopt(sock, IPPROTO_TCP, TCP_KEEPALIVE, (const void*)&d, sizeof(d));
-    setsockopt(sock, IPPROTO_TCP, TCP_KEEPINTVL, (const void*)&i, sizeof(i));
-    setsockopt(sock, IPPROTO_TCP, TCP_KEEPCNT, (const void*)&c, sizeof(c));
+void platform_socket_enable_quickack(platform_sock_t sock, bool on) {
+    (void)(sock);
+    (void)(on);
 }
 
-void platform_socket_enable_maxseg(platform_sock_t sock, bool on) {
-    if (!on) {
-        return;
+void platform_socket_set_busypoll(platform_sock_t sock, int usec) {
+    (void)(sock);
+    (void)(usec);
+}
+
+void platform_socket_set_notsent_lowat(platform_sock_t sock, int bytes) {
+    setsockopt(
+        sock, IPPROTO_TCP, TCP_NOTSENT_LOWAT, (const void*)&bytes, sizeof(bytes));
+}
+
+/** the connection info reports milliseconds and no delivery rate. */
+int platform_socket_get_tcpinfo(platform_sock_t sock, platform_tcp_info_t* info) {
+    struct tcp_connection_info ti;
+    socklen_t                  len = sizeof(ti);
+
+    if (getsockopt(sock, IPPROTO_TCP, TCP_CONNECTION_INFO, &ti, &len)) {
+        return -1;
     }
-    /**
-     * on macos, TCP_NOOPT seems to be the only way to restrict MSS to the
-     * minimum. it strips all options out of the SYN packet which forces the
-     * remote party to fall back to the minimum MSS. TCP_MAXSEG doesn't seem to
-     * work correctly for outbound connections on macOS/iOS.
-     */
-    int val = 1;
-    setsockopt(sock, IPPROTO_TCP, TCP_NOOPT, (const void*)&val, sizeof(int));
+    info->rtt_us        = ti.tcpi_srtt * 1000;
+    info->rttvar_us     = ti.tcpi_rttvar * 1000;
+    info->retransmits   = (uint32_t)ti.tcpi_txretransmitpackets;
+    info->cwnd          = ti.tcpi_maxseg ? ti.tcpi_snd_cwnd / ti.tcpi_maxseg : 0;
+    info->delivery_rate = 0;
+    return 0;
 }
-#endif
\ No newline at end of file
+
+bool platform_socket_enable_zerocopy(platform_sock_t sock, bool on) {
+    (void)(sock);
+    (void)(on);
+    return false;
+}
+
+ssize_t platform_socket_send_zerocopy(platform_sock_t sock, void* buf, int size) {
+    return platform_socket_send(sock, buf, size);
+}
+
+int platform_socket_recv_zerocopy(
+    platform_sock_t sock, uint32_t* lo, uint32_t* hi, bool* copied) {
+    (void)(sock);
+    (void)(lo);
+    (void)(hi);
+    (void)(copied);
+    return 0;
+}
+
+int platform_socket_pipe(int fds[2]) {
+    (void)(fds);
+    errno = ENOSYS;
+    return -1;
+}
+
+void platform_socket_pipe_close(int fds[2]) {
+    (void)(fds);
+}
+
+ssize_t platform_socket_splice_in(platform_sock_t sock, int pipefd, size_t size) {
+    (void)(sock);
+    (void)(pipefd);
+    (void)(size);
+    errno = ENOSYS;
+    return PLATFORM_SO_ERROR_SOCKET_ERROR;
+}
+
+ssize_t platform_socket_splice_out(int pipefd, platform_sock_t sock, size_t size) {
+    (void)(pipefd);
+    (void)(sock);
+    (void)(size);
+    errno = ENOSYS;
+    return PLATFORM_SO_ERROR_SOCKET_ERROR;
+}
+
+ssize_t platform_socket_pipe_write(int pipefd, const void* buf, size_t size) {
+    (void)(pipefd);
+    (void)(buf);
+    (void)(size);
+    errno = ENOSYS;
+    return PLATFORM_SO_ERROR_SOCKET_ERROR;
+}
+#endif
+
+#if defined(__APPLE__)
+/** a partial transfer fails with EAGAIN but still reports what went out. */
+ssize_t platform_socket_sendfile(
+    platform_sock_t sock, int fd, int64_t offset, size_t size) {
+    off_t len;
+    int   rc;
+
+    /** a zero length would mean up to the end of file. */
+    if (size == 0) {
+        return 0;
+    }
+    do {
+        len = (off_t)((size > INT_MAX) ? INT_MAX : size);
+        rc  = sendfile(fd, sock, (off_t)offset, &len, NULL, 0);
+    } while (rc == -1 && errno == EINTR && len == 0);
+    if (rc == -1 && len == 0) {
+        return PLATFORM_SO_ERROR_SOCKET_ERROR;
+    }
+    return (ssize_t)len;
+}
+#elif defined(__FreeBSD__)
+/** same contract as darwin, the byte count comes back through sbytes. */
+ssize_t platform_socket_sendfile(
+    platform_sock_t sock, int fd, int64_t offset, size_t size) {
+    off_t sbytes;
+    int   rc;
+
+    /** a zero length would mean up to the end of file. */
+    if (size == 0) {
+        return 0;
+    }
+    if (size > INT_MAX) {
+        size = INT_MAX;
+    }
+    do {
+        sbytes = 0;
+        rc     = sendfile(fd, sock, (off_t)offset, size, NULL, &sbytes, 0);
+    } while (rc == -1 && errno == EINTR && sbytes == 0);
+    if (rc == -1 && sbytes == 0) {
+        return PLATFORM_SO_ERROR_SOCKET_ERROR;
+    }
+    return (ssize_t)sbytes;
+}
+#elif !defined(__linux__)
+/** no sendfile, one bounded chunk goes through a userspace copy. */
+ssize_t platform_socket_sendfile(
+    platform_sock_t sock, int fd, int64_t offset, size_t size) {
+    char    buf[65536];
+    ssize_t n;
+
+    if (size > sizeof(buf)) {
+        size = sizeof(buf);
+    }
+    do {
+        n = pread(fd, buf, size, (off_t)offset);
+    } while (n == -1 && errno == EINTR);
+    if (n <= 0) {
+        return n;
+    }
+    return platform_socket_send(sock, buf, (int)n);
+}
+#endif
@@ -21,13 +21,198 @@
 
 #include "platform/platform-uart.h"
 
+/**
+ * glibc has no termios2, this is the asm-generic kernel layout behind
+ * TCGETS2. mips, powerpc, sparc and alpha lay it out differently, custom
+ * rates are only taken where it is known to match.
+ */
+#if defined(__linux__) && \
+    (defined(__x86_64__) || defined(__i386__) || defined(__aarch64__) || \
+     defined(__arm__) || defined(__riscv) || defined(__loongarch__))
+#define PLATFORM_UART_TERMIOS2
+
+struct termios2 {
+    tcflag_t c_iflag;
+    tcflag_t c_oflag;
+    tcflag_t c_cflag;
+    tcflag_t c_lflag;
+    cc_t     c_line;
+    cc_t     c_cc[19];
+    speed_t  c_ispeed;
+    speed_t  c_ospeed;
+};
+
+#define PLATFORM_UART_BOTHER  0010000
+#define PLATFORM_UART_IBSHIFT 16
+#endif
+
+static uint64_t _platform_uart_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+/** B0 tells the caller the rate has no constant and needs a custom speed. */
+static speed_t _platform_uart_speed(uint32_t baudrate) {
+    switch (baudrate) {
+    case 9600:
+        return B9600;
+    case 19200:
+        return B19200;
+    case 38400:
+        return B38400;
+    case 57600:
+        return B57600;
+    case 115200:
+        return B115200;
+    case 230400:
+        return B230400;
+#if defined(B460800)
+    case 460800:
+        return B460800;
+#endif
+#if defined(B921600)
+    case 921600:
+        return B921600;
+#endif
+#if defined(B1000000)
+    case 1000000:
+        return B1000000;
+#endif
+#if defined(B1500000)
+    case 1500000:
+        return B1500000;
+#endif
+#if defined(B2000000)
+    case 2000000:
+        return B2000000;
+#endif
+#if defined(B3000000)
+    case 3000000:
+        return B3000000;
+#endif
+    default:
+        return B0;
+    }
+}
+
+static int _platform_uart_set_custom_speed(platform_uart_t uart, uint32_t baudrate) {
+#if defined(PLATFORM_UART_TERMIOS2)
+    struct termios2 options;
+    if (ioctl(uart, TCGETS2, &options) != 0) {
+        return -1;
+    }
+    options.c_cflag &= ~(CBAUD | (CBAUD << PLATFORM_UART_IBSHIFT));
+    options.c_cflag |= PLATFORM_UART_BOTHER;
+    options.c_ispeed = baudrate;
+    options.c_ospeed = baudrate;
+    return ioctl(uart, TCSETS2, &options);
+#elif defined(__APPLE__)
+    speed_t speed = baudrate;
+    return ioctl(uart, IOSSIOSPEED, &speed);
+#else
+    errno = EINVAL;
+    return -1;
+#endif
+}
+
+static void _platform_uart_set_low_latency(platform_uart_t uart) {
+#if defined(__linux__)
+    struct serial_struct serial;
+    if (ioctl(uart, TIOCGSERIAL, &serial) == 0) {
+        serial.flags |= ASYNC_LOW_LATENCY;
+        ioctl(uart, TIOCSSERIAL, &serial);
+    }
+#else
+    (void)uart;
+#endif
+}
+
+/** ftdi adapters hold received bytes up to the latency timer, 16ms by default. */
+static void _platform_uart_set_latency_timer(const char* device, int latency_timer_ms) {
+#if defined(__linux__)
+    char real[PATH_MAX];
+    if (!realpath(device, real)) {
+        return;
+    }
+    const char* name = strrchr(real, '/');
+
+    char path[PATH_MAX + 64];
+    snprintf(
+        path,
+        sizeof(path),
+        "/sys/bus/usb-serial/devices/%s/latency_timer",
+        name ? name + 1 : real);
+
+    FILE* fp = fopen(path, "w");
+    if (fp) {
+        fprintf(fp, "%d", latency_timer_ms);
+        fclose(fp);
+    }
+#else
+    (void)device;
+    (void)latency_timer_ms;
+#endif
+}
+
+static int _platform_uart_set_rs485(platform_uart_t uart, platform_uart_config_t* config) {
+#if defined(__linux__)
+    struct serial_rs485 rs485;
+    memset(&rs485, 0, sizeof(struct serial_rs485));
+
+    rs485.flags = SER_RS485_ENABLED;
+    rs485.flags |= config->rs485.rts_on_send ? SER_RS485_RTS_ON_SEND
+                                             : SER_RS485_RTS_AFTER_SEND;
+    rs485.delay_rts_before_send = config->rs485.delay_before_send_ms;
+    rs485.delay_rts_after_send  = config->rs485.delay_after_send_ms;
+    return ioctl(uart, TIOCSRS485, &rs485);
+#else
+    (void)uart;
+    (void)config;
+    errno = ENOTSUP;
+    return -1;
+#endif
+}
+
 void platform_uart_close(platform_uart_t uart) {
     close(uart);
 }
 
-int platform_uart_read(platform_uart_t uart, uint8_t* buf, int len) {
-    ssize_t off = 0;
+/** either timeout running out ends the read with the bytes it has so far. */
+int platform_uart_read(
+    platform_uart_t uart,
+    uint8_t*        buf,
+    int             len,
+    size_t          timeout_ms,
+    size_t          interbyte_timeout_ms) {
+    uint64_t deadline = timeout_ms ? _platform_uart_now() + timeout_ms : 0;
+    ssize_t  off      = 0;
+
     while (off < len) {
+        int wait = -1;
+        if (deadline) {
+            uint64_t now = _platform_uart_now();
+            if (now >= deadline) {
+                break;
+            }
+            wait = (deadline - now > INT_MAX) ? INT_MAX : (int)(deadline - now);
+        }
+        if (off && interbyte_timeout_ms &&
+            (wait < 0 || interbyte_timeout_ms < (size_t)wait)) {
+            wait = (interbyte_timeout_ms > INT_MAX) ? INT_MAX : (int)interbyte_timeout_ms;
+        }
+        struct pollfd pfd = {.fd = uart, .events = POLLIN};
+
+        int n = poll(&pfd, 1, wait);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            return PLATFORM_UA_ERROR_UART_ERROR;
+        }
+        if (n == 0) {
+            break;
+        }
         ssize_t tmp;
         do {
             tmp = read(uart, buf + off, len - (int)off);
@@ -36,7 +221,7 @@ int platform_uart_read(platform_uart_t uart, uint8_t* buf, int len) {
             return PLATFORM_UA_ERROR_UART_ERROR;
         }
         if (tmp == 0) {
-            return off;
+            break;
         }
         off += tmp;
     }
@@ -58,8 +243,29 @@ int platform_uart_write(platform_uart_t uart, uint8_t* buf, int len) {
     return (int)off;
 }
 
-platform_uart_t platform_uart_open(platform_uart_config_t* config) {
-    platform_uart_t uart = open(config->device, O_RDWR | O_NOCTTY);
+int platform_uart_read_some(platform_uart_t uart, uint8_t* buf, int len) {
+    ssize_t ret;
+    do {
+        ret = read(uart, buf, len);
+    } while (ret == PLATFORM_UA_ERROR_UART_ERROR && errno == EINTR);
+    return (int)ret;
+}
+
+int platform_uart_write_some(platform_uart_t uart, uint8_t* buf, int len) {
+    ssize_t ret;
+    do {
+        ret = write(uart, buf, len);
+    } while (ret == PLATFORM_UA_ERROR_UART_ERROR && errno == EINTR);
+    return (int)ret;
+}
+
+int platform_uart_get_lasterror(void) {
+    return errno;
+}
+
+platform_uart_t platform_uart_open(platform_uart_config_t* config, bool nonblocking) {
+    platform_uart_t uart = open(
+        config->device, O_RDWR | O_NOCTTY | (nonblocking ? O_NONBLOCK : 0));
     if (uart == -1) {
         return PLATFORM_UA_ERROR_INVALID_UART;
     }
@@ -69,29 +275,14 @@ platform_uart_t platform_uart_open(platform_uart_config_t* config) {
         return PLATFORM_UA_ERROR_INVALID_UART;
     }
     memset(&options, 0, sizeof(struct termios));
-    speed_t baudrate_flag;
-    switch (config->baudrate) {
-    case PLATFORM_UART_BAUDRATE_9600:
-        baudrate_flag = B9600;
-        break;
-    case PLATFORM_UART_BAUDRATE_19200:
-        baudrate_flag = B19200;
-        break;
-    case PLATFORM_UART_BAUDRATE_38400:
-        baudrate_flag = B38400;
-        break;
-    case PLATFORM_UART_BAUDRATE_57600:
-        baudrate_flag = B57600;
-        break;
-    case PLATFORM_UART_BAUDRATE_115200:
-        baudrate_flag = B115200;
-        break;
-    default:
+    if (!config->baudrate) {
         platform_uart_close(uart);
         return PLATFORM_UA_ERROR_INVALID_UART;
     }
-    cfsetispeed(&options, baudrate_flag);
-    cfsetospeed(&options, baudrate_flag);
+    /** a custom rate starts from 38400 and is replaced once the rest is set. */
+    speed_t baudrate_flag = _platform_uart_speed(config->baudrate);
+    cfsetispeed(&options, baudrate_flag == B0 ? B38400 : baudrate_flag);
+    cfsetospeed(&options, baudrate_flag == B0 ? B38400 : baudrate_flag);
 
     options.c_cflag &= ~CSIZE;
     switch (config->databits) {
@@ -134,17 +325,30 @@ platform_uart_t platform_uart_open(platform_uart_config_t* config) {
     }
     options.c_cflag |= CLOCAL | CREAD;
 
-    if (config->timeout_ms) {
-        options.c_cc[VMIN] = 0;
-        options.c_cc[VTIME] = (config->timeout_ms / 1000UL) * 10;
-    } else {
-        options.c_cc[VMIN] = 1;
-        options.c_cc[VTIME] = 0;
-    }
+    /**
+     * timeouts are kept by poll in platform_uart_read, a read returns once a
+     * byte is in. VMIN 0 would also make a nonblocking read report 0.
+     */
+    options.c_cc[VMIN] = 1;
+    options.c_cc[VTIME] = 0;
+
     tcflush(uart, TCIOFLUSH);
     if (tcsetattr(uart, TCSANOW, &options) != 0) {
         platform_uart_close(uart);
         return PLATFORM_UA_ERROR_INVALID_UART;
     }
+    if ((baudrate_flag == B0 && _platform_uart_set_custom_speed(uart, config->baudrate) != 0) ||
+        (config->rs485.enabled && _platform_uart_set_rs485(uart, config) != 0)) {
+        int err = errno;
+        platform_uart_close(uart);
+        errno = err;
+        return PLATFORM_UA_ERROR_INVALID_UART;
+    }
+    if (config->low_latency) {
+        _platform_uart_set_low_latency(uart);
+    }
+    if (config->latency_timer_ms > 0) {
+        _platform_uart_set_latency_timer(config->device, config->latency_timer_ms);
+    }
     return uart;
 }
\ No newline at end of file
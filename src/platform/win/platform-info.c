@@ -27,6 +27,23 @@ int platform_info_getcpus(void) {
     return (int)si.dwNumberOfProcessors;
 }
 
+/** a thread mask only reaches the cpus of its processor group. */
+void platform_info_setaffinity(int cpu) {
+    DWORD_PTR process;
+    DWORD_PTR system;
+
+    if (cpu < 0) {
+        if (GetProcessAffinityMask(GetCurrentProcess(), &process, &system)) {
+            SetThreadAffinityMask(GetCurrentThread(), process);
+        }
+        return;
+    }
+    if (cpu >= (int)(sizeof(DWORD_PTR) * CHAR_BIT)) {
+        return;
+    }
+    SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu);
+}
+
 platform_tid_t platform_info_gettid(void) {
     return GetCurrentThreadId();
 }
@@ -39,4 +56,16 @@ void platform_info_getlocaltime(
     const time_t* restrict time, struct tm* restrict tm) {
     _tzset();
     localtime_s(tm, time);
+}
+
+uint64_t platform_info_getclock(void) {
+    LARGE_INTEGER freq;
+    LARGE_INTEGER count;
+
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+
+    uint64_t f = (uint64_t)freq.QuadPart;
+    uint64_t c = (uint64_t)count.QuadPart;
+    return c / f * 1000000000ULL + c % f * 1000000000ULL / f;
 }
\ No newline at end of file
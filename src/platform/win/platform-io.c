@@ -19,6 +19,7 @@
  *  IN THE SOFTWARE.
  */
 
+#include <io.h>
 #include <share.h>
 #include "platform/platform-io.h"
 
@@ -28,4 +29,20 @@ FILE* platform_io_fopen(const char* restrict file, const char* restrict mode) {
 
 int platform_io_vsprintf(char* str, size_t size, const char* restrict format, va_list ap) {
     return vsprintf_s(str, size, format, ap);
-}
\ No newline at end of file
+}
+
+ssize_t platform_io_pread(int fd, void* buf, size_t size, int64_t offset) {
+    HANDLE     handle = (HANDLE)_get_osfhandle(fd);
+    OVERLAPPED ov     = {0};
+    DWORD      n      = 0;
+
+    if (handle == INVALID_HANDLE_VALUE) {
+        return -1;
+    }
+    ov.Offset     = (DWORD)(offset & 0xffffffff);
+    ov.OffsetHigh = (DWORD)(offset >> 32);
+    if (!ReadFile(handle, buf, (size > MAXDWORD) ? MAXDWORD : (DWORD)size, &n, &ov)) {
+        return (GetLastError() == ERROR_HANDLE_EOF) ? 0 : -1;
+    }
+    return (ssize_t)n;
+}
@@ -0,0 +1,83 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "platform/platform-shm.h"
+
+void* platform_shm_create(const char* restrict name, size_t size) {
+    HANDLE mapping = CreateFileMappingA(
+        INVALID_HANDLE_VALUE,
+        NULL,
+        PAGE_READWRITE,
+        (DWORD)((uint64_t)size >> 32),
+        (DWORD)((uint64_t)size & 0xFFFFFFFF),
+        name);
+    if (!mapping) {
+        return NULL;
+    }
+    /** the section lives while a view or handle is open, nothing to replace. */
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+        CloseHandle(mapping);
+        return NULL;
+    }
+    void* addr = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    CloseHandle(mapping);
+    return addr;
+}
+
+void* platform_shm_open(const char* restrict name, size_t* size) {
+    MEMORY_BASIC_INFORMATION info;
+
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name);
+    if (!mapping) {
+        return NULL;
+    }
+    void* addr = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!addr) {
+        return NULL;
+    }
+    if (!VirtualQuery(addr, &info, sizeof(info))) {
+        UnmapViewOfFile(addr);
+        return NULL;
+    }
+    *size = info.RegionSize;
+    return addr;
+}
+
+void platform_shm_close(void* addr, size_t size) {
+    (void)(size);
+    UnmapViewOfFile(addr);
+}
+
+void platform_shm_unlink(const char* restrict name) {
+    (void)(name);
+}
+
+/** WaitOnAddress does not reach across processes, so nap instead. */
+void platform_shm_wait(atomic_uint* word, unsigned int expected, int timeout_ms) {
+    if (atomic_load(word) == expected && timeout_ms != 0) {
+        Sleep(1);
+    }
+}
+
+void platform_shm_wake(atomic_uint* word) {
+    (void)(word);
+}
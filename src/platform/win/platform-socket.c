@@ -19,6 +19,7 @@
  *  IN THE SOFTWARE.
  */
 
+#include "platform/platform-io.h"
 #include "platform/platform-socket.h"
 #include "wepoll/wepoll.h"
 
@@ -82,45 +83,46 @@ void platform_socket_set_rss(platform_sock_t sock, uint16_t idx, int cores) {
         NULL);
 }
 
-void platform_socket_enable_keepalive(platform_sock_t sock, bool on) {
-    if (!on) {
-        return;
-    }
+void platform_socket_set_keepalive(
+    platform_sock_t sock, bool on, int idle, int intvl, int cnt) {
     int val = on ? 1 : 0;
-    int d = 60;
-    int i = 1;  /* 1 second; same as default on win32 */
-    int c = 10; /* 10 retries; same as hardcoded on win32 since vista */
 
     setsockopt(sock, SOL_SOCKET, SO_KEEPALIVE, (const char*)&val, sizeof(val));
-    setsockopt(sock, IPPROTO_TCP, TCP_KEEPIDLE, (const char*)&d, sizeof(d));
-    setsockopt(sock, IPPROTO_TCP, TCP_KEEPINTVL, (const char*)&i, sizeof(i));
-    setsockopt(sock, IPPROTO_TCP, TCP_KEEPCNT, (const char*)&c, sizeof(c));
-}
-
-void platform_socket_enable_maxseg(platform_sock_t sock, bool on) {
     if (!on) {
         return;
     }
-    int af = platform_socket_get_addressfamily(sock);
-    /**
-     * windows doesn't support setting TCP_MAXSEG but IP_PMTUDISC_DONT forces
-     * the MSS to the protocol minimum which is what we want here. linux doesn't
-     * do this (disabling PMTUD just avoids setting DF).
-     */
-    if (af == AF_INET) {
-        int val = IP_PMTUDISC_DONT;
-        setsockopt(
-            sock, IPPROTO_IP, IP_MTU_DISCOVER, (const char*)&val, sizeof(int));
-    }
-    if (af == AF_INET6) {
-        int val = IP_PMTUDISC_DONT;
-        setsockopt(
-            sock,
-            IPPROTO_IPV6,
-            IPV6_MTU_DISCOVER,
-            (const char*)&val,
-            sizeof(int));
-    }
+    setsockopt(sock, IPPROTO_TCP, TCP_KEEPIDLE, (const char*)&idle, sizeof(idle));
+    setsockopt(sock, IPPROTO_TCP, TCP_KEEPINTVL, (const char*)&intvl, sizeof(intvl));
+    setsockopt(sock, IPPROTO_TCP, TCP_KEEPCNT, (const char*)&cnt, sizeof(cnt));
+}
+
+/**
+ * windows doesn't support setting TCP_MAXSEG, the stack derives the MSS from
+ * the interface MTU.
+ */
+void platform_socket_set_maxseg(platform_sock_t sock, int mss) {
+    (void)(sock);
+    (void)(mss);
+}
+
+void platform_socket_enable_cork(platform_sock_t sock, bool on) {
+    (void)(sock);
+    (void)(on);
+}
+
+void platform_socket_enable_quickack(platform_sock_t sock, bool on) {
+    (void)(sock);
+    (void)(on);
+}
+
+void platform_socket_set_busypoll(platform_sock_t sock, int usec) {
+    (void)(sock);
+    (void)(usec);
+}
+
+void platform_socket_set_notsent_lowat(platform_sock_t sock, int bytes) {
+    (void)(sock);
+    (void)(bytes);
 }
 
 void platform_socket_enable_nonblocking(platform_sock_t sock, bool on) {
@@ -166,6 +168,10 @@ void platform_socket_close(platform_sock_t sock) {
     closesocket(sock);
 }
 
+void platform_socket_shutdown_write(platform_sock_t sock) {
+    shutdown(sock, SD_SEND);
+}
+
 int platform_socket_get_socktype(platform_sock_t sock) {
     int type;
     int len = sizeof(int);
@@ -181,32 +187,93 @@ ssize_t platform_socket_send(platform_sock_t sock, void* buf, int size) {
     return send(sock, buf, size, 0);
 }
 
-ssize_t platform_socket_recvall(platform_sock_t sock, void* buf, int size) {
-    ssize_t off = 0;
+ssize_t platform_socket_recvall(platform_sock_t sock, void* buf, size_t size) {
+    size_t off = 0;
     while (off < size) {
-        ssize_t tmp = recv(sock, (char*)buf + (int)off, size - (int)off, 0);
+        int     chunk = (size - off > INT_MAX) ? INT_MAX : (int)(size - off);
+        ssize_t tmp   = recv(sock, (char*)buf + off, chunk, 0);
         if (tmp == PLATFORM_SO_ERROR_SOCKET_ERROR) {
             return PLATFORM_SO_ERROR_SOCKET_ERROR;
         }
         if (tmp == 0) {
-            return off;
+            return (ssize_t)off;
         }
         off += tmp;
     }
-    return off;
+    return (ssize_t)off;
 }
 
-ssize_t platform_socket_sendall(platform_sock_t sock, void* buf, int size) {
-    ssize_t off = 0;
+ssize_t platform_socket_sendall(platform_sock_t sock, void* buf, size_t size) {
+    size_t off = 0;
     while (off < size) {
-        ssize_t tmp =
-            send(sock, (const char*)buf + (int)off, size - (int)off, 0);
+        int     chunk = (size - off > INT_MAX) ? INT_MAX : (int)(size - off);
+        ssize_t tmp   = send(sock, (const char*)buf + off, chunk, 0);
         if (tmp == PLATFORM_SO_ERROR_SOCKET_ERROR) {
             return PLATFORM_SO_ERROR_SOCKET_ERROR;
         }
         off += tmp;
     }
-    return off;
+    return (ssize_t)off;
+}
+
+/** WSABUF lengths are 32 bit, larger entries go out in several calls. */
+static int _socket_iov_fill(
+    WSABUF* vec, const platform_iovec_t* iov, int iovcnt) {
+    if (iovcnt > PLATFORM_SO_IOV_MAX) {
+        iovcnt = PLATFORM_SO_IOV_MAX;
+    }
+    for (int i = 0; i < iovcnt; i++) {
+        vec[i].buf = iov[i].base;
+        vec[i].len = (iov[i].len > INT_MAX) ? INT_MAX : (ULONG)iov[i].len;
+        if (iov[i].len > INT_MAX) {
+            return i + 1;
+        }
+    }
+    return iovcnt;
+}
+
+ssize_t platform_socket_recvv(
+    platform_sock_t sock, const platform_iovec_t* iov, int iovcnt) {
+    WSABUF vec[PLATFORM_SO_IOV_MAX];
+    DWORD  bytes = 0;
+    DWORD  flags = 0;
+
+    iovcnt = _socket_iov_fill(vec, iov, iovcnt);
+    if (WSARecv(sock, vec, iovcnt, &bytes, &flags, NULL, NULL)) {
+        return PLATFORM_SO_ERROR_SOCKET_ERROR;
+    }
+    return (ssize_t)bytes;
+}
+
+ssize_t platform_socket_sendv(
+    platform_sock_t sock, const platform_iovec_t* iov, int iovcnt) {
+    WSABUF vec[PLATFORM_SO_IOV_MAX];
+    DWORD  bytes = 0;
+
+    iovcnt = _socket_iov_fill(vec, iov, iovcnt);
+    if (WSASend(sock, vec, iovcnt, &bytes, 0, NULL, NULL)) {
+        return PLATFORM_SO_ERROR_SOCKET_ERROR;
+    }
+    return (ssize_t)bytes;
+}
+
+ssize_t platform_socket_peek(platform_sock_t sock, void* buf, int size) {
+    return recv(sock, buf, size, MSG_PEEK);
+}
+
+/**
+ * TransmitFile does not fit non-blocking sockets, the file goes through a
+ * bounce buffer instead. returns 0 at end of file.
+ */
+ssize_t platform_socket_sendfile(
+    platform_sock_t sock, int fd, int64_t offset, size_t size) {
+    char    buf[65536];
+    ssize_t n = platform_io_pread(
+        fd, buf, (size > sizeof(buf)) ? sizeof(buf) : size, offset);
+    if (n <= 0) {
+        return n;
+    }
+    return send(sock, buf, (int)n, 0);
 }
 
 ssize_t platform_socket_recvfrom(
@@ -293,6 +360,218 @@ char* platform_socket_tostring(int error) {
     return buffer;
 }
 
+int platform_socket_get_soerror(platform_sock_t sock) {
+    int err = 0;
+    int len = sizeof(int);
+
+    if (getsockopt(sock, SOL_SOCKET, SO_ERROR, (char*)&err, &len)) {
+        return WSAGetLastError();
+    }
+    return err;
+}
+
+/** SIO_TCP_INFO counts the congestion window in bytes and has no variance. */
+int platform_socket_get_tcpinfo(platform_sock_t sock, platform_tcp_info_t* info) {
+    DWORD       version = 0;
+    TCP_INFO_v0 ti;
+    DWORD       len;
+
+    if (WSAIoctl(
+            sock,
+            SIO_TCP_INFO,
+            &version,
+            sizeof(version),
+            &ti,
+            sizeof(ti),
+            &len,
+            NULL,
+            NULL)) {
+        return -1;
+    }
+    info->rtt_us        = ti.RttUs;
+    info->rttvar_us     = 0;
+    info->retransmits   = ti.FastRetrans + ti.TimeoutEpisodes;
+    info->cwnd          = ti.Mss ? ti.Cwnd / ti.Mss : 0;
+    info->delivery_rate = 0;
+    return 0;
+}
+
+/** open, with nothing from the peer waiting to be read. */
+bool platform_socket_is_idle(platform_sock_t sock) {
+    fd_set         rfds;
+    struct timeval tv = {0, 0};
+
+    FD_ZERO(&rfds);
+    FD_SET(sock, &rfds);
+    return select(0, &rfds, NULL, NULL, &tv) == 0;
+}
+
+bool platform_socket_enable_zerocopy(platform_sock_t sock, bool on) {
+    (void)(sock);
+    (void)(on);
+    return false;
+}
+
+ssize_t platform_socket_send_zerocopy(platform_sock_t sock, void* buf, int size) {
+    return platform_socket_send(sock, buf, size);
+}
+
+int platform_socket_recv_zerocopy(
+    platform_sock_t sock, uint32_t* lo, uint32_t* hi, bool* copied) {
+    (void)(sock);
+    (void)(lo);
+    (void)(hi);
+    (void)(copied);
+    return 0;
+}
+
+bool platform_socket_enable_ktls(
+    platform_sock_t        sock,
+    platform_ktls_cipher_t cipher,
+    const uint8_t*         key,
+    const uint8_t*         iv,
+    uint64_t               seq) {
+    (void)(sock);
+    (void)(cipher);
+    (void)(key);
+    (void)(iv);
+    (void)(seq);
+    return false;
+}
+
+bool platform_socket_ktls_rekey(void) {
+    return false;
+}
+
+ssize_t platform_socket_send_record(
+    platform_sock_t sock, uint8_t type, void* buf, int size) {
+    (void)(sock);
+    (void)(type);
+    (void)(buf);
+    (void)(size);
+    WSASetLastError(WSAEOPNOTSUPP);
+    return PLATFORM_SO_ERROR_SOCKET_ERROR;
+}
+
+int platform_socket_unix_address(
+    const char* restrict     path,
+    struct sockaddr_storage* ss,
+    socklen_t*               sslen) {
+    struct sockaddr_un* sun = (struct sockaddr_un*)ss;
+    size_t              len = strlen(path);
+
+    if (len == 0 || len >= sizeof(sun->sun_path)) {
+        return -1;
+    }
+    memset(ss, 0, sizeof(struct sockaddr_storage));
+    sun->sun_family = AF_UNIX;
+    memcpy(sun->sun_path, path, len);
+    *sslen = (socklen_t)sizeof(struct sockaddr_un);
+    return 0;
+}
+
+/** a socket file nobody listens on any more refuses connections. */
+static bool _socket_unix_stale(struct sockaddr_storage* ss, socklen_t sslen) {
+    platform_sock_t probe = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (probe == PLATFORM_SO_ERROR_INVALID_SOCKET) {
+        return false;
+    }
+    bool stale = connect(probe, (struct sockaddr*)ss, (int)sslen) ==
+                     PLATFORM_SO_ERROR_SOCKET_ERROR &&
+                 WSAGetLastError() == WSAECONNREFUSED;
+
+    platform_socket_close(probe);
+    return stale;
+}
+
+platform_sock_t
+platform_socket_listen_unix(const char* restrict path, bool nonblocking) {
+    struct sockaddr_storage ss;
+    socklen_t               sslen;
+
+    if (platform_socket_unix_address(path, &ss, &sslen)) {
+        return PLATFORM_SO_ERROR_INVALID_SOCKET;
+    }
+    platform_sock_t sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock == PLATFORM_SO_ERROR_INVALID_SOCKET) {
+        return PLATFORM_SO_ERROR_INVALID_SOCKET;
+    }
+    /**
+     * afunix socket files are reparse points, never remove anything else nor
+     * one a live server still listens on.
+     */
+    DWORD attrs = GetFileAttributesA(path);
+    if (attrs != INVALID_FILE_ATTRIBUTES &&
+        (attrs & FILE_ATTRIBUTE_REPARSE_POINT) && _socket_unix_stale(&ss, sslen)) {
+        DeleteFileA(path);
+    }
+    if (bind(sock, (struct sockaddr*)&ss, (int)sslen) ==
+        PLATFORM_SO_ERROR_SOCKET_ERROR) {
+        platform_socket_close(sock);
+        return PLATFORM_SO_ERROR_INVALID_SOCKET;
+    }
+    if (listen(sock, SOMAXCONN) == PLATFORM_SO_ERROR_SOCKET_ERROR) {
+        platform_socket_close(sock);
+        return PLATFORM_SO_ERROR_INVALID_SOCKET;
+    }
+    platform_socket_enable_nonblocking(sock, nonblocking);
+    return sock;
+}
+
+ssize_t
+platform_socket_send_fd(platform_sock_t sock, int fd, void* buf, int size) {
+    (void)(sock);
+    (void)(fd);
+    (void)(buf);
+    (void)(size);
+    WSASetLastError(WSAEOPNOTSUPP);
+    return PLATFORM_SO_ERROR_SOCKET_ERROR;
+}
+
+ssize_t
+platform_socket_recv_fd(platform_sock_t sock, int* fd, void* buf, int size) {
+    (void)(sock);
+    (void)(buf);
+    (void)(size);
+    *fd = -1;
+    WSASetLastError(WSAEOPNOTSUPP);
+    return PLATFORM_SO_ERROR_SOCKET_ERROR;
+}
+
+int platform_socket_pipe(int fds[2]) {
+    (void)(fds);
+    return -1;
+}
+
+void platform_socket_pipe_close(int fds[2]) {
+    (void)(fds);
+}
+
+ssize_t platform_socket_splice_in(platform_sock_t sock, int pipefd, size_t size) {
+    (void)(sock);
+    (void)(pipefd);
+    (void)(size);
+    WSASetLastError(WSAEOPNOTSUPP);
+    return PLATFORM_SO_ERROR_SOCKET_ERROR;
+}
+
+ssize_t platform_socket_splice_out(int pipefd, platform_sock_t sock, size_t size) {
+    (void)(pipefd);
+    (void)(sock);
+    (void)(size);
+    WSASetLastError(WSAEOPNOTSUPP);
+    return PLATFORM_SO_ERROR_SOCKET_ERROR;
+}
+
+ssize_t platform_socket_pipe_write(int pipefd, const void* buf, size_t size) {
+    (void)(pipefd);
+    (void)(buf);
+    (void)(size);
+    WSASetLastError(WSAEOPNOTSUPP);
+    return PLATFORM_SO_ERROR_SOCKET_ERROR;
+}
+
 int platform_socket_get_lasterror(void) {
     return WSAGetLastError();
 }
@@ -357,9 +636,6 @@ platform_sock_t platform_socket_listen(
                 platform_socket_close(sock);
                 continue;
             }
-            platform_socket_enable_maxseg(sock, true);
-            platform_socket_enable_nodelay(sock, true);
-            platform_socket_enable_keepalive(sock, true);
         }
         platform_socket_enable_nonblocking(sock, nonblocking);
         break;
@@ -372,6 +648,102 @@ platform_sock_t platform_socket_listen(
     return sock;
 }
 
+platform_sock_t
+platform_socket_open(int family, int protocol, bool nonblocking) {
+    platform_sock_t sock = socket(family, protocol, 0);
+    if (sock == PLATFORM_SO_ERROR_INVALID_SOCKET) {
+        return PLATFORM_SO_ERROR_INVALID_SOCKET;
+    }
+    platform_socket_enable_nonblocking(sock, nonblocking);
+
+    if (protocol == SOCK_DGRAM) {
+        _socket_disable_udp_connreset(sock);
+    }
+    return sock;
+}
+
+int platform_socket_start_connect(
+    platform_sock_t        sock,
+    const struct sockaddr* sa,
+    socklen_t              salen,
+    bool*                  connected) {
+    if (connect(sock, sa, (int)salen)) {
+        if (WSAGetLastError() == WSAEWOULDBLOCK) {
+            return 0;
+        }
+        int err = WSAGetLastError();
+        platform_socket_close(sock);
+        WSASetLastError(err);
+        return -1;
+    }
+    *connected = true;
+    return 0;
+}
+
+platform_sock_t platform_socket_connect(
+    const struct sockaddr* sa,
+    socklen_t              salen,
+    int                    protocol,
+    bool*                  connected,
+    bool                   nonblocking) {
+    platform_sock_t sock =
+        platform_socket_open(sa->sa_family, protocol, nonblocking);
+    if (sock == PLATFORM_SO_ERROR_INVALID_SOCKET) {
+        return PLATFORM_SO_ERROR_INVALID_SOCKET;
+    }
+    if (platform_socket_start_connect(sock, sa, salen, connected)) {
+        return PLATFORM_SO_ERROR_INVALID_SOCKET;
+    }
+    return sock;
+}
+
+int platform_socket_wait_writable(
+    platform_sock_t* socks, bool* ready, int nsocks, int timeout_ms) {
+    WSAPOLLFD* pfds = malloc(nsocks * sizeof(WSAPOLLFD));
+    if (!pfds) {
+        return -1;
+    }
+    for (int i = 0; i < nsocks; i++) {
+        pfds[i].fd = socks[i];
+        pfds[i].events = POLLWRNORM;
+        pfds[i].revents = 0;
+    }
+    int n = WSAPoll(pfds, (ULONG)nsocks, timeout_ms);
+    for (int i = 0; i < nsocks; i++) {
+        ready[i] = (n > 0) && (pfds[i].revents & (POLLWRNORM | POLLERR | POLLHUP));
+    }
+    free(pfds);
+    return n;
+}
+
+int platform_socket_getaddrinfo(
+    const char* restrict     host,
+    const char* restrict     port,
+    int                      protocol,
+    struct sockaddr_storage* addrs,
+    socklen_t*               addrlens,
+    int                      maxaddrs) {
+    int              n = 0;
+    struct addrinfo  hints;
+    struct addrinfo* res;
+    struct addrinfo* rp;
+
+    memset(&hints, 0, sizeof(struct addrinfo));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = protocol;
+
+    if (getaddrinfo(host, port, &hints, &res)) {
+        return -1;
+    }
+    for (rp = res; rp != NULL && n < maxaddrs; rp = rp->ai_next) {
+        memcpy(&addrs[n], rp->ai_addr, rp->ai_addrlen);
+        addrlens[n] = (socklen_t)rp->ai_addrlen;
+        n++;
+    }
+    freeaddrinfo(res);
+    return n;
+}
+
 platform_sock_t platform_socket_dial(
     const char* restrict host,
     const char* restrict port,
@@ -395,37 +767,12 @@ platform_sock_t platform_socket_dial(
         return PLATFORM_SO_ERROR_INVALID_SOCKET;
     }
     for (rp = res; rp != NULL; rp = rp->ai_next) {
-        sock = socket(rp->ai_family, rp->ai_socktype, rp->ai_protocol);
-        if (sock == PLATFORM_SO_ERROR_INVALID_SOCKET) {
-            continue;
+        sock = platform_socket_connect(
+            rp->ai_addr, (socklen_t)rp->ai_addrlen, protocol, connected, nonblocking);
+        if (sock != PLATFORM_SO_ERROR_INVALID_SOCKET) {
+            break;
         }
-        platform_socket_enable_nonblocking(sock, nonblocking);
-
-        if (protocol == SOCK_STREAM) {
-            platform_socket_enable_maxseg(sock, true);
-            platform_socket_enable_nodelay(sock, true);
-            platform_socket_enable_keepalive(sock, true);
-        }
-        if (protocol == SOCK_DGRAM) {
-            _socket_disable_udp_connreset(sock);
-        }
-        if (connect(sock, rp->ai_addr, (int)rp->ai_addrlen)) {
-            if (WSAGetLastError() != WSAEWOULDBLOCK) {
-                platform_socket_close(sock);
-                continue;
-            }
-            if (WSAGetLastError() == WSAEWOULDBLOCK) {
-                break;
-            }
-        } else {
-            *connected = true;
-        }
-        break;
-    }
-    if (rp == NULL) {
-        freeaddrinfo(res);
-        return PLATFORM_SO_ERROR_INVALID_SOCKET;
     }
     freeaddrinfo(res);
     return sock;
-}
\ No newline at end of file
+}
@@ -25,8 +25,17 @@ void platform_uart_close(platform_uart_t uart) {
     CloseHandle(uart);
 }
 
-int platform_uart_read(platform_uart_t uart, uint8_t* buf, int len) {
+/** the comm timeouts set at open already bound the read. */
+int platform_uart_read(
+    platform_uart_t uart,
+    uint8_t*        buf,
+    int             len,
+    size_t          timeout_ms,
+    size_t          interbyte_timeout_ms) {
     DWORD bytes_read = 0;
+
+    (void)timeout_ms;
+    (void)interbyte_timeout_ms;
     if (!ReadFile(uart, buf, len, &bytes_read, NULL)) {
         return PLATFORM_UA_ERROR_UART_ERROR;
     }
@@ -41,9 +50,34 @@ int platform_uart_write(platform_uart_t uart, uint8_t* buf, int len) {
     return (int)bytes_written;
 }
 
-platform_uart_t platform_uart_open(platform_uart_config_t* config) {
+int platform_uart_read_some(platform_uart_t uart, uint8_t* buf, int len) {
+    return platform_uart_read(uart, buf, len, 0, 0);
+}
+
+int platform_uart_write_some(platform_uart_t uart, uint8_t* buf, int len) {
+    return platform_uart_write(uart, buf, len);
+}
+
+int platform_uart_get_lasterror(void) {
+    return (int)GetLastError();
+}
+
+/** a comm handle can not join the socket poller, there is no async mode. */
+platform_uart_t platform_uart_open(platform_uart_config_t* config, bool nonblocking) {
     platform_uart_t uart;
 
+    if (nonblocking) {
+        SetLastError(ERROR_NOT_SUPPORTED);
+        return PLATFORM_UA_ERROR_INVALID_UART;
+    }
+    /** the toggle mode only raises RTS while sending and has no delays. */
+    if (config->rs485.enabled &&
+        (!config->rs485.rts_on_send || config->rs485.delay_before_send_ms ||
+         config->rs485.delay_after_send_ms)) {
+        SetLastError(ERROR_NOT_SUPPORTED);
+        return PLATFORM_UA_ERROR_INVALID_UART;
+    }
+
     uart = CreateFileA(
         config->device,
         GENERIC_READ | GENERIC_WRITE,
@@ -59,26 +93,12 @@ platform_uart_t platform_uart_open(platform_uart_config_t* config) {
     SecureZeroMemory(&dcb, sizeof(DCB));
     dcb.DCBlength = sizeof(DCB);
 
-    switch (config->baudrate) {
-    case PLATFORM_UART_BAUDRATE_9600:
-        dcb.BaudRate = CBR_9600;
-        break;
-    case PLATFORM_UART_BAUDRATE_19200:
-        dcb.BaudRate = CBR_19200;
-        break;
-    case PLATFORM_UART_BAUDRATE_38400:
-        dcb.BaudRate = CBR_38400;
-        break;
-    case PLATFORM_UART_BAUDRATE_57600:
-        dcb.BaudRate = CBR_57600;
-        break;
-    case PLATFORM_UART_BAUDRATE_115200:
-        dcb.BaudRate = CBR_115200;
-        break;
-    default:
+    /** the driver takes any rate in bits per second and rejects what it can not do. */
+    if (!config->baudrate) {
         platform_uart_close(uart);
         return PLATFORM_UA_ERROR_INVALID_UART;
     }
+    dcb.BaudRate = config->baudrate;
     switch (config->databits) {
     case PLATFORM_UART_DATABITS_CS7:
         dcb.ByteSize = 7;
@@ -118,15 +138,18 @@ platform_uart_t platform_uart_open(platform_uart_config_t* config) {
         return PLATFORM_UA_ERROR_INVALID_UART;
     }
     dcb.fBinary = TRUE;
+
+    /** the driver raises RTS while sending where it supports the toggle mode. */
+    if (config->rs485.enabled) {
+        dcb.fRtsControl = RTS_CONTROL_TOGGLE;
+    }
     if (!SetCommState(uart, &dcb)) {
         platform_uart_close(uart);
         return PLATFORM_UA_ERROR_INVALID_UART;
     }
     COMMTIMEOUTS timeouts = {0};
-    if (config->timeout_ms) {
-        timeouts.ReadIntervalTimeout = 0;
-        timeouts.ReadTotalTimeoutConstant = config->timeout_ms;
-    }
+    timeouts.ReadIntervalTimeout      = (DWORD)config->interbyte_timeout_ms;
+    timeouts.ReadTotalTimeoutConstant = (DWORD)config->timeout_ms;
     if (!SetCommTimeouts(uart, &timeouts)) {
         platform_uart_close(uart);
         return PLATFORM_UA_ERROR_INVALID_UART;
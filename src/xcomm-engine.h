@@ -21,5 +21,42 @@
 
 _Pragma("once")
 
+#include <stdatomic.h>
+
+#include "xcomm-wg.h"
+#include "xcomm-list.h"
+#include "xcomm-event-loop.h"
+#include "xcomm-resolver.h"
+#include "xcomm-thrdpool.h"
+#include "deprecated/c11-threads.h"
+
+typedef struct engine_s        engine_t;
+typedef struct engine_worker_s engine_worker_t;
+
+struct engine_worker_s {
+    xcomm_event_loop_t looper;
+    atomic_int         refcnt;
+    int                idx;
+    xcomm_list_node_t  node;
+};
+
+struct engine_s {
+    atomic_flag  initialized;
+    xcomm_list_t workers;
+    int          concurrency;
+    int          nworkers;
+    mtx_t        mutex;
+    cnd_t        cond;
+    xcomm_wg_t   waitgroup;
+    xcomm_resolver_t resolver;
+    xcomm_thrdpool_t crypto;
+    atomic_bool      crypto_ready;
+    engine_worker_t* (*roundrobin)(void);
+    int (*snapshot)(engine_worker_t** workers, int size);
+    xcomm_thrdpool_t* (*cryptopool)(void);
+};
+
+extern engine_t engine;
+
 extern void xcomm_engine_startup(int concurrency);
 extern void xcomm_engine_cleanup(void);
\ No newline at end of file
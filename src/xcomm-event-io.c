@@ -20,4 +20,57 @@
  */
 
 #include "xcomm-event-io.h"
+#include "platform/platform-poller.h"
 
+static void _event_io_execute_cb(void* context, platform_poller_op_t op) {
+    xcomm_event_io_t* io = (xcomm_event_io_t*)context;
+
+    if (io->routine) {
+        io->routine(io->param, op);
+    }
+}
+
+void xcomm_event_io_add(
+    xcomm_event_loop_t*  loop,
+    xcomm_event_io_t*    io,
+    platform_poller_fd_t fd,
+    platform_poller_op_t op,
+    void (*routine)(void*, platform_poller_op_t),
+    void*                param) {
+    io->routine = routine;
+    io->param   = param;
+    io->op      = op;
+
+    io->event.type          = XCOMM_EVENT_TYPE_IO;
+    io->event.loop          = loop;
+    io->event.context       = io;
+    io->event.io.execute_cb = _event_io_execute_cb;
+    io->event.io.cleanup_cb = NULL;
+
+    io->event.io.sqe.op = op;
+    io->event.io.sqe.fd = fd;
+    io->event.io.sqe.ud = &io->event;
+
+    xcomm_list_insert_tail(&loop->io_ev_mgr, &io->event.io_node);
+    loop->io_ev_num++;
+
+    platform_poller_add(&loop->sq, &io->event.io.sqe);
+}
+
+void xcomm_event_io_mod(
+    xcomm_event_loop_t* loop, xcomm_event_io_t* io, platform_poller_op_t op) {
+    if (io->op == op) {
+        return;
+    }
+    io->op              = op;
+    io->event.io.sqe.op = op;
+
+    platform_poller_mod(&loop->sq, &io->event.io.sqe);
+}
+
+void xcomm_event_io_del(xcomm_event_loop_t* loop, xcomm_event_io_t* io) {
+    xcomm_list_remove(&io->event.io_node);
+    loop->io_ev_num--;
+
+    platform_poller_del(&loop->sq, &io->event.io.sqe);
+}
@@ -26,6 +26,16 @@ _Pragma("once")
 typedef struct xcomm_event_io_s xcomm_event_io_t;
 
 struct xcomm_event_io_s {
+    void (*routine)(void* param, platform_poller_op_t op);
+    void*                param;
+    platform_poller_op_t op;
+    xcomm_event_t        event;
+};
 
-    xcomm_event_t event;
-};
\ No newline at end of file
+/**
+ * io events are embedded in their owner rather than allocated here, the owner
+ * must keep it alive until xcomm_event_io_del returns.
+ */
+extern void xcomm_event_io_add(xcomm_event_loop_t* loop, xcomm_event_io_t* io, platform_poller_fd_t fd, platform_poller_op_t op, void (*routine)(void*, platform_poller_op_t), void* param);
+extern void xcomm_event_io_mod(xcomm_event_loop_t* loop, xcomm_event_io_t* io, platform_poller_op_t op);
+extern void xcomm_event_io_del(xcomm_event_loop_t* loop, xcomm_event_io_t* io);
\ No newline at end of file
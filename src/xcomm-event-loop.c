@@ -19,6 +19,8 @@
  *  IN THE SOFTWARE.
  */
 
+#include <limits.h>
+
 #include "xcomm-utils.h"
 #include "xcomm-event-loop.h"
 
@@ -57,6 +59,18 @@ static int _event_loop_calculate_timeout(xcomm_event_loop_t* loop) {
     return event->tm.calculate_timeout_cb(event->context);
 }
 
+/**
+ * routines posted by the loop thread itself do not wake it, so never block
+ * in the poller while any of them is still pending.
+ */
+static bool _event_loop_pending_routines(xcomm_event_loop_t* loop) {
+    mtx_lock(&loop->rt_ev_mtx);
+    bool pending = !xcomm_queue_empty(&loop->rt_ev_mgr);
+    mtx_unlock(&loop->rt_ev_mtx);
+
+    return pending;
+}
+
 static void _event_loop_process_timers(xcomm_event_loop_t* loop) {
     while (!xcomm_heap_empty(&loop->tm_ev_mgr)) {
         xcomm_event_t* event = xcomm_heap_data(
@@ -101,6 +115,7 @@ _event_loop_minheap_cmp(xcomm_heap_node_t* a, xcomm_heap_node_t* b) {
 void xcomm_event_loop_init(xcomm_event_loop_t* loop) {
     loop->running = true;
     loop->tid = thrd_current();
+    loop->now = xcomm_utils_getclock(XCOMM_TIME_PRECISION_USEC);
     
     mtx_init(&loop->rt_ev_mtx, mtx_plain);
     
@@ -116,6 +131,7 @@ void xcomm_event_loop_init(xcomm_event_loop_t* loop) {
 
     platform_poller_init(&loop->sq);
     platform_socket_socketpair(AF_INET, SOCK_STREAM, 0, loop->wakefds);
+    platform_socket_enable_nonblocking(loop->wakefds[0], true);
     platform_socket_enable_nonblocking(loop->wakefds[1], true);
 
     xcomm_event_t* event = malloc(sizeof(xcomm_event_t));
@@ -136,11 +152,30 @@ void xcomm_event_loop_init(xcomm_event_loop_t* loop) {
     xcomm_list_insert_tail(&loop->io_ev_mgr, &event->io_node);
     loop->io_ev_num++;
 
-    platform_poller_add(loop->sq, &event->io.sqe);
+    platform_poller_add(&loop->sq, &event->io.sqe);
 }
 
+/**
+ * releases what init set up once the loop has returned, io sources that
+ * are still registered belong to their owners and are left alone.
+ */
 void xcomm_event_loop_destroy(xcomm_event_loop_t* loop) {
-
+    xcomm_list_node_t* node = xcomm_list_head(&loop->io_ev_mgr);
+    while (node != xcomm_list_sentinel(&loop->io_ev_mgr)) {
+        xcomm_event_t* event = xcomm_list_data(node, xcomm_event_t, io_node);
+        node = xcomm_list_next(node);
+
+        if (event->io.execute_cb == _event_loop_wake_cb) {
+            platform_poller_del(&loop->sq, &event->io.sqe);
+            xcomm_list_remove(&event->io_node);
+            loop->io_ev_num--;
+            free(event);
+        }
+    }
+    platform_socket_close(loop->wakefds[0]);
+    platform_socket_close(loop->wakefds[1]);
+    platform_poller_destroy(&loop->sq);
+    mtx_destroy(&loop->rt_ev_mtx);
 }
 
 //void xcomm_event_loop_register(xcomm_event_loop_t* loop, xcomm_event_t* event) {
@@ -208,21 +243,33 @@ void xcomm_event_loop_destroy(xcomm_event_loop_t* loop) {
 
 void xcomm_event_loop_post(xcomm_event_loop_t* loop, xcomm_event_t* event) {
     mtx_lock(&loop->rt_ev_mtx);
+    bool wake = xcomm_queue_empty(&loop->rt_ev_mgr);
     xcomm_queue_enqueue(&loop->rt_ev_mgr, &event->rt_node);
     loop->rt_ev_num++;
     mtx_unlock(&loop->rt_ev_mtx);
 
-    _event_loop_wake(loop);
+    /**
+     * only the first post of a batch needs to wake the loop, and the loop
+     * does not block in the poller while routines are pending.
+     */
+    if (wake && !thrd_equal(loop->tid, thrd_current())) {
+        _event_loop_wake(loop);
+    }
 }
 
 void xcomm_event_loop_run(xcomm_event_loop_t* loop) {
     platform_poller_cqe_t cqes[PLATFORM_POLLER_CQE_NUM] = {0};
 
     while (loop->running) {
+        loop->now = xcomm_utils_getclock(XCOMM_TIME_PRECISION_USEC);
         _event_loop_process_routines(loop);
 
-        int nevents = platform_poller_wait(
-            loop->sq, cqes, _event_loop_calculate_timeout(loop));
+        int timeout = _event_loop_pending_routines(loop)
+                          ? 0
+                          : _event_loop_calculate_timeout(loop);
+
+        int nevents = platform_poller_wait(&loop->sq, cqes, timeout);
+        loop->now   = xcomm_utils_getclock(XCOMM_TIME_PRECISION_USEC);
 
         for (int i = 0; i < nevents; i++) {
             xcomm_event_t* event = cqes[i].ud;
@@ -31,9 +31,14 @@ typedef struct xcomm_event_loop_s xcomm_event_loop_t;
 typedef enum xcomm_event_type_e   xcomm_event_type_t;
 typedef struct xcomm_event_s      xcomm_event_t;
 
+/**
+ * now is sampled in microseconds from the monotonic clock once per wakeup,
+ * for the loop thread only.
+ */
 struct xcomm_event_loop_s {
     bool                 running;
     thrd_t               tid;
+    uint64_t             now;
     platform_poller_sq_t sq;
     platform_poller_fd_t wakefds[2];
 
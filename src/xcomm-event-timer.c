@@ -49,7 +49,7 @@ static void _event_timer_cleanup_cb(void* context) {
 static int _event_timer_calculate_timeout_cb(void* context) {
     xcomm_event_timer_t* timer = (xcomm_event_timer_t*)context;
 
-    uint64_t now = xcomm_utils_getnow(XCOMM_TIME_PRECISION_MSEC);
+    uint64_t now = xcomm_utils_getclock(XCOMM_TIME_PRECISION_MSEC);
     if (timer->birth + timer->expire <= now) {
         return 0;
     }
@@ -81,7 +81,7 @@ void xcomm_event_timer_reset(
     xcomm_heap_remove(&loop->tm_ev_mgr, &timer->event.tm_node);
     loop->tm_ev_num--;
 
-    timer->birth = xcomm_utils_getnow(XCOMM_TIME_PRECISION_MSEC);
+    timer->birth = xcomm_utils_getclock(XCOMM_TIME_PRECISION_MSEC);
     timer->expire = expire_ms;
 
     xcomm_heap_insert(&loop->tm_ev_mgr, &timer->event.tm_node);
@@ -115,7 +115,7 @@ xcomm_event_timer_t* xcomm_event_timer_add(
     timer->routine = routine;
     timer->param   = param;
     timer->id      = loop->tm_ev_next_id++;
-    timer->birth   = xcomm_utils_getnow(XCOMM_TIME_PRECISION_MSEC);
+    timer->birth   = xcomm_utils_getclock(XCOMM_TIME_PRECISION_MSEC);
     timer->expire  = expire_ms;
     timer->repeat  = repeat;
 
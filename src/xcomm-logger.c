@@ -132,7 +132,9 @@ static void _async_log(
     if (ctx) {
         memcpy(ctx->message, buf, ret);
         ctx->level = level;
-        xcomm_thrdpool_post(&logger.thrdpool, _logger_print_message, ctx);
+        if (xcomm_thrdpool_post(&logger.thrdpool, _logger_print_message, ctx)) {
+            free(ctx);
+        }
     }
     mtx_unlock(&logger.mtx);
 }
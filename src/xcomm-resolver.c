@@ -0,0 +1,257 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "xcomm-resolver.h"
+#include "xcomm-utils.h"
+#include "xcomm-event-routine.h"
+
+#include "platform/platform-socket.h"
+
+typedef struct resolver_entry_s  resolver_entry_t;
+typedef struct resolver_waiter_s resolver_waiter_t;
+
+struct resolver_entry_s {
+    xcomm_rbtree_node_t    node;
+    xcomm_resolver_t*      resolver;
+    char*                  host;
+    char*                  port;
+    int                    socktype;
+    bool                   resolving;
+    int                    err;
+    uint64_t               expire;
+    xcomm_resolver_addrs_t addrs;
+    xcomm_list_t           waiters;
+    xcomm_list_node_t      lru;
+};
+
+struct resolver_waiter_s {
+    xcomm_event_loop_t*    loop;
+    xcomm_resolver_cb_t    cb;
+    void*                  userdata;
+    int                    err;
+    xcomm_resolver_addrs_t addrs;
+    xcomm_list_node_t      node;
+};
+
+static void _resolver_complete(void* param) {
+    resolver_waiter_t* waiter = param;
+
+    waiter->cb(waiter->err, waiter->err ? NULL : &waiter->addrs, waiter->userdata);
+    free(waiter);
+}
+
+/** waiters still queued when the entry goes are completed with an error. */
+static void _resolver_entry_free(resolver_entry_t* entry) {
+    while (!xcomm_list_empty(&entry->waiters)) {
+        xcomm_list_node_t* node = xcomm_list_head(&entry->waiters);
+        xcomm_list_remove(node);
+
+        resolver_waiter_t* waiter =
+            xcomm_list_data(node, resolver_waiter_t, node);
+        waiter->err = PLATFORM_SO_ERROR_ECONNABORTED;
+        xcomm_event_routine_add(waiter->loop, _resolver_complete, waiter);
+    }
+    free(entry->node.key.str);
+    free(entry->host);
+    free(entry->port);
+    free(entry);
+}
+
+static resolver_entry_t* _resolver_entry_create(
+    char* key, const char* host, const char* port, int socktype) {
+    resolver_entry_t* entry = calloc(1, sizeof(resolver_entry_t));
+    if (!entry) {
+        return NULL;
+    }
+    entry->host = strdup(host);
+    entry->port = strdup(port);
+    if (!entry->host || !entry->port) {
+        free(entry->host);
+        free(entry->port);
+        free(entry);
+        return NULL;
+    }
+    entry->node.key.str = key;
+    entry->socktype = socktype;
+    xcomm_list_init(&entry->waiters);
+    return entry;
+}
+
+/**
+ * makes room for one more entry by dropping the least recently used ones,
+ * lookups in flight stay. caller holds the mutex.
+ */
+static void _resolver_evict(xcomm_resolver_t* resolver) {
+    xcomm_list_node_t* node = xcomm_list_tail(&resolver->lru);
+
+    while (resolver->nentries >= XCOMM_RESOLVER_MAXENTRIES &&
+           node != xcomm_list_sentinel(&resolver->lru)) {
+        resolver_entry_t* entry = xcomm_list_data(node, resolver_entry_t, lru);
+        node = xcomm_list_prev(node);
+
+        if (!entry->resolving) {
+            xcomm_rbtree_erase(&resolver->entries, &entry->node);
+            xcomm_list_remove(&entry->lru);
+            resolver->nentries--;
+            _resolver_entry_free(entry);
+        }
+    }
+}
+
+static void _resolver_notify(resolver_waiter_t* waiter, resolver_entry_t* entry) {
+    waiter->err = entry->err;
+    if (!entry->err) {
+        memcpy(&waiter->addrs, &entry->addrs, sizeof(xcomm_resolver_addrs_t));
+    }
+    xcomm_event_routine_add(waiter->loop, _resolver_complete, waiter);
+}
+
+static void _resolver_lookup(void* param) {
+    resolver_entry_t*      entry = param;
+    xcomm_resolver_t*      resolver = entry->resolver;
+    xcomm_resolver_addrs_t addrs;
+
+    addrs.naddrs = platform_socket_getaddrinfo(
+        entry->host,
+        entry->port,
+        entry->socktype,
+        addrs.addrs,
+        addrs.addrlens,
+        XCOMM_RESOLVER_MAXADDRS);
+
+    uint64_t now = xcomm_utils_getnow(XCOMM_TIME_PRECISION_MSEC);
+
+    mtx_lock(&resolver->mtx);
+    if (addrs.naddrs > 0) {
+        memcpy(&entry->addrs, &addrs, sizeof(xcomm_resolver_addrs_t));
+        entry->err = 0;
+        entry->expire = now + resolver->ttl;
+    } else {
+        entry->err = PLATFORM_SO_ERROR_EHOSTUNREACH;
+        entry->expire = now + resolver->negative_ttl;
+    }
+    entry->resolving = false;
+    resolver->nlookups++;
+
+    while (!xcomm_list_empty(&entry->waiters)) {
+        xcomm_list_node_t* node = xcomm_list_head(&entry->waiters);
+        xcomm_list_remove(node);
+        _resolver_notify(xcomm_list_data(node, resolver_waiter_t, node), entry);
+    }
+    mtx_unlock(&resolver->mtx);
+}
+
+void xcomm_resolver_init(
+    xcomm_resolver_t* restrict resolver, int nthrds, int ttl_ms) {
+    mtx_init(&resolver->mtx, mtx_plain);
+    xcomm_rbtree_init(&resolver->entries, xcomm_rbtree_keycmp_str);
+    xcomm_list_init(&resolver->lru);
+
+    resolver->nentries = 0;
+    resolver->nlookups = 0;
+    resolver->ttl = ttl_ms;
+    resolver->negative_ttl =
+        (ttl_ms < XCOMM_RESOLVER_NEGATIVE_TTL) ? ttl_ms : XCOMM_RESOLVER_NEGATIVE_TTL;
+
+    xcomm_thrdpool_init(&resolver->pool, (nthrds > 0) ? nthrds : 1);
+}
+
+void xcomm_resolver_destroy(xcomm_resolver_t* restrict resolver) {
+    xcomm_thrdpool_destroy(&resolver->pool);
+
+    while (!xcomm_rbtree_empty(&resolver->entries)) {
+        xcomm_rbtree_node_t* node = xcomm_rbtree_first(&resolver->entries);
+        xcomm_rbtree_erase(&resolver->entries, node);
+        _resolver_entry_free(xcomm_rbtree_data(node, resolver_entry_t, node));
+    }
+    resolver->nentries = 0;
+    mtx_destroy(&resolver->mtx);
+}
+
+int xcomm_resolver_resolve(
+    xcomm_resolver_t* restrict resolver,
+    xcomm_event_loop_t*        loop,
+    const char* restrict       host,
+    const char* restrict       port,
+    int                        socktype,
+    xcomm_resolver_cb_t        cb,
+    void*                      userdata) {
+    size_t len = strlen(host) + strlen(port) + 16;
+    char*  key = malloc(len);
+    if (!key) {
+        return -1;
+    }
+    snprintf(key, len, "%s|%s|%d", host, port, socktype);
+
+    resolver_waiter_t* waiter = malloc(sizeof(resolver_waiter_t));
+    if (!waiter) {
+        free(key);
+        return -1;
+    }
+    waiter->loop = loop;
+    waiter->cb = cb;
+    waiter->userdata = userdata;
+
+    uint64_t now = xcomm_utils_getnow(XCOMM_TIME_PRECISION_MSEC);
+
+    mtx_lock(&resolver->mtx);
+    xcomm_rbtree_node_t* node = xcomm_rbtree_find(
+        &resolver->entries, (xcomm_rbtree_key_t){.str = key});
+
+    resolver_entry_t* entry;
+    if (node) {
+        free(key);
+        entry = xcomm_rbtree_data(node, resolver_entry_t, node);
+        xcomm_list_remove(&entry->lru);
+        xcomm_list_insert_head(&resolver->lru, &entry->lru);
+    } else {
+        _resolver_evict(resolver);
+
+        entry = _resolver_entry_create(key, host, port, socktype);
+        if (!entry) {
+            mtx_unlock(&resolver->mtx);
+            free(key);
+            free(waiter);
+            return -1;
+        }
+        entry->resolver = resolver;
+        xcomm_rbtree_insert(&resolver->entries, &entry->node);
+        xcomm_list_insert_head(&resolver->lru, &entry->lru);
+        resolver->nentries++;
+    }
+    if (node && !entry->resolving && entry->expire > now) {
+        _resolver_notify(waiter, entry);
+        mtx_unlock(&resolver->mtx);
+        return 0;
+    }
+    if (!entry->resolving) {
+        /** nobody else waits on an entry that is not resolving. */
+        if (xcomm_thrdpool_post(&resolver->pool, _resolver_lookup, entry)) {
+            mtx_unlock(&resolver->mtx);
+            free(waiter);
+            return -1;
+        }
+        entry->resolving = true;
+    }
+    xcomm_list_insert_tail(&entry->waiters, &waiter->node);
+    mtx_unlock(&resolver->mtx);
+    return 0;
+}
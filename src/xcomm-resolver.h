@@ -0,0 +1,66 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+_Pragma("once")
+
+#include "xcomm-list.h"
+#include "xcomm-rbtree.h"
+#include "xcomm-thrdpool.h"
+#include "xcomm-event-loop.h"
+
+#include "platform/platform-types.h"
+
+#define XCOMM_RESOLVER_MAXADDRS     16
+#define XCOMM_RESOLVER_MAXENTRIES   1024
+#define XCOMM_RESOLVER_TTL          60000
+#define XCOMM_RESOLVER_NEGATIVE_TTL 5000
+
+typedef struct xcomm_resolver_s       xcomm_resolver_t;
+typedef struct xcomm_resolver_addrs_s xcomm_resolver_addrs_t;
+
+typedef void (*xcomm_resolver_cb_t)(int err, xcomm_resolver_addrs_t* addrs, void* userdata);
+
+struct xcomm_resolver_addrs_s {
+    int                     naddrs;
+    socklen_t               addrlens[XCOMM_RESOLVER_MAXADDRS];
+    struct sockaddr_storage addrs[XCOMM_RESOLVER_MAXADDRS];
+};
+
+/**
+ * getaddrinfo on a thread pool, concurrent lookups of the same key share one
+ * query and answers are cached for ttl ms (failures for negative_ttl ms).
+ * past maxentries the least recently used answers make room.
+ * callbacks always run as routines on the loop passed to resolve.
+ */
+struct xcomm_resolver_s {
+    xcomm_thrdpool_t pool;
+    mtx_t            mtx;
+    xcomm_rbtree_t   entries;
+    xcomm_list_t     lru;
+    size_t           nentries;
+    int              ttl;
+    int              negative_ttl;
+    uint64_t         nlookups;
+};
+
+extern void xcomm_resolver_init(xcomm_resolver_t* restrict resolver, int nthrds, int ttl_ms);
+extern void xcomm_resolver_destroy(xcomm_resolver_t* restrict resolver);
+extern int  xcomm_resolver_resolve(xcomm_resolver_t* restrict resolver, xcomm_event_loop_t* loop, const char* restrict host, const char* restrict port, int socktype, xcomm_resolver_cb_t cb, void* userdata);
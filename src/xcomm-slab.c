@@ -0,0 +1,124 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "xcomm-slab.h"
+
+typedef struct slab_chunk_s slab_chunk_t;
+
+struct slab_chunk_s {
+    xcomm_list_node_t node;
+};
+
+static int _slab_grow(xcomm_slab_t* slab) {
+    size_t size = sizeof(slab_chunk_t) + XCOMM_SLAB_CACHELINE - 1 +
+                  slab->objsize * slab->objnum;
+    slab_chunk_t* chunk = malloc(size);
+    if (!chunk) {
+        return -1;
+    }
+    xcomm_list_insert_tail(&slab->chunks, &chunk->node);
+
+    uintptr_t base = (uintptr_t)(chunk + 1);
+    base = (base + XCOMM_SLAB_CACHELINE - 1) &
+           ~(uintptr_t)(XCOMM_SLAB_CACHELINE - 1);
+
+    for (size_t i = slab->objnum; i > 0; i--) {
+        void** obj = (void**)(base + (i - 1) * slab->objsize);
+        *obj = slab->freelist;
+        slab->freelist = obj;
+    }
+    slab->nfree  += slab->objnum;
+    slab->ntotal += slab->objnum;
+    return 0;
+}
+
+void xcomm_slab_init(xcomm_slab_t* restrict slab, size_t objsize, size_t objnum) {
+    if (objsize < sizeof(void*)) {
+        objsize = sizeof(void*);
+    }
+    slab->objsize  = (objsize + XCOMM_SLAB_CACHELINE - 1) &
+                    ~(size_t)(XCOMM_SLAB_CACHELINE - 1);
+    slab->objnum   = objnum ? objnum : 1;
+    slab->nfree    = 0;
+    slab->ntotal   = 0;
+    slab->freelist = NULL;
+
+    xcomm_list_init(&slab->chunks);
+    xcomm_spinlock_init(&slab->lock);
+}
+
+void xcomm_slab_destroy(xcomm_slab_t* restrict slab) {
+    while (!xcomm_list_empty(&slab->chunks)) {
+        xcomm_list_node_t* node = xcomm_list_head(&slab->chunks);
+        xcomm_list_remove(node);
+        free(xcomm_list_data(node, slab_chunk_t, node));
+    }
+    slab->nfree    = 0;
+    slab->ntotal   = 0;
+    slab->freelist = NULL;
+
+    xcomm_spinlock_destroy(&slab->lock);
+}
+
+int xcomm_slab_reserve(xcomm_slab_t* restrict slab, size_t n) {
+    int ret = 0;
+
+    xcomm_spinlock_lock(&slab->lock);
+    while (slab->nfree < n) {
+        if (_slab_grow(slab) < 0) {
+            ret = -1;
+            break;
+        }
+    }
+    xcomm_spinlock_unlock(&slab->lock);
+    return ret;
+}
+
+void* xcomm_slab_alloc(xcomm_slab_t* restrict slab) {
+    xcomm_spinlock_lock(&slab->lock);
+
+    if (!slab->freelist && _slab_grow(slab) < 0) {
+        xcomm_spinlock_unlock(&slab->lock);
+        return NULL;
+    }
+    void** obj = slab->freelist;
+    slab->freelist = *obj;
+    slab->nfree--;
+
+    xcomm_spinlock_unlock(&slab->lock);
+    return obj;
+}
+
+void xcomm_slab_free(xcomm_slab_t* restrict slab, void* obj) {
+    if (!obj) {
+        return;
+    }
+    xcomm_spinlock_lock(&slab->lock);
+
+    *(void**)obj = slab->freelist;
+    slab->freelist = obj;
+    slab->nfree++;
+
+    xcomm_spinlock_unlock(&slab->lock);
+}
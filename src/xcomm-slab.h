@@ -0,0 +1,51 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+_Pragma("once")
+
+#include <stddef.h>
+
+#include "xcomm-list.h"
+#include "xcomm-spinlock.h"
+
+#define XCOMM_SLAB_CACHELINE 64
+
+typedef struct xcomm_slab_s xcomm_slab_t;
+
+/**
+ * fixed size object pool, objects are cache line aligned and carved out of
+ * chunks that are only returned to the system on destroy.
+ */
+struct xcomm_slab_s {
+    size_t           objsize;
+    size_t           objnum;
+    size_t           nfree;
+    size_t           ntotal;
+    void*            freelist;
+    xcomm_list_t     chunks;
+    xcomm_spinlock_t lock;
+};
+
+extern void  xcomm_slab_init(xcomm_slab_t* restrict slab, size_t objsize, size_t objnum);
+extern void  xcomm_slab_destroy(xcomm_slab_t* restrict slab);
+extern int   xcomm_slab_reserve(xcomm_slab_t* restrict slab, size_t n);
+extern void* xcomm_slab_alloc(xcomm_slab_t* restrict slab);
+extern void  xcomm_slab_free(xcomm_slab_t* restrict slab, void* obj);
@@ -38,12 +38,12 @@ static int _thrdpool_thrdfunc(void* arg) {
             cnd_wait(&pool->qcnd, &pool->qmtx);
         }
         xcomm_queue_node_t* node = xcomm_queue_dequeue(&pool->queue);
+        mtx_unlock(&pool->qmtx);
         if (node) {
             job = xcomm_queue_data(node, thrdpool_job_t, n);
             job->routine(job->arg);
             free(job);
         }
-        mtx_unlock(&pool->qmtx);
     }
     return 0;
 }
@@ -76,26 +76,36 @@ void xcomm_thrdpool_init(xcomm_thrdpool_t* restrict pool, int nthrds) {
     }
 }
 
-void xcomm_thrdpool_post(
+/** returns -1 when the job could not be queued, routine then never runs. */
+int xcomm_thrdpool_post(
     xcomm_thrdpool_t* restrict pool, void (*routine)(void*), void* arg) {
     thrdpool_job_t* job = malloc(sizeof(thrdpool_job_t));
-    if (job) {
-        job->routine = routine;
-        job->arg = arg;
-
-        mtx_lock(&pool->qmtx);
-        xcomm_queue_enqueue(&pool->queue, &job->n);
-        cnd_signal(&pool->qcnd);
-        mtx_unlock(&pool->qmtx);
+    if (!job) {
+        return -1;
     }
+    job->routine = routine;
+    job->arg = arg;
+
+    mtx_lock(&pool->qmtx);
+    xcomm_queue_enqueue(&pool->queue, &job->n);
+    cnd_signal(&pool->qcnd);
+    mtx_unlock(&pool->qmtx);
+    return 0;
 }
 
 void xcomm_thrdpool_destroy(xcomm_thrdpool_t* restrict pool) {
+    mtx_lock(&pool->qmtx);
     pool->status = false;
     cnd_broadcast(&pool->qcnd);
+    mtx_unlock(&pool->qmtx);
     for (int i = 0; i < pool->thrdcnt; i++) {
         thrd_join(pool->thrds[i], NULL);
     }
+    /** jobs nobody picked up are dropped. */
+    while (!xcomm_queue_empty(&pool->queue)) {
+        xcomm_queue_node_t* node = xcomm_queue_dequeue(&pool->queue);
+        free(xcomm_queue_data(node, thrdpool_job_t, n));
+    }
     mtx_destroy(&pool->qmtx);
     mtx_destroy(&pool->tmtx);
     cnd_destroy(&pool->qcnd);
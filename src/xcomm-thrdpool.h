@@ -37,5 +37,5 @@ struct xcomm_thrdpool_s {
 };
 
 extern void xcomm_thrdpool_init(xcomm_thrdpool_t* restrict pool, int nthrds);
-extern void xcomm_thrdpool_post(xcomm_thrdpool_t* restrict pool, void (*routine)(void*), void* arg);
+extern int  xcomm_thrdpool_post(xcomm_thrdpool_t* restrict pool, void (*routine)(void*), void* arg);
 extern void xcomm_thrdpool_destroy(xcomm_thrdpool_t* restrict pool);
\ No newline at end of file
@@ -20,6 +20,7 @@
  */
 
 #include "xcomm-utils.h"
+#include "platform/platform-info.h"
 
 uint64_t xcomm_utils_getnow(xcomm_time_precision_t precision) {
     struct timespec tsc;
@@ -39,6 +40,23 @@ uint64_t xcomm_utils_getnow(xcomm_time_precision_t precision) {
     }
 }
 
+uint64_t xcomm_utils_getclock(xcomm_time_precision_t precision) {
+    uint64_t ns = platform_info_getclock();
+
+    switch (precision) {
+    case XCOMM_TIME_PRECISION_SEC:
+        return ns / 1000000000ULL;
+    case XCOMM_TIME_PRECISION_MSEC:
+        return ns / 1000000ULL;
+    case XCOMM_TIME_PRECISION_USEC:
+        return ns / 1000ULL;
+    case XCOMM_TIME_PRECISION_NSEC:
+        return ns;
+    default:
+        return UINT64_MAX;
+    }
+}
+
 xcomm_endian_t xcomm_utils_getendian(void) {
     return (*((unsigned char*)(&(unsigned short){0x01}))) ? XCOMM_ENDIAN_LE
                                                           : XCOMM_ENDIAN_BE;
@@ -40,5 +40,7 @@ enum xcomm_time_precision_e {
 
 extern int            xcomm_utils_getprng(int min, int max);
 extern uint64_t       xcomm_utils_getnow(xcomm_time_precision_t precision);
+/** like getnow but monotonic, for measuring intervals rather than dates. */
+extern uint64_t       xcomm_utils_getclock(xcomm_time_precision_t precision);
 extern xcomm_endian_t xcomm_utils_getendian(void);
 
@@ -19,38 +19,21 @@
  *  IN THE SOFTWARE.
  */
 
-#include <stdatomic.h>
-
 #include "xcomm.h"
-#include "xcomm-wg.h"
-#include "xcomm-event-loop.h"
-#include "deprecated/c11-threads.h"
+#include "xcomm-engine.h"
 
+#include "modules/tcp/xcomm-async-tcp.h"
+#include "platform/platform-info.h"
 #include "platform/platform-socket.h"
 
-typedef struct engine_s        engine_t;
-typedef struct engine_worker_s engine_worker_t;
-
-struct engine_worker_s {
-    xcomm_event_loop_t looper;
-    atomic_int         refcnt;
-    xcomm_list_node_t  node;
-};
-
-struct engine_s {
-    atomic_flag  initialized;
-    xcomm_list_t workers;
-    mtx_t        mutex;
-    cnd_t        cond;
-    xcomm_wg_t   waitgroup;
-    engine_worker_t* (*roundrobin)(void);
-};
+#define ENGINE_RESOLVER_THREADS 2
 
 engine_t engine = {
     .initialized = ATOMIC_FLAG_INIT,
     .workers     = {0},
     .waitgroup   = {0},
-    .roundrobin  = NULL
+    .roundrobin  = NULL,
+    .snapshot    = NULL
 };
 
 static void _engine_worker_ref(engine_worker_t* worker) {
@@ -82,6 +65,47 @@ static engine_worker_t* _engine_roundrobin(void) {
     return worker;
 }
 
+/**
+ * waits until every worker is up and fills workers in index order, each
+ * entry is referenced like a roundrobin pick.
+ */
+static int _engine_snapshot(engine_worker_t** workers, int size) {
+    int n = 0;
+
+    mtx_lock(&engine.mutex);
+
+    while (engine.nworkers < engine.concurrency) {
+        cnd_wait(&engine.cond, &engine.mutex);
+    }
+    xcomm_list_node_t* node = xcomm_list_head(&engine.workers);
+    while (node != xcomm_list_sentinel(&engine.workers)) {
+        engine_worker_t* worker = xcomm_list_data(node, engine_worker_t, node);
+        node = xcomm_list_next(node);
+
+        if (worker->idx < size) {
+            _engine_worker_ref(worker);
+            workers[worker->idx] = worker;
+            n++;
+        }
+    }
+    mtx_unlock(&engine.mutex);
+
+    return n;
+}
+
+/** the crypto pool is started by the first tls connection that needs it. */
+static xcomm_thrdpool_t* _engine_cryptopool(void) {
+    if (!atomic_load_explicit(&engine.crypto_ready, memory_order_acquire)) {
+        mtx_lock(&engine.mutex);
+        if (!atomic_load_explicit(&engine.crypto_ready, memory_order_relaxed)) {
+            xcomm_thrdpool_init(&engine.crypto, platform_info_getcpus());
+            atomic_store_explicit(&engine.crypto_ready, true, memory_order_release);
+        }
+        mtx_unlock(&engine.mutex);
+    }
+    return &engine.crypto;
+}
+
 static engine_worker_t* _engine_create_worker(void) {
     engine_worker_t* worker = calloc(1, sizeof(engine_worker_t));
     if (!worker) {
@@ -93,8 +117,9 @@ static engine_worker_t* _engine_create_worker(void) {
     xcomm_event_loop_init(&worker->looper);
 
     mtx_lock(&engine.mutex);
+    worker->idx = engine.nworkers++;
     xcomm_list_insert_tail(&engine.workers, &worker->node);
-    cnd_signal(&engine.cond);
+    cnd_broadcast(&engine.cond);
     mtx_unlock(&engine.mutex);
 
     return worker;
@@ -118,6 +143,8 @@ static int _worker_thread(void* param) {
         return -1;
     }
     xcomm_event_loop_run(&worker->looper);
+
+    xcomm_async_tcp_worker_exit(&worker->looper);
     
     _engine_destroy_worker(worker);
 
@@ -135,8 +162,17 @@ static void _engine_startup(int concurrency) {
 
     xcomm_wg_init(&engine.waitgroup);
     xcomm_list_init(&engine.workers);
+    xcomm_resolver_init(
+        &engine.resolver, ENGINE_RESOLVER_THREADS, XCOMM_RESOLVER_TTL);
+    atomic_init(&engine.crypto_ready, false);
+
+    engine.concurrency = thrdcnt;
+    engine.nworkers    = 0;
+    engine.roundrobin  = _engine_roundrobin;
+    engine.snapshot    = _engine_snapshot;
+    engine.cryptopool  = _engine_cryptopool;
 
-    engine.roundrobin = _engine_roundrobin;
+    xcomm_async_tcp_startup(thrdcnt);
     
     for (int i = 0; i < thrdcnt; i++) {
         thrd_t tid;
@@ -147,6 +183,12 @@ static void _engine_startup(int concurrency) {
 }
 
 static void _engine_cleanup(void) {
+    xcomm_resolver_destroy(&engine.resolver);
+    if (atomic_load(&engine.crypto_ready)) {
+        xcomm_thrdpool_destroy(&engine.crypto);
+        atomic_store(&engine.crypto_ready, false);
+    }
+
     mtx_lock(&engine.mutex);
     xcomm_list_node_t* node = xcomm_list_head(&engine.workers);
     while (node != xcomm_list_sentinel(&engine.workers)) {
@@ -159,6 +201,8 @@ static void _engine_cleanup(void) {
 
     xcomm_wg_wait(&engine.waitgroup);
 
+    xcomm_async_tcp_cleanup();
+
     mtx_destroy(&engine.mutex);
     cnd_destroy(&engine.cond);
     platform_socket_cleanup();
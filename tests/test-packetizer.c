@@ -0,0 +1,310 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "modules/tcp/xcomm-tcp-packetizer.h"
+
+#define MAX_FRAMES 16
+
+typedef struct test_frames_s {
+    int    count;
+    int    stop_at;
+    size_t lens[MAX_FRAMES];
+    char   data[MAX_FRAMES][64];
+} test_frames_t;
+
+static bool _test_frame_cb(void* param, void* frame, size_t len) {
+    test_frames_t* frames = param;
+
+    assert(frames->count < MAX_FRAMES && len <= sizeof(frames->data[0]));
+    memcpy(frames->data[frames->count], frame, len);
+    frames->lens[frames->count++] = len;
+
+    return frames->count != frames->stop_at;
+}
+
+/** feeds buf in pieces of step bytes, resuming after a stop like a connection does. */
+static void _test_feed(
+    tcp_packetizer_t* packetizer, const char* buf, size_t len, size_t step, test_frames_t* frames) {
+    size_t off = 0;
+
+    while (off < len) {
+        size_t  size = len - off < step ? len - off : step;
+        ssize_t n    = xcomm_tcp_packetizer_feed(
+            packetizer, (char*)buf + off, size, _test_frame_cb, frames);
+        assert(n > 0 && (size_t)n <= size);
+        off += (size_t)n;
+    }
+}
+
+static void test_fixedlen(void) {
+    xcomm_tcp_packetizer_t conf = {
+        .type     = XCOMM_TCP_PACKETIZER_TYPE_FIXEDLEN,
+        .fixedlen = {.len = 4},
+    };
+    const char* stream = "aaaabbbbccccdd";
+
+    for (size_t step = 1; step <= strlen(stream); step++) {
+        tcp_packetizer_t packetizer;
+        test_frames_t    frames = {0};
+
+        assert(xcomm_tcp_packetizer_init(&packetizer, &conf) == 0);
+        _test_feed(&packetizer, stream, strlen(stream), step, &frames);
+
+        assert(frames.count == 3);
+        assert(frames.lens[0] == 4 && !memcmp(frames.data[0], "aaaa", 4));
+        assert(frames.lens[1] == 4 && !memcmp(frames.data[1], "bbbb", 4));
+        assert(frames.lens[2] == 4 && !memcmp(frames.data[2], "cccc", 4));
+
+        /** the trailing half frame completes on the next feed. */
+        _test_feed(&packetizer, "dd", 2, 2, &frames);
+        assert(frames.count == 4 && !memcmp(frames.data[3], "dddd", 4));
+
+        xcomm_tcp_packetizer_destroy(&packetizer);
+    }
+}
+
+static void test_delimiter(void) {
+    xcomm_tcp_packetizer_t conf = {
+        .type      = XCOMM_TCP_PACKETIZER_TYPE_DELIMITER,
+        .maxlen    = 16,
+        .delimiter = {.delimiter = "\r\n", .size = 2},
+    };
+    const char* stream = "hello\r\n\r\nworld\r\n";
+
+    for (size_t step = 1; step <= strlen(stream); step++) {
+        tcp_packetizer_t packetizer;
+        test_frames_t    frames = {0};
+
+        assert(xcomm_tcp_packetizer_init(&packetizer, &conf) == 0);
+        _test_feed(&packetizer, stream, strlen(stream), step, &frames);
+
+        assert(frames.count == 3);
+        assert(frames.lens[0] == 7 && !memcmp(frames.data[0], "hello\r\n", 7));
+        assert(frames.lens[1] == 2 && !memcmp(frames.data[1], "\r\n", 2));
+        assert(frames.lens[2] == 7 && !memcmp(frames.data[2], "world\r\n", 7));
+
+        xcomm_tcp_packetizer_destroy(&packetizer);
+    }
+}
+
+static void test_delimiter_too_long(void) {
+    xcomm_tcp_packetizer_t conf = {
+        .type      = XCOMM_TCP_PACKETIZER_TYPE_DELIMITER,
+        .maxlen    = 8,
+        .delimiter = {.delimiter = "\n", .size = 1},
+    };
+    tcp_packetizer_t packetizer;
+    test_frames_t    frames = {0};
+    char             stream[] = "0123456789\n";
+
+    assert(xcomm_tcp_packetizer_init(&packetizer, &conf) == 0);
+    assert(xcomm_tcp_packetizer_feed(
+               &packetizer, stream, 4, _test_frame_cb, &frames) == 4);
+    assert(xcomm_tcp_packetizer_feed(
+               &packetizer, stream + 4, 7, _test_frame_cb, &frames) == -1);
+    assert(frames.count == 0);
+
+    xcomm_tcp_packetizer_destroy(&packetizer);
+}
+
+static bool _test_count_cb(void* param, void* frame, size_t len) {
+    size_t* total = param;
+
+    assert(((char*)frame)[len - 1] == '\n');
+    *total += len;
+    return true;
+}
+
+/** a long pending frame grows the ring, which is released once it drains. */
+static void test_ring_grows(void) {
+    xcomm_tcp_packetizer_t conf = {
+        .type      = XCOMM_TCP_PACKETIZER_TYPE_DELIMITER,
+        .maxlen    = 8192,
+        .delimiter = {.delimiter = "\n", .size = 1},
+    };
+    tcp_packetizer_t packetizer;
+    static char      line[10000];
+    size_t           total = 0;
+
+    memset(line, 'x', sizeof(line));
+    line[2999] = '\n';
+
+    assert(xcomm_tcp_packetizer_init(&packetizer, &conf) == 0);
+    for (size_t off = 0; off < 2900; off += 100) {
+        assert(xcomm_tcp_packetizer_feed(
+                   &packetizer, line + off, 100, _test_count_cb, &total) == 100);
+    }
+    assert(packetizer.ring.buf && xcomm_ringbuf_cap(&packetizer.ring) == 4096);
+    assert(xcomm_tcp_packetizer_feed(
+               &packetizer, line + 2900, 100, _test_count_cb, &total) == 100);
+    assert(total == 3000 && !packetizer.ring.buf);
+
+    /** a short split frame only takes the smallest ring, and gives it back. */
+    assert(xcomm_tcp_packetizer_feed(
+               &packetizer, line, 10, _test_count_cb, &total) == 10);
+    assert(packetizer.ring.buf && xcomm_ringbuf_cap(&packetizer.ring) == 1024);
+    assert(xcomm_tcp_packetizer_feed(
+               &packetizer, line + 2990, 10, _test_count_cb, &total) == 10);
+    assert(total == 3020 && !packetizer.ring.buf);
+
+    /** past maxlen the feed fails. */
+    line[2999] = 'x';
+    ssize_t n = 0;
+    for (size_t off = 0; off < sizeof(line) && n >= 0; off += 1000) {
+        n = xcomm_tcp_packetizer_feed(
+            &packetizer, line + off, 1000, _test_count_cb, &total);
+    }
+    assert(n == -1);
+
+    xcomm_tcp_packetizer_destroy(&packetizer);
+}
+
+static void test_lengthfield(void) {
+    xcomm_tcp_packetizer_t conf = {
+        .type        = XCOMM_TCP_PACKETIZER_TYPE_LENGTHFIELD,
+        .lengthfield = {
+            .offset = 1,
+            .size   = 2,
+            .endian = XCOMM_TCP_PACKETIZER_ENDIAN_BIG,
+        },
+    };
+    /** type byte, big endian 16 bit body length, body. */
+    const char stream[] = "\x01\x00\x03" "abc" "\x02\x00\x00" "\x03\x00\x05" "hello";
+    size_t     len      = sizeof(stream) - 1;
+
+    for (size_t step = 1; step <= len; step++) {
+        tcp_packetizer_t packetizer;
+        test_frames_t    frames = {0};
+
+        assert(xcomm_tcp_packetizer_init(&packetizer, &conf) == 0);
+        _test_feed(&packetizer, stream, len, step, &frames);
+
+        assert(frames.count == 3);
+        assert(frames.lens[0] == 6 && !memcmp(frames.data[0], stream, 6));
+        assert(frames.lens[1] == 3 && !memcmp(frames.data[1], stream + 6, 3));
+        assert(frames.lens[2] == 8 && !memcmp(frames.data[2], stream + 9, 8));
+
+        xcomm_tcp_packetizer_destroy(&packetizer);
+    }
+}
+
+static void test_lengthfield_little_adjusted(void) {
+    xcomm_tcp_packetizer_t conf = {
+        .type        = XCOMM_TCP_PACKETIZER_TYPE_LENGTHFIELD,
+        .lengthfield = {
+            .offset     = 0,
+            .size       = 4,
+            .endian     = XCOMM_TCP_PACKETIZER_ENDIAN_LITTLE,
+            .adjustment = -4,
+        },
+    };
+    /** the length counts itself. */
+    const char stream[] = "\x06\x00\x00\x00" "xy" "\x04\x00\x00\x00";
+    size_t     len      = sizeof(stream) - 1;
+
+    for (size_t step = 1; step <= len; step++) {
+        tcp_packetizer_t packetizer;
+        test_frames_t    frames = {0};
+
+        assert(xcomm_tcp_packetizer_init(&packetizer, &conf) == 0);
+        _test_feed(&packetizer, stream, len, step, &frames);
+
+        assert(frames.count == 2);
+        assert(frames.lens[0] == 6 && !memcmp(frames.data[0], stream, 6));
+        assert(frames.lens[1] == 4);
+
+        xcomm_tcp_packetizer_destroy(&packetizer);
+    }
+}
+
+static void test_lengthfield_oversized(void) {
+    xcomm_tcp_packetizer_t conf = {
+        .type        = XCOMM_TCP_PACKETIZER_TYPE_LENGTHFIELD,
+        .maxlen      = 32,
+        .lengthfield = {.size = 1},
+    };
+    tcp_packetizer_t packetizer;
+    test_frames_t    frames = {0};
+    char             stream[] = "\x40";
+
+    assert(xcomm_tcp_packetizer_init(&packetizer, &conf) == 0);
+    assert(xcomm_tcp_packetizer_feed(
+               &packetizer, stream, 1, _test_frame_cb, &frames) == -1);
+
+    xcomm_tcp_packetizer_destroy(&packetizer);
+}
+
+static void test_stop(void) {
+    xcomm_tcp_packetizer_t conf = {
+        .type     = XCOMM_TCP_PACKETIZER_TYPE_FIXEDLEN,
+        .fixedlen = {.len = 2},
+    };
+    tcp_packetizer_t packetizer;
+    test_frames_t    frames = {.stop_at = 2};
+    char             stream[] = "aabbcc";
+
+    assert(xcomm_tcp_packetizer_init(&packetizer, &conf) == 0);
+    /** the frame that asked to stop is consumed, the rest is left. */
+    assert(xcomm_tcp_packetizer_feed(
+               &packetizer, stream, 6, _test_frame_cb, &frames) == 4);
+    assert(frames.count == 2);
+
+    /** a stop while completing a retained frame counts only the new bytes. */
+    frames.count   = 0;
+    frames.stop_at = 1;
+    assert(xcomm_tcp_packetizer_feed(
+               &packetizer, stream, 1, _test_frame_cb, &frames) == 1);
+    assert(xcomm_tcp_packetizer_feed(
+               &packetizer, stream + 1, 5, _test_frame_cb, &frames) == 1);
+    assert(frames.count == 1 && !memcmp(frames.data[0], "aa", 2));
+
+    xcomm_tcp_packetizer_destroy(&packetizer);
+}
+
+static void test_invalid_conf(void) {
+    tcp_packetizer_t       packetizer;
+    xcomm_tcp_packetizer_t fixedlen    = {.type = XCOMM_TCP_PACKETIZER_TYPE_FIXEDLEN};
+    xcomm_tcp_packetizer_t delimiter   = {.type = XCOMM_TCP_PACKETIZER_TYPE_DELIMITER};
+    xcomm_tcp_packetizer_t lengthfield = {
+        .type        = XCOMM_TCP_PACKETIZER_TYPE_LENGTHFIELD,
+        .lengthfield = {.size = 9},
+    };
+
+    assert(xcomm_tcp_packetizer_init(&packetizer, &fixedlen) == -1);
+    assert(xcomm_tcp_packetizer_init(&packetizer, &delimiter) == -1);
+    assert(xcomm_tcp_packetizer_init(&packetizer, &lengthfield) == -1);
+}
+
+int main(void) {
+    test_fixedlen();
+    test_delimiter();
+    test_delimiter_too_long();
+    test_ring_grows();
+    test_lengthfield();
+    test_lengthfield_little_adjusted();
+    test_lengthfield_oversized();
+    test_stop();
+    test_invalid_conf();
+    return 0;
+}
@@ -0,0 +1,178 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+
+#include "xcomm-resolver.h"
+#include "platform/platform-socket.h"
+
+typedef struct test_ctx_s {
+    xcomm_event_loop_t loop;
+    int                pending;
+    int                ok;
+    int                failed;
+} test_ctx_t;
+
+static void _test_resolved(int err, xcomm_resolver_addrs_t* addrs, void* userdata) {
+    test_ctx_t* ctx = userdata;
+
+    if (!err && addrs->naddrs > 0) {
+        ctx->ok++;
+    } else {
+        ctx->failed++;
+    }
+    if (--ctx->pending == 0) {
+        xcomm_event_loop_stop(&ctx->loop);
+    }
+}
+
+/** a fresh loop per round, a stopped loop cannot be run again. */
+static void _test_resolve(
+    test_ctx_t* ctx, xcomm_resolver_t* resolver, const char* host, const char* port, int n) {
+    xcomm_event_loop_init(&ctx->loop);
+
+    for (int i = 0; i < n; i++) {
+        ctx->pending++;
+        assert(xcomm_resolver_resolve(resolver, &ctx->loop, host, port, SOCK_STREAM, _test_resolved, ctx) == 0);
+    }
+}
+
+static void _test_run(test_ctx_t* ctx) {
+    xcomm_event_loop_run(&ctx->loop);
+    xcomm_event_loop_destroy(&ctx->loop);
+    assert(ctx->pending == 0);
+}
+
+static void test_coalesce(void) {
+    xcomm_resolver_t resolver;
+    test_ctx_t       ctx = {.pending = 0, .ok = 0, .failed = 0};
+
+    xcomm_resolver_init(&resolver, 2, XCOMM_RESOLVER_TTL);
+
+    _test_resolve(&ctx, &resolver, "127.0.0.1", "80", 8);
+    _test_run(&ctx);
+    assert(ctx.ok == 8);
+    assert(resolver.nlookups == 1);
+
+    _test_resolve(&ctx, &resolver, "127.0.0.1", "80", 1);
+    _test_run(&ctx);
+    assert(ctx.ok == 9);
+    assert(resolver.nlookups == 1);
+
+    _test_resolve(&ctx, &resolver, "127.0.0.1", "81", 1);
+    _test_run(&ctx);
+    assert(ctx.ok == 10);
+    assert(resolver.nlookups == 2);
+
+    xcomm_resolver_destroy(&resolver);
+}
+
+static void test_expire(void) {
+    xcomm_resolver_t resolver;
+    test_ctx_t       ctx = {.pending = 0, .ok = 0, .failed = 0};
+
+    xcomm_resolver_init(&resolver, 1, 50);
+
+    _test_resolve(&ctx, &resolver, "127.0.0.1", "80", 1);
+    _test_run(&ctx);
+    assert(resolver.nlookups == 1);
+
+    struct timespec ts = {.tv_sec = 0, .tv_nsec = 100 * 1000000};
+    thrd_sleep(&ts, NULL);
+
+    _test_resolve(&ctx, &resolver, "127.0.0.1", "80", 1);
+    _test_run(&ctx);
+    assert(resolver.nlookups == 2);
+    assert(ctx.ok == 2);
+
+    xcomm_resolver_destroy(&resolver);
+}
+
+static void _test_resolve_ports(
+    test_ctx_t* ctx, xcomm_resolver_t* resolver, int first, int n) {
+    char port[16];
+
+    xcomm_event_loop_init(&ctx->loop);
+    for (int i = first; i < first + n; i++) {
+        snprintf(port, sizeof(port), "%d", i);
+        ctx->pending++;
+        assert(xcomm_resolver_resolve(resolver, &ctx->loop, "127.0.0.1", port, SOCK_STREAM, _test_resolved, ctx) == 0);
+    }
+    _test_run(ctx);
+}
+
+/** a full cache drops the least recently used answers, live or not. */
+static void test_evict(void) {
+    xcomm_resolver_t resolver;
+    test_ctx_t       ctx = {.pending = 0, .ok = 0, .failed = 0};
+
+    xcomm_resolver_init(&resolver, 2, XCOMM_RESOLVER_TTL);
+
+    _test_resolve_ports(&ctx, &resolver, 10000, XCOMM_RESOLVER_MAXENTRIES);
+    assert(resolver.nentries == XCOMM_RESOLVER_MAXENTRIES);
+
+    /** touching the oldest answer keeps it. */
+    _test_resolve_ports(&ctx, &resolver, 10000, 1);
+    assert(resolver.nlookups == XCOMM_RESOLVER_MAXENTRIES);
+
+    _test_resolve_ports(&ctx, &resolver, 20000, 2);
+    assert(resolver.nentries == XCOMM_RESOLVER_MAXENTRIES);
+
+    _test_resolve_ports(&ctx, &resolver, 10000, 1);
+    assert(resolver.nlookups == XCOMM_RESOLVER_MAXENTRIES + 2);
+    _test_resolve_ports(&ctx, &resolver, 10001, 1);
+    assert(resolver.nlookups == XCOMM_RESOLVER_MAXENTRIES + 3);
+    assert(ctx.ok == XCOMM_RESOLVER_MAXENTRIES + 5);
+
+    xcomm_resolver_destroy(&resolver);
+}
+
+/** lookups cut short by destroy still report back, with an error. */
+static void test_destroy(void) {
+    xcomm_resolver_t resolver;
+    test_ctx_t       ctx = {.pending = 0, .ok = 0, .failed = 0};
+    char             port[8];
+
+    xcomm_resolver_init(&resolver, 1, XCOMM_RESOLVER_TTL);
+
+    xcomm_event_loop_init(&ctx.loop);
+    for (int i = 0; i < 16; i++) {
+        snprintf(port, sizeof(port), "%d", 1000 + i);
+        ctx.pending++;
+        assert(xcomm_resolver_resolve(&resolver, &ctx.loop, "127.0.0.1", port, SOCK_STREAM, _test_resolved, &ctx) == 0);
+    }
+    xcomm_resolver_destroy(&resolver);
+
+    _test_run(&ctx);
+    assert(ctx.ok + ctx.failed == 16);
+    assert(ctx.ok == (int)resolver.nlookups);
+}
+
+int main(void) {
+    platform_socket_startup();
+    test_coalesce();
+    test_expire();
+    test_evict();
+    test_destroy();
+    platform_socket_cleanup();
+    return 0;
+}
@@ -0,0 +1,156 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "xcomm/xcomm-shm-module.h"
+#include "deprecated/c11-threads.h"
+
+#define TEST_CAPACITY 4096
+#define TEST_MESSAGES 20000
+#define TEST_MAXLEN   3000
+
+typedef struct test_peer_s {
+    xcomm_shm_listener_t* listener;
+    int                   received;
+} test_peer_t;
+
+static char name[64];
+
+/** sizes walk across the ring so frames keep wrapping around its end. */
+static size_t _test_len(int i) {
+    return (size_t)(i * 37) % TEST_MAXLEN;
+}
+
+static void _test_fill(char* buf, int i, size_t len) {
+    for (size_t j = 0; j < len; j++) {
+        buf[j] = (char)(i + j);
+    }
+}
+
+static int _test_consume(void* param) {
+    test_peer_t*            peer = param;
+    xcomm_shm_connection_t* conn = xcomm_shm.accept(peer->listener, 1000);
+    char                    expect[TEST_MAXLEN];
+    char                    buf[TEST_MAXLEN];
+
+    assert(conn);
+    for (int i = 0; i < TEST_MESSAGES; i++) {
+        size_t len = _test_len(i);
+
+        assert(xcomm_shm.recv(conn, buf, sizeof(buf)) == (int64_t)len);
+        _test_fill(expect, i, len);
+        assert(!memcmp(buf, expect, len));
+        peer->received++;
+    }
+    /** the peer closed and the ring is drained. */
+    assert(xcomm_shm.recv(conn, buf, sizeof(buf)) == 0);
+    xcomm_shm.close_connection(conn);
+    return 0;
+}
+
+static void test_stream(void) {
+    test_peer_t peer = {.received = 0};
+    char        buf[TEST_MAXLEN];
+    thrd_t      tid;
+
+    peer.listener = xcomm_shm.listen(name, TEST_CAPACITY);
+    assert(peer.listener);
+    thrd_create(&tid, _test_consume, &peer);
+
+    xcomm_shm_connection_t* conn = xcomm_shm.dial(name, 1000);
+    assert(conn);
+    for (int i = 0; i < TEST_MESSAGES; i++) {
+        size_t len = _test_len(i);
+
+        _test_fill(buf, i, len);
+        assert(!xcomm_shm.send(conn, buf, len));
+    }
+    /** a frame never fits a ring of its own size. */
+    assert(xcomm_shm.send(conn, buf, TEST_CAPACITY) == -1);
+    xcomm_shm.close_connection(conn);
+
+    thrd_join(tid, NULL);
+    assert(peer.received == TEST_MESSAGES);
+    xcomm_shm.close_listener(peer.listener);
+}
+
+/** a short buffer learns the size and the message stays for the next call. */
+static void test_short_buffer(void) {
+    xcomm_shm_listener_t* listener = xcomm_shm.listen(name, TEST_CAPACITY);
+    char                  buf[100];
+
+    assert(listener);
+    xcomm_shm_connection_t* conn = xcomm_shm.dial(name, 1000);
+    assert(conn);
+    xcomm_shm_connection_t* peer = xcomm_shm.accept(listener, 1000);
+    assert(peer);
+
+    _test_fill(buf, 7, sizeof(buf));
+    assert(!xcomm_shm.send(conn, buf, sizeof(buf)));
+    assert(!xcomm_shm.send(conn, buf, 1));
+
+    char small[10];
+    assert(xcomm_shm.recv(peer, small, sizeof(small)) == sizeof(buf));
+    memset(buf, 0, sizeof(buf));
+    assert(xcomm_shm.recv(peer, buf, sizeof(buf)) == sizeof(buf));
+    _test_fill(small, 7, sizeof(small));
+    assert(!memcmp(buf, small, sizeof(small)));
+    assert(xcomm_shm.recv(peer, small, sizeof(small)) == 1);
+
+    xcomm_shm.close_connection(conn);
+    xcomm_shm.close_connection(peer);
+    xcomm_shm.close_listener(listener);
+}
+
+/** a second listener must not take the name away from a live one. */
+static void test_exclusive(void) {
+    xcomm_shm_listener_t* listener = xcomm_shm.listen(name, TEST_CAPACITY);
+
+    assert(listener);
+    assert(!xcomm_shm.listen(name, TEST_CAPACITY));
+
+    xcomm_shm_connection_t* conn = xcomm_shm.dial(name, 1000);
+    assert(conn);
+    xcomm_shm_connection_t* peer = xcomm_shm.accept(listener, 1000);
+    assert(peer);
+    assert(!xcomm_shm.listen(name, TEST_CAPACITY));
+
+    xcomm_shm.close_connection(conn);
+    xcomm_shm.close_connection(peer);
+    xcomm_shm.close_listener(listener);
+
+    /** closing released the name. */
+    listener = xcomm_shm.listen(name, TEST_CAPACITY);
+    assert(listener);
+    xcomm_shm.close_listener(listener);
+}
+
+int main(void) {
+    snprintf(name, sizeof(name), "/xcomm-test-shm-%ld", (long)time(NULL));
+
+    test_stream();
+    test_short_buffer();
+    test_exclusive();
+    return 0;
+}
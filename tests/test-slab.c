@@ -0,0 +1,148 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include "xcomm-slab.h"
+#include "deprecated/c11-threads.h"
+
+typedef struct test_obj_s {
+    int  id;
+    char payload[100];
+} test_obj_t;
+
+static void test_init_destroy(void) {
+    xcomm_slab_t slab;
+    xcomm_slab_init(&slab, sizeof(test_obj_t), 8);
+
+    assert(slab.objsize % XCOMM_SLAB_CACHELINE == 0);
+    assert(slab.objsize >= sizeof(test_obj_t));
+    assert(slab.ntotal == 0);
+
+    xcomm_slab_destroy(&slab);
+}
+
+static void test_alloc_aligned(void) {
+    xcomm_slab_t slab;
+    xcomm_slab_init(&slab, sizeof(test_obj_t), 4);
+
+    test_obj_t* objs[10];
+    for (int i = 0; i < 10; i++) {
+        objs[i] = xcomm_slab_alloc(&slab);
+        assert(objs[i]);
+        assert(((uintptr_t)objs[i] % XCOMM_SLAB_CACHELINE) == 0);
+        memset(objs[i], i, sizeof(test_obj_t));
+    }
+    assert(slab.ntotal == 12);
+    assert(slab.nfree == 2);
+
+    for (int i = 0; i < 10; i++) {
+        assert(objs[i]->payload[99] == (char)i);
+        for (int j = i + 1; j < 10; j++) {
+            assert(objs[i] != objs[j]);
+        }
+    }
+    for (int i = 0; i < 10; i++) {
+        xcomm_slab_free(&slab, objs[i]);
+    }
+    assert(slab.nfree == 12);
+    xcomm_slab_destroy(&slab);
+}
+
+static void test_reuse(void) {
+    xcomm_slab_t slab;
+    xcomm_slab_init(&slab, sizeof(test_obj_t), 4);
+
+    void* a = xcomm_slab_alloc(&slab);
+    xcomm_slab_free(&slab, a);
+    void* b = xcomm_slab_alloc(&slab);
+    assert(a == b);
+
+    xcomm_slab_free(&slab, b);
+    xcomm_slab_free(&slab, NULL);
+    assert(slab.nfree == 4);
+
+    xcomm_slab_destroy(&slab);
+}
+
+static void test_reserve(void) {
+    xcomm_slab_t slab;
+    xcomm_slab_init(&slab, 1, 16);
+
+    assert(slab.objsize == XCOMM_SLAB_CACHELINE);
+    assert(xcomm_slab_reserve(&slab, 40) == 0);
+    assert(slab.ntotal == 48);
+    assert(slab.nfree == 48);
+
+    /** already warm, nothing to grow. */
+    assert(xcomm_slab_reserve(&slab, 10) == 0);
+    assert(slab.ntotal == 48);
+
+    for (int i = 0; i < 48; i++) {
+        assert(xcomm_slab_alloc(&slab));
+    }
+    assert(slab.ntotal == 48);
+    assert(slab.nfree == 0);
+
+    xcomm_slab_destroy(&slab);
+}
+
+static int worker_churn(void* arg) {
+    xcomm_slab_t* slab = arg;
+
+    for (int i = 0; i < 10000; i++) {
+        test_obj_t* obj = xcomm_slab_alloc(slab);
+        assert(obj);
+        obj->id = i;
+        assert(obj->id == i);
+        xcomm_slab_free(slab, obj);
+    }
+    return 0;
+}
+
+static void test_multiple_threads(void) {
+    xcomm_slab_t slab;
+    xcomm_slab_init(&slab, sizeof(test_obj_t), 8);
+
+    thrd_t threads[4];
+    for (int i = 0; i < 4; i++) {
+        thrd_create(&threads[i], worker_churn, &slab);
+    }
+    for (int i = 0; i < 4; i++) {
+        thrd_join(threads[i], NULL);
+    }
+    assert(slab.nfree == slab.ntotal);
+    assert(slab.ntotal <= 8 * 4);
+
+    xcomm_slab_destroy(&slab);
+}
+
+int main(void) {
+    test_init_destroy();
+    test_alloc_aligned();
+    test_reuse();
+    test_reserve();
+    test_multiple_threads();
+    return 0;
+}
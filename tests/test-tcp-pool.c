@@ -0,0 +1,185 @@
+/** Copyright (c) 2025, Wu Jin <wujin.developer@gmail.com>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include <assert.h>
+#include <stdatomic.h>
+
+#include "xcomm/xcomm-tcp-module.h"
+#include "platform/platform-socket.h"
+#include "deprecated/c11-threads.h"
+
+#define TEST_HOST     "127.0.0.1"
+#define TEST_PORT     "19380"
+#define TEST_MAXCONNS 16
+
+typedef struct test_server_s {
+    xcomm_tcp_listener_t*   listener;
+    xcomm_tcp_connection_t* conns[TEST_MAXCONNS];
+    int                     nconns;
+    atomic_bool             stop;
+} test_server_t;
+
+typedef struct test_waiter_s {
+    xcomm_tcp_pool_t*       pool;
+    xcomm_tcp_connection_t* conn;
+    atomic_bool             done;
+} test_waiter_t;
+
+/** keeps the server ends open so pooled connections stay idle and healthy. */
+static int _test_serve(void* param) {
+    test_server_t* server = param;
+
+    while (!atomic_load(&server->stop) && server->nconns < TEST_MAXCONNS) {
+        xcomm_tcp_connection_t* conn = xcomm_sync_tcp.accept(server->listener);
+        if (conn) {
+            server->conns[server->nconns++] = conn;
+        }
+    }
+    return 0;
+}
+
+static int _test_checkout(void* param) {
+    test_waiter_t* waiter = param;
+
+    waiter->conn = xcomm_sync_tcp.checkout(waiter->pool, TEST_HOST, TEST_PORT);
+    atomic_store(&waiter->done, true);
+    return 0;
+}
+
+static void _test_sleep(int ms) {
+    struct timespec ts = {.tv_sec = 0, .tv_nsec = ms * 1000000L};
+    thrd_sleep(&ts, NULL);
+}
+
+static xcomm_tcp_pool_t* _test_pool(int max_active, int connect_timeout_ms) {
+    xcomm_tcp_pool_config_t config = {
+        .max_idle           = 4,
+        .max_active         = max_active,
+        .idle_timeout_ms    = 0,
+        .connect_timeout_ms = connect_timeout_ms,
+    };
+    return xcomm_sync_tcp.create_pool(&config);
+}
+
+static void test_lifo(void) {
+    xcomm_tcp_pool_t* pool = _test_pool(0, 1000);
+
+    xcomm_tcp_connection_t* a = xcomm_sync_tcp.checkout(pool, TEST_HOST, TEST_PORT);
+    xcomm_tcp_connection_t* b = xcomm_sync_tcp.checkout(pool, TEST_HOST, TEST_PORT);
+    assert(a && b && a != b);
+
+    xcomm_sync_tcp.checkin(a);
+    xcomm_sync_tcp.checkin(b);
+
+    /** the most recently returned connection comes back first. */
+    assert(xcomm_sync_tcp.checkout(pool, TEST_HOST, TEST_PORT) == b);
+    assert(xcomm_sync_tcp.checkout(pool, TEST_HOST, TEST_PORT) == a);
+
+    xcomm_sync_tcp.checkin(a);
+    xcomm_sync_tcp.checkin(b);
+    xcomm_sync_tcp.destroy_pool(pool);
+}
+
+static void test_max_active(void) {
+    xcomm_tcp_pool_t* pool = _test_pool(1, 0);
+    test_waiter_t     waiter = {.pool = pool, .conn = NULL};
+    thrd_t            tid;
+
+    atomic_init(&waiter.done, false);
+
+    xcomm_tcp_connection_t* a = xcomm_sync_tcp.checkout(pool, TEST_HOST, TEST_PORT);
+    assert(a);
+
+    thrd_create(&tid, _test_checkout, &waiter);
+    _test_sleep(100);
+    assert(!atomic_load(&waiter.done));
+
+    /** the blocked checkout gets the returned connection. */
+    xcomm_sync_tcp.checkin(a);
+    thrd_join(tid, NULL);
+    assert(waiter.conn == a);
+
+    xcomm_sync_tcp.checkin(a);
+    xcomm_sync_tcp.destroy_pool(pool);
+}
+
+static void test_timeout(void) {
+    xcomm_tcp_pool_t* pool = _test_pool(1, 100);
+
+    xcomm_tcp_connection_t* a = xcomm_sync_tcp.checkout(pool, TEST_HOST, TEST_PORT);
+    assert(a);
+    assert(!xcomm_sync_tcp.checkout(pool, TEST_HOST, TEST_PORT));
+
+    xcomm_sync_tcp.checkin(a);
+    xcomm_sync_tcp.destroy_pool(pool);
+}
+
+/** destroy wakes a checkout blocked without a deadline. */
+static void test_destroy(void) {
+    xcomm_tcp_pool_t* pool = _test_pool(1, 0);
+    test_waiter_t     waiter = {.pool = pool, .conn = NULL};
+    thrd_t            tid;
+
+    atomic_init(&waiter.done, false);
+
+    xcomm_tcp_connection_t* a = xcomm_sync_tcp.checkout(pool, TEST_HOST, TEST_PORT);
+    assert(a);
+
+    thrd_create(&tid, _test_checkout, &waiter);
+    _test_sleep(100);
+    assert(!atomic_load(&waiter.done));
+
+    xcomm_sync_tcp.destroy_pool(pool);
+    thrd_join(tid, NULL);
+    assert(!waiter.conn);
+
+    /** the last reference goes with the checked out connection. */
+    xcomm_sync_tcp.checkin(a);
+}
+
+int main(void) {
+    test_server_t server = {.nconns = 0};
+    thrd_t        tid;
+
+    platform_socket_startup();
+    atomic_init(&server.stop, false);
+
+    server.listener = xcomm_sync_tcp.listen(TEST_HOST, TEST_PORT);
+    assert(server.listener);
+    thrd_create(&tid, _test_serve, &server);
+
+    test_lifo();
+    test_max_active();
+    test_timeout();
+    test_destroy();
+
+    /** one more dial wakes the accept loop. */
+    atomic_store(&server.stop, true);
+    xcomm_sync_tcp.close_connection(xcomm_sync_tcp.dial(TEST_HOST, TEST_PORT, 1000));
+    thrd_join(tid, NULL);
+
+    for (int i = 0; i < server.nconns; i++) {
+        xcomm_sync_tcp.close_connection(server.conns[i]);
+    }
+    xcomm_sync_tcp.close_listener(server.listener);
+    platform_socket_cleanup();
+    return 0;
+}